@@ -3,17 +3,42 @@
 #include "config.hpp"
 #include "array.hpp"
 
-struct Value;
-
+// Chaves de MapInstance. Números iguais são a mesma chave (1, 1.0 e 1u
+// caem no mesmo slot); strings comparam conteúdo; objetos comparam identidade.
+// O caso int fica inline: é o que os lookups por id/índice usam.
 struct ValueHasher
 {
-    size_t operator()(const Value &v) const;
-  
+    static FORCE_INLINE size_t mixInt(uint32 h)
+    {
+        // MurmurHash3 finalizer (mix bits)
+        h ^= h >> 16;
+        h *= 0x85ebca6b;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35;
+        h ^= h >> 16;
+        return h;
+    }
+
+    FORCE_INLINE size_t operator()(const Value &v) const
+    {
+        if (LIKELY(v.isInt()))
+            return mixInt((uint32)v.rawInt());
+        return hashSlow(v);
+    }
+
+    static size_t hashSlow(const Value &v);
 };
+
 struct ValueEq
 {
-    bool operator()(const Value& a, const Value& b) const;
-    
+    FORCE_INLINE bool operator()(const Value &a, const Value &b) const
+    {
+        if (a.isInt() && b.isInt())
+            return a.rawInt() == b.rawInt();
+        return equalSlow(a, b);
+    }
+
+    static bool equalSlow(const Value &a, const Value &b);
 };
 
 class Code
@@ -105,9 +105,9 @@ struct LoopContext
   int breakJumps[MAX_BREAKS_PER_LOOP];
   int breakCount;
   int scopeDepth;
-  bool isForeach;
+  int hiddenSlots; // foreach: locals escondidos (seq/iter, range) que o break tira
 
-  LoopContext() : loopStart(0), breakCount(0), scopeDepth(0), isForeach(false) {}
+  LoopContext() : loopStart(0), breakCount(0), scopeDepth(0), hiddenSlots(0) {}
 
   bool addBreak(int jump)
   {
@@ -173,6 +173,18 @@ public:
   
   const std::vector<std::string>& getGlobalIndexToName() const { return globalIndexToName_; }
 
+  // Dependências da última compilação (validação do bytecode cache)
+  struct IncludeDep
+  {
+    std::string name;
+    uint64 hash;
+  };
+  const std::vector<IncludeDep>& getIncludes() const { return includes_; }
+  const std::vector<std::string>& getRequiredPlugins() const { return requiredPlugins_; }
+
+  // Tamanho da instrução em bytes (0 = opcode desconhecido), compiler_peephole.cpp
+  static int instructionLength(const Code *chunk, size_t offset, const Vector<Function *> &functions);
+
   void clear();
 
   // Estatísticas para debugging
@@ -245,6 +257,8 @@ private:
 
   std::vector<std::string> errors;
   std::vector<std::string> warnings;
+
+  int stringLiteralEnd_ = -1; // offset logo a seguir ao último literal string (addChain)
   std::set<std::string> declaredGlobals_;  // Track declared global variable names
 
   // Global variable indexing for optimization
@@ -264,7 +278,7 @@ private:
   bool match(TokenType type);
   void consume(TokenType type, const char *message);
 
-  void beginLoop(int loopStart, bool isForeach = false);
+  void beginLoop(int loopStart, int hiddenSlots = 0);
   void endLoop();
   void emitBreak();
   void pushScope();
@@ -296,6 +310,7 @@ private:
   void emitByte(uint8 byte);
   void emitBytes(uint8 byte1, uint8 byte2);
   void emitShort(uint16 value);
+  void emitCacheSlot();
   void emitDiscard(uint8 count);
   void emitReturn();
   void emitConstant(Value value);
@@ -328,6 +343,7 @@ private:
 
   // Parse functions (infix)
   void binary(bool canAssign);
+  void addChain();
   void and_(bool canAssign);
   void or_(bool canAssign);
   void call(bool canAssign);
@@ -347,6 +363,7 @@ private:
   void switchStatement();
   void forStatement();
   void foreachStatement();
+  void foreachRange(Token &itemName);
   void returnStatement();
   void block();
   void yieldStatement();
@@ -367,6 +384,9 @@ private:
   void emitGosubTo(int targetOffset);
   void patchJumpTo(int operandOffset, int targetOffset);
 
+  // Peephole/superinstruções (compiler_peephole.cpp)
+  void optimizeChunk(Function *func);
+
   void emitVarOp(uint8 op, int arg);
   void handle_assignment(uint8 getOp, uint8 setOp, int arg, bool canAssign);
 
@@ -417,6 +437,8 @@ private:
   FileLoaderCallback fileLoader = nullptr;
   void *fileLoaderUserdata = nullptr;
   std::set<std::string> includedFiles;
+  std::vector<IncludeDep> includes_;
+  std::vector<std::string> requiredPlugins_;
   std::set<std::string> importedModules;
   std::set<std::string> usingModules;
 
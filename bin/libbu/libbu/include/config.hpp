@@ -36,7 +36,18 @@
 #undef USE_COMPUTED_GOTO
 //#define USE_COMPUTED_GOTO 1
 
+// Value de 8 bytes com NaN-boxing (por omissão: tag + union, 16 bytes)
+//#define USE_NAN_BOXING 1
+
+// Peephole no fim de cada função: dobra constantes e gera superinstruções
+#define USE_PEEPHOLE 1
+
+// Quickening: aritmética/comparações especializam-se no sítio (OP_ADD -> OP_ADD_II)
+#define USE_QUICKENING 1
+
 #define BU_ENABLE_SOCKETS 1
+// Grelha espacial sobre x/y/z dos processos (get_near, collision)
+#define BU_ENABLE_SPATIAL 1
 #define BU_ENABLE_FILE_IO 1
 #define BU_ENABLE_MATH 1
 #define BU_ENABLE_TIME 1
@@ -50,6 +61,7 @@ typedef signed int int32;
 typedef unsigned char uint8;
 typedef unsigned short uint16;
 typedef unsigned int uint32;
+typedef unsigned long long uint64;
 typedef float float32;
 typedef double float64;
 
@@ -148,4 +160,60 @@ static inline void *aRealloc(void *buffer, size_t size)
 static inline void aFree(void *mem)
 {
     std::free(mem);
-}
\ No newline at end of file
+}
+
+// Alocadores dos contentores (Vector, HashMap). Arrays e maps usam o
+// TrackedAlloc: o backing store conta em gcPayloadBytes[Kind] do VM e entra no
+// ritmo do GC (nextGC) como o resto do heap. Structs, classes e closures
+// têm os valores inline e contam a parte inline diretamente.
+struct PlainAlloc
+{
+    static void *allocate(size_t bytes) { return aAlloc(bytes); }
+    static void release(void *mem, size_t) { aFree(mem); }
+};
+
+enum GCPayloadKind
+{
+    GC_PAYLOAD_ARRAY,
+    GC_PAYLOAD_MAP,
+    GC_PAYLOAD_STRUCT,
+    GC_PAYLOAD_CLASS,
+    GC_PAYLOAD_CLOSURE,
+    GC_PAYLOAD_COUNT
+};
+
+// Contadores do VM que está a correr (cada Interpreter tem os seus).
+// Cada bloco guarda no cabeçalho os contadores onde foi contado, para a
+// libertação descontar no mesmo VM mesmo que entretanto corra outro.
+extern thread_local size_t *gcPayloadCounters; // gc.cpp
+extern size_t gcPayloadDetached[GC_PAYLOAD_COUNT];
+
+struct GCPayloadScope
+{
+    size_t *previous;
+    explicit GCPayloadScope(size_t *counters) : previous(gcPayloadCounters) { gcPayloadCounters = counters; }
+    ~GCPayloadScope() { gcPayloadCounters = previous; }
+};
+
+template <int Kind>
+struct TrackedAlloc
+{
+    static const size_t HEADER = alignof(std::max_align_t);
+
+    static void *allocate(size_t bytes)
+    {
+        char *mem = (char *)aAlloc(bytes + HEADER);
+        if (!mem)
+            return nullptr;
+        size_t *counters = gcPayloadCounters;
+        counters[Kind] += bytes;
+        *(size_t **)mem = counters;
+        return mem + HEADER;
+    }
+    static void release(void *mem, size_t bytes)
+    {
+        char *base = (char *)mem - HEADER;
+        (*(size_t **)base)[Kind] -= bytes;
+        aFree(base);
+    }
+};
\ No newline at end of file
@@ -30,6 +30,12 @@ private:
         const Code &chunk,
         size_t offset);
 
+    // GET/SET_PROPERTY: nome + slot do inline cache
+    static size_t propertyInstruction(
+        const char *name,
+        const Code &chunk,
+        size_t offset);
+
     // Para globals com índice direto no array (OPTIMIZATION)
     static size_t globalIndexInstruction(
         const char *name,
@@ -6,6 +6,7 @@
 #include "list.hpp"
 #include "ordermap.hpp"
 #include "pool.hpp"
+#include "spatial.hpp"
 #include "string.hpp"
 #include "types.hpp"
 #include "vector.hpp"
@@ -138,6 +139,85 @@ enum class StaticNames : uint8 {
       NativeGetter getter;
       NativeSetter setter; // null = read-only
   };
+
+// ============================================
+// INLINE CACHES (OP_GET_PROPERTY / OP_SET_PROPERTY / OP_INVOKE)
+// ============================================
+// Cada call-site tem um slot em Function::caches. A chave é o "shape" do
+// receiver (ClassDef*, NativeClassDef* ou StructDef*), o valor é o resultado
+// já resolvido do lookup. Mono/polimórfico até IC_WAYS, depois deixa de cachear.
+
+#define IC_WAYS 4
+
+enum class ICKind : uint8
+{
+  FIELD,           // ClassInstance::fields[slot] / StructInstance::values[slot]
+  METHOD,          // Function* (já com a superclass resolvida)
+  NATIVE_METHOD,   // NativeMethod (native class ou híbrido)
+  NATIVE_PROPERTY, // NativeProperty (native class ou híbrido)
+};
+
+struct ICEntry
+{
+  const void *shape;
+  ICKind kind;
+  uint8 slot;
+  union
+  {
+    Function *method;
+    NativeMethod native;
+    NativeProperty property;
+  };
+};
+
+struct InlineCache
+{
+  uint8 count;
+  ICEntry entries[IC_WAYS];
+
+  FORCE_INLINE ICEntry *find(const void *shape)
+  {
+    for (int i = 0; i < count; i++)
+    {
+      if (entries[i].shape == shape)
+        return &entries[i];
+    }
+    return nullptr;
+  }
+
+  FORCE_INLINE ICEntry *add(const void *shape, ICKind kind)
+  {
+    if (count >= IC_WAYS) // megamorphic
+      return nullptr;
+    ICEntry *entry = &entries[count++];
+    entry->shape = shape;
+    entry->kind = kind;
+    entry->slot = 0;
+    return entry;
+  }
+
+  FORCE_INLINE void addField(const void *shape, uint8 slot)
+  {
+    if (ICEntry *e = add(shape, ICKind::FIELD))
+      e->slot = slot;
+  }
+  FORCE_INLINE void addMethod(const void *shape, Function *method)
+  {
+    if (ICEntry *e = add(shape, ICKind::METHOD))
+      e->method = method;
+  }
+  FORCE_INLINE void addNativeMethod(const void *shape, NativeMethod native)
+  {
+    if (ICEntry *e = add(shape, ICKind::NATIVE_METHOD))
+      e->native = native;
+  }
+  FORCE_INLINE void addNativeProperty(const void *shape, NativeProperty property)
+  {
+    if (ICEntry *e = add(shape, ICKind::NATIVE_PROPERTY))
+      e->property = property;
+  }
+};
+
 struct Function
 {
   int index;
@@ -146,6 +226,10 @@ struct Function
   String *name{nullptr};
   bool hasReturn{false};
   int upvalueCount{0};
+  InlineCache *caches{nullptr}; // um por call-site de property/invoke
+  int cacheCount{0};
+  int cacheCapacity{0};
+  uint16 addInlineCache();
   ~Function();
 };
 
@@ -200,6 +284,11 @@ struct NativeClassDef
   NativeDestructor destructor;
   bool persistent;  // Se true, instâncias não são coletadas pelo GC
 
+  // Classes valor (Vector3, Quaternion, ...): os dados vivem inline na
+  // instância, uma só alocação da arena e sem destructor
+  size_t valueSize = 0;
+  NativeStructCtor valueConstructor = nullptr; // nullable
+
   List<String *, NativeMethod> methods;
   List<String *, NativeProperty> properties;
 
@@ -295,6 +384,50 @@ enum class GCObjectType : uint8
   UPVALUE
 };
 
+// Fases do GC incremental (tri-color): IDLE -> MARK (cinzentos na grayStack)
+// -> atómico (re-scan das raízes) -> SWEEP (por fatias) -> IDLE
+enum class GCPhase : uint8
+{
+  IDLE,
+  MARK,
+  SWEEP
+};
+
+struct GCStats
+{
+  size_t cycles = 0;        // ciclos completos
+  size_t pauses = 0;        // steps + atómicos + runGC()
+  double lastPauseUs = 0.0;
+  double maxPauseUs = 0.0;
+  double totalPauseUs = 0.0;
+  size_t lastFreedBytes = 0;
+  size_t lastFreedObjects = 0;
+};
+
+// Heap por tipo: objeto = o que está na arena, payload = backing store
+// (Vector/HashMap dos arrays, maps, ...; dados dos buffers; userData inline)
+struct HeapTypeStats
+{
+  size_t count = 0;
+  size_t objectBytes = 0;
+  size_t payloadBytes = 0;
+};
+
+struct HeapStats
+{
+  HeapTypeStats arrays;
+  HeapTypeStats maps;
+  HeapTypeStats structs;
+  HeapTypeStats classes;
+  HeapTypeStats closures;
+  HeapTypeStats upvalues;
+  HeapTypeStats buffers;
+  HeapTypeStats nativeClasses;
+  HeapTypeStats nativeStructs;
+  HeapTypeStats strings;
+  size_t totalBytes = 0; // o que o GC vê (getTotalAlocated)
+};
+
 struct GCObject
 {
   GCObjectType type;
@@ -304,24 +437,30 @@ struct GCObject
   GCObject(GCObjectType t) : type(t), marked(0), next(nullptr) {}
 };
 
+// StructInstance, ClassInstance e Closure guardam os valores inline, logo a
+// seguir ao objeto: uma só alocação na arena e sem indireção por campo.
 struct StructInstance : GCObject
 {
   StructDef *def;
-  Vector<Value> values;
+  uint32 count{0}; // def->argCount
 
   StructInstance() : GCObject(GCObjectType::STRUCT) {}
+
+  FORCE_INLINE Value *values() { return reinterpret_cast<Value *>(this + 1); }
 };
 
 struct ClassInstance : GCObject
 {
   ClassDef *klass;
-  Vector<Value> fields;
   void *nativeUserData{nullptr};  // Dados nativos quando herda de NativeClass
+  uint32 fieldCount{0};           // klass->fieldCount na criação
 
   ClassInstance() : GCObject(GCObjectType::CLASS) {}
 
   ~ClassInstance() {}
 
+  FORCE_INLINE Value *fields() { return reinterpret_cast<Value *>(this + 1); }
+
   FORCE_INLINE bool getMethod(String *name, Function **out)
   {
     ClassDef *current = klass;
@@ -390,7 +529,7 @@ struct ClassInstance : GCObject
 
 struct ArrayInstance : GCObject
 {
-  Vector<Value> values;
+  Vector<Value, TrackedAlloc<GC_PAYLOAD_ARRAY>> values;
 
   ArrayInstance() : GCObject(GCObjectType::ARRAY) {}
 };
@@ -417,11 +556,17 @@ struct BufferInstance : GCObject
   uint8 *data;
   BufferInstance(int count, BufferType type);
   ~BufferInstance();
+
+  int byteSize() const { return count * elementSize; }
+  // Fatia em bytes dos args opcionais [offset, length] a partir de args[first]
+  bool slice(int argCount, Value *args, int first, int *offset, int *length) const;
 };
 
+// Chaves são Values (ver ValueHasher/ValueEq): ints, números, strings,
+// bools e objetos por identidade. nil não é chave.
 struct MapInstance : GCObject
 {
-  HashMap<String *, Value, StringHasher, StringEq> table;
+  HashMap<Value, Value, ValueHasher, ValueEq, TrackedAlloc<GC_PAYLOAD_MAP>> table;
 
   MapInstance() : GCObject(GCObjectType::MAP) {}
 };
@@ -431,8 +576,9 @@ struct NativeClassInstance : GCObject
   void *userData;
   bool persistent;      // Se true, não é coletado pelo GC
   bool ownsUserData;    // Se true, o destrutor é chamado ao libertar
+  uint32 inlineSize;    // userData inline logo a seguir à instância
 
-  NativeClassInstance() : GCObject(GCObjectType::NATIVE_CLASS), persistent(false), ownsUserData(true) {}
+  NativeClassInstance() : GCObject(GCObjectType::NATIVE_CLASS), persistent(false), ownsUserData(true), inlineSize(0) {}
 };
 
 struct NativeStructInstance : GCObject
@@ -456,13 +602,16 @@ struct Closure : GCObject
 {
   int functionId;
   int upvalueCount;
-  Vector<Upvalue *> upvalues;
 
   Closure();
 
-  ~Closure();
+  FORCE_INLINE Upvalue **upvalues() { return reinterpret_cast<Upvalue **>(this + 1); }
 };
 
+static_assert(sizeof(StructInstance) % alignof(Value) == 0, "valores inline desalinhados");
+static_assert(sizeof(ClassInstance) % alignof(Value) == 0, "fields inline desalinhados");
+static_assert(sizeof(Closure) % alignof(Upvalue *) == 0, "upvalues inline desalinhados");
+
 struct CallFrame
 {
   Function *func{nullptr};
@@ -486,7 +635,8 @@ struct FiberResult
     FIBER_YIELD,   // yield N
     PROCESS_FRAME, // frame(N)
     FIBER_DONE,    // return/end
-    ERROR
+    ERROR,
+    FIBER_WAIT     // suspensa por um native (I/O), acorda com resumeFiber
   };
 
   Reason reason;
@@ -495,6 +645,33 @@ struct FiberResult
   int framePercent; // Se PROCESS_FRAME
 };
 
+// Identifica uma fiber suspensa sem guardar ponteiros que o pool recicla:
+// o id passa pelo ProcessTable (a geração falha se o processo morreu)
+struct FiberTicket
+{
+  uint32 procId{0}; // ProcessTable::INVALID_ID = nenhuma
+  int fiber{-1};
+};
+
+// Método/função resolvidos uma vez para chamadas C++ -> script repetidas
+// (sem createString nem procura na cadeia de classes a cada chamada)
+struct MethodHandle
+{
+  ClassDef *klass{nullptr}; // classe para a qual foi resolvido
+  Function *func{nullptr};
+  int arity{-1};
+
+  bool valid() const { return func != nullptr; }
+};
+
+struct FunctionHandle
+{
+  Function *func{nullptr};
+  int arity{-1};
+
+  bool valid() const { return func != nullptr; }
+};
+
 struct TryHandler
 {
   uint8_t *catchIP;
@@ -511,11 +688,7 @@ struct TryHandler
                  stackRestore(nullptr), inFinally(false),
                  hasPendingError(false)
   {
-    pendingError.as.byte = 0;
-    pendingError.type = ValueType::NIL;
     catchConsumed = false;
-    pendingReturn.as.byte = 0;
-    pendingReturn.type = ValueType::NIL;
     hasPendingReturn = false;
   }
 };
@@ -527,19 +700,36 @@ struct Fiber
   float resumeTime; // Quando acorda (yield)
 
   uint8 *ip;
-  Value stack[STACK_MAX];
+  Value *stack;      // Cresce on demand (Interpreter::growFiber)
   Value *stackTop;
-  CallFrame frames[FRAMES_MAX];
+  int stackCapacity;
+  CallFrame *frames; // Cresce on demand até FRAMES_MAX
   int frameCount;
+  int frameCapacity;
   uint8_t *gosubStack[GOSUB_MAX];
   int gosubTop{0};
   TryHandler tryHandlers[TRY_MAX];
   int tryDepth;
 
   Fiber()
-      : state(FiberState::DEAD), resumeTime(0), ip(nullptr), stackTop(stack),
-        frameCount(0), gosubTop(0), tryDepth(0) {}
+      : state(FiberState::DEAD), resumeTime(0), ip(nullptr), stack(nullptr),
+        stackTop(nullptr), stackCapacity(0), frames(nullptr), frameCount(0),
+        frameCapacity(0), gosubTop(0), tryDepth(0) {}
+
+  size_t memoryUsed() const
+  {
+    return sizeof(Fiber) + stackCapacity * sizeof(Value) + frameCapacity * sizeof(CallFrame);
+  }
+
+  void release();
 };
+
+// Limite superior dos slots que uma função usa acima da base do frame:
+// cada instrução empilha no máximo um Value, logo os bytes de código chegam.
+FORCE_INLINE int functionStackSize(const Function *func)
+{
+  return (int)func->chunk->count + FIBER_STACK_SLACK;
+}
 enum class PrivateIndex : uint8
 {
   X = 0,
@@ -588,6 +778,19 @@ struct Process
 
   bool initialized = false;
 
+  // Scheduler (interpreter_process.cpp)
+  uint32 aliveIndex{0}; // posição em aliveProcesses
+  int runIndex{-1};     // posição em runProcesses, -1 = na sleepQueue
+  uint32 sleepSeq{0};   // invalida entradas antigas da sleepQueue
+
+  // Índice espacial (interpreter_spatial.cpp)
+  Process *cellNext{nullptr};
+  Process *cellPrev{nullptr};
+  uint64 cellKey{0};
+  bool inGrid{false};
+  bool spatialDirty{false};  // x/y/z mudaram desde o último flush
+  float collisionRadius{0.0f};
+
   void release();
 
   void reset();
@@ -625,6 +828,10 @@ class Interpreter
   size_t totalBuffers = 0;
   size_t totalNativeStructs = 0;
   size_t totalNativeClasses = 0;
+  size_t bufferBytes = 0;        // dados dos buffers (já em totalAllocated)
+  size_t nativeInlineBytes = 0;  // userData inline (já em totalAllocated)
+  size_t nativeStructBytes = 0;  // dados dos native structs (já em totalAllocated)
+  size_t gcPayloadBytes[GC_PAYLOAD_COUNT] = {}; // backing store dos contentores (TrackedAlloc)
   size_t nextGC = 1024 * 1024;
   static constexpr size_t MIN_GC_THRESHOLD = 512 * 1024;         
   static constexpr size_t MAX_GC_THRESHOLD = 512 * 1024 * 1024;  
@@ -635,6 +842,19 @@ class Interpreter
   int frameCount = 0;
   Vector<GCObject *> grayStack;
 
+  // Modo incremental
+  static constexpr size_t GC_STEP_WORK = 4096;       // slots por step de alocação
+  static constexpr size_t GC_STEP_BYTES = 64 * 1024; // bytes alocados entre steps
+  static constexpr size_t GC_SLICE_WORK = 512;       // fatia do gcStep(budget)
+  bool gcIncremental = false;
+  GCPhase gcPhase = GCPhase::IDLE;
+  size_t gcStepTrigger = 0;
+  size_t gcCycleBytes = 0;   // bytes no início do ciclo (stats)
+  size_t gcCycleObjects = 0;
+  GCObject *sweepList = nullptr;    // objetos do ciclo a varrer
+  GCObject **sweepCursor = nullptr; // alocações novas vão para gcObjects
+  GCStats gcStats;
+
   // gc end
 
   HashMap<String *, uint16, StringHasher, StringEq> moduleNames; // Nome  ID
@@ -660,12 +880,26 @@ class Interpreter
   int pluginSearchPathCount = 0;
   char lastPluginError[512];
 
-  Vector<Process *> aliveProcesses;
+  Vector<Process *> aliveProcesses; // todos os vivos (GC, render)
+  Vector<Process *> runProcesses;   // vivos e acordados, o que o update() percorre
   Vector<Process *> cleanProcesses;
+  ProcessTable processTable;        // id -> Process* (geração validada)
+  SleepQueue sleepQueue;            // adormecidos, por hora de acordar
+  size_t sleepingCount_ = 0;
+
+#ifdef BU_ENABLE_SPATIAL
+  SpatialGrid spatialGrid;          // ligado na primeira query
+  Vector<uint32> spatialDirty;      // ids a reposicionar no próximo flush
+  Vector<uint32> spatialHits;       // resultados da query em curso
+  SpatialQuery spatialQuery;
+  float spatialMaxRadius_ = 0.0f;   // maior collision_radius já visto
+  bool spatialActive_ = false;
+#endif
 
   HeapAllocator arena;
 
   StringPool stringPool;
+  StringBuffer concatBuffer; // OP_CONCAT (reutilizado, não cresce por frame)
 
   float currentTime;
   float lastFrameTime;
@@ -677,6 +911,10 @@ class Interpreter
   Process *mainProcess;
   bool hasFatalError_;
 
+  int fiberRunDepth_ = 0;        // run_fiber aninhados (natives que reentram)
+  bool inScheduler_ = false;     // run_fiber chamado pelo scheduler (não por C++)
+  bool fiberSuspended_ = false;  // pedido de suspendFiber() durante um native
+
   Compiler *compiler;
   Upvalue *openUpvalues;
 
@@ -688,19 +926,89 @@ class Interpreter
   void freeBlueprints();
   void freeFunctions();
   void freeRunningProcesses();
-  void checkGC();
-  void blackenObject(GCObject *obj);
+  // Safe point do GC: só é chamado onde todos os valores vivos estão em
+  // raízes (back-edges de loops, entre frames). Os create*() não disparam
+  // o GC porque correm a meio de opcodes com operandos fora da stack.
+  FORCE_INLINE void checkGC()
+  {
+    if (!enbaledGC)
+      return;
+    size_t bytes = getTotalAlocated();
+    if (gcPhase != GCPhase::IDLE)
+    {
+      if (bytes > gcStepTrigger)
+        gcAllocStep();
+    }
+    else if (bytes > nextGC)
+    {
+      if (gcIncremental)
+        gcAllocStep();
+      else
+        runGC();
+    }
+  }
+  size_t blackenObject(GCObject *obj);
   void traceReferences();
 
+  void gcBegin(bool incremental);
+  void gcAtomic();
+  bool gcWork(size_t budget); // true quando o ciclo terminou
+  void gcEnd();
+  void gcAllocStep();
+  void gcRecordPause(double us);
+  void barrierMark(const Value &v);
+
   Fiber *get_ready_fiber(Process *proc);
+  void parkProcess(Process *proc);
+  void wakeProcess(Process *proc);
+  void wakeSleepers();
+  void removeProcess(Process *proc);
+
+#ifdef BU_ENABLE_SPATIAL
+  // Escritas em x/y/z só marcam o processo; a grelha acerta-se na query
+  FORCE_INLINE void spatialTouch(Process *proc)
+  {
+    if (spatialActive_ && !proc->spatialDirty)
+    {
+      proc->spatialDirty = true;
+      spatialDirty.push(proc->id);
+    }
+  }
+  void spatialRemove(Process *proc);
+#endif
   void resetFiber();
   void initFiber(Fiber *fiber, Function *func);
+
+  // Garante 'slots' Values livres acima do stackTop e 'frames' frames livres.
+  // Se crescer, a stack/frames mudam de sítio: quem guardou ponteiros
+  // (frame, slots, args) tem de os recarregar.
+  bool growFiber(Fiber *fiber, int slots, int frames);
+  FORCE_INLINE bool ensureFiber(Fiber *fiber, int slots, int frames = 1)
+  {
+    if (fiber->frameCount + frames <= fiber->frameCapacity &&
+        fiber->stackTop + slots <= fiber->stack + fiber->stackCapacity)
+    {
+      return true;
+    }
+    return growFiber(fiber, slots, frames);
+  }
   void setPrivateTable();
   void checkType(int index, ValueType expected, const char *funcName);
 
   void addFunctionsClasses(Function *fun);
   bool findAndJumpToHandler(Value error, uint8 *&ip, Fiber *fiber);
 
+  // Bytecode cache (bytecode.cpp): <script>.buc ao lado do .bu
+  FileLoaderCallback fileLoader = nullptr;
+  void *fileLoaderUserdata = nullptr;
+  bool useBytecodeCache = true;
+  ProcessDef *loadScript(const char *path);
+  ProcessDef *loadBytecode(const char *cachePath, const char *source, size_t sourceSize);
+  bool saveBytecode(const char *cachePath, const char *source, size_t sourceSize,
+                    ProcessDef *mainProc);
+  uint64 environmentHash();
+  bool startMainProcess(ProcessDef *proc);
+
   friend class Compiler;
   friend class ModuleBuilder;
 
@@ -710,26 +1018,35 @@ class Interpreter
   size_t countObjects() const;
   void clearAllGCObjects();
 
-  FORCE_INLINE ClassInstance *creatClass()
+  // Fields inline, inicializados com os defaults da classe (ou nil)
+  FORCE_INLINE ClassInstance *creatClass(ClassDef *klass)
   {
-
-    checkGC();
-    size_t size = sizeof(ClassInstance);
-    void *mem = (MapInstance *)arena.Allocate(size); // 40kb
+    size_t payload = (size_t)klass->fieldCount * sizeof(Value);
+    size_t size = sizeof(ClassInstance) + payload;
+    void *mem = arena.Allocate(size);
     ClassInstance *instance = new (mem) ClassInstance();
+    instance->klass = klass;
+    instance->fieldCount = (uint32)klass->fieldCount;
+
+    Value *fields = instance->fields();
+    const int defaults = (int)klass->fieldDefaults.size();
+    for (int i = 0; i < klass->fieldCount; i++)
+    {
+      fields[i] = i < defaults ? klass->fieldDefaults[i] : makeNil();
+    }
 
     totalClasses++;
     instance->next = gcObjects;
     gcObjects = instance;
 
-    totalAllocated += size;
+    totalAllocated += sizeof(ClassInstance);
+    gcPayloadBytes[GC_PAYLOAD_CLASS] += payload;
 
     return instance;
   }
 
   FORCE_INLINE Upvalue *createUpvalue(Value *loc)
   {
-    checkGC();
     size_t size = sizeof(Upvalue);
     void *mem = arena.Allocate(size);
     Upvalue *upvalue = new (mem) Upvalue(loc);
@@ -752,35 +1069,40 @@ class Interpreter
     totalUpvalues--;
   }
 
-  FORCE_INLINE Closure *createClosure()
+  // Upvalues inline (a nullptr até o OP_CLOSURE os preencher)
+  FORCE_INLINE Closure *createClosure(int upvalueCount)
   {
-    checkGC();
-    size_t size = sizeof(Closure);
+    size_t payload = (size_t)upvalueCount * sizeof(Upvalue *);
+    size_t size = sizeof(Closure) + payload;
     void *mem = arena.Allocate(size);
     Closure *closure = new (mem) Closure();
-    closure->type = GCObjectType::CLOSURE;
-    closure->marked = 0;
+    closure->upvalueCount = upvalueCount;
+    if (payload)
+      std::memset(closure->upvalues(), 0, payload);
 
     closure->next = gcObjects;
     gcObjects = closure;
 
-    totalAllocated += size;
+    totalAllocated += sizeof(Closure);
+    gcPayloadBytes[GC_PAYLOAD_CLOSURE] += payload;
+    totalClosures++;
     return closure;
   }
 
   FORCE_INLINE void freeClosure(Closure *c)
   {
-
-    size_t size = sizeof(Closure);
+    size_t payload = (size_t)c->upvalueCount * sizeof(Upvalue *);
     c->~Closure();
-    arena.Free(c, size);
-    totalAllocated -= size;
+    arena.Free(c, sizeof(Closure) + payload);
+    totalAllocated -= sizeof(Closure);
+    gcPayloadBytes[GC_PAYLOAD_CLOSURE] -= payload;
+    totalClosures--;
   }
 
   FORCE_INLINE void freeClass(ClassInstance *c)
   {
-    size_t size = sizeof(ClassInstance);
-    
+    size_t payload = (size_t)c->fieldCount * sizeof(Value);
+
     // Se herda de NativeClass, chama destructor nativo
     if (c->nativeUserData)
     {
@@ -793,22 +1115,32 @@ class Interpreter
       // A arena limpa automaticamente na shutdown
     }
     
-    c->fields.destroy();
     c->klass = nullptr;
     c->~ClassInstance();
-    arena.Free(c, size);
-    totalAllocated -= size;
+    arena.Free(c, sizeof(ClassInstance) + payload);
+    totalAllocated -= sizeof(ClassInstance);
+    gcPayloadBytes[GC_PAYLOAD_CLASS] -= payload;
     totalClasses--;
   }
 
-  FORCE_INLINE StructInstance *createStruct()
+  // Valores inline a nil; o OP_CALL copia os argumentos por cima
+  FORCE_INLINE StructInstance *createStruct(StructDef *def)
   {
-    checkGC();
-    size_t size = sizeof(StructInstance);
-    void *mem = (StructInstance *)arena.Allocate(size); // 40kb
+    size_t payload = (size_t)def->argCount * sizeof(Value);
+    size_t size = sizeof(StructInstance) + payload;
+    void *mem = arena.Allocate(size);
     StructInstance *instance = new (mem) StructInstance();
-    instance->marked = 0;
-    totalAllocated += size;
+    instance->def = def;
+    instance->count = def->argCount;
+
+    Value *values = instance->values();
+    for (uint32 i = 0; i < instance->count; i++)
+    {
+      values[i] = makeNil();
+    }
+
+    totalAllocated += sizeof(StructInstance);
+    gcPayloadBytes[GC_PAYLOAD_STRUCT] += payload;
     totalStructs++;
 
     instance->next = gcObjects;
@@ -819,16 +1151,15 @@ class Interpreter
 
   FORCE_INLINE void freeStruct(StructInstance *s)
   {
-    size_t size = sizeof(StructInstance);
-    s->values.destroy();
+    size_t payload = (size_t)s->count * sizeof(Value);
     s->~StructInstance();
     totalStructs--;
-    arena.Free(s, size);
-    totalAllocated -= size;
+    arena.Free(s, sizeof(StructInstance) + payload);
+    totalAllocated -= sizeof(StructInstance);
+    gcPayloadBytes[GC_PAYLOAD_STRUCT] -= payload;
   }
   FORCE_INLINE ArrayInstance *createArray()
   {
-    checkGC();
     size_t size = sizeof(ArrayInstance);
     void *mem = (ArrayInstance *)arena.Allocate(size); // 32kb
     ArrayInstance *instance = new (mem) ArrayInstance();
@@ -848,7 +1179,6 @@ class Interpreter
   FORCE_INLINE void freeArray(ArrayInstance *a)
   {
     size_t size = sizeof(ArrayInstance);
-    // size += a->values.capacity() * sizeof(Value);
     a->values.destroy();
     a->~ArrayInstance();
     arena.Free(a, size);
@@ -861,7 +1191,6 @@ class Interpreter
 
   FORCE_INLINE MapInstance *createMap()
   {
-    checkGC();
     size_t size = sizeof(MapInstance);
     void *mem = (MapInstance *)arena.Allocate(size); // 40kb
     MapInstance *instance = new (mem) MapInstance();
@@ -878,7 +1207,6 @@ class Interpreter
   FORCE_INLINE void freeMap(MapInstance *m)
   {
     size_t size = sizeof(MapInstance);
-    // size += m->table.capacity * sizeof(Value);
     totalAllocated -= size;
     totalMaps--;
 
@@ -887,14 +1215,21 @@ class Interpreter
     arena.Free(m, size);
   }
 
-  FORCE_INLINE NativeClassInstance *createNativeClass(bool persistent = false)
+  FORCE_INLINE NativeClassInstance *createNativeClass(bool persistent = false, size_t inlineSize = 0)
   {
 
-    checkGC();
-    size_t size = sizeof(NativeClassInstance);
+    size_t size = sizeof(NativeClassInstance) + inlineSize;
     void *mem = (NativeClassInstance *)arena.Allocate(size); // 32kb
     NativeClassInstance *instance = new (mem) NativeClassInstance();
     instance->persistent = persistent;
+    if (inlineSize)
+    {
+      instance->userData = (char *)mem + sizeof(NativeClassInstance);
+      instance->ownsUserData = false;
+      instance->inlineSize = (uint32)inlineSize;
+      std::memset(instance->userData, 0, inlineSize);
+      nativeInlineBytes += inlineSize;
+    }
 
     // Se não for persistent, adiciona ao GC
     if (!persistent)
@@ -917,8 +1252,9 @@ class Interpreter
       n->klass->destructor(this, n->userData);
     }
 
-    size_t size = sizeof(NativeClassInstance);
+    size_t size = sizeof(NativeClassInstance) + n->inlineSize;
     totalAllocated -= size;
+    nativeInlineBytes -= n->inlineSize;
     n->~NativeClassInstance();
     arena.Free(n, size);
     totalNativeClasses--;
@@ -926,7 +1262,6 @@ class Interpreter
 
   FORCE_INLINE NativeStructInstance *createNativeStruct(bool persistent = false)
   {
-    checkGC();
     size_t size = sizeof(NativeStructInstance);
     void *mem = (NativeStructInstance *)arena.Allocate(size); // 32kb
     NativeStructInstance *instance = new (mem) NativeStructInstance();
@@ -944,9 +1279,25 @@ class Interpreter
     return instance;
   }
 
+  // Dados do native struct (zerados), contados como payload
+  FORCE_INLINE void *allocNativeStructData(NativeStructDef *def)
+  {
+    void *data = arena.Allocate(def->structSize);
+    std::memset(data, 0, def->structSize);
+    totalAllocated += def->structSize;
+    nativeStructBytes += def->structSize;
+    return data;
+  }
+
   FORCE_INLINE void freeNativeStruct(NativeStructInstance *n)
   {
     size_t size = sizeof(NativeStructInstance);
+    if (n->data && n->def)
+    {
+      arena.Free(n->data, n->def->structSize);
+      totalAllocated -= n->def->structSize;
+      nativeStructBytes -= n->def->structSize;
+    }
     totalAllocated -= size;
     n->~NativeStructInstance();
     arena.Free(n, size);
@@ -982,6 +1333,25 @@ public:
   void update(float deltaTime);
 
   void runGC();
+
+  // GC incremental: os ciclos avançam por fatias nos safe points e no
+  // gcStep(), que o host chama uma vez por frame com o tempo que sobra.
+  void setGCIncremental(bool enabled);
+  bool isGCIncremental() const { return gcIncremental; }
+  void gcStep(double budgetUs);
+  const GCStats &getGCStats() const { return gcStats; }
+  void resetGCStats() { gcStats = GCStats(); }
+
+  // Write barrier (Dijkstra): durante a marcação, o valor guardado num
+  // objeto do heap fica cinzento, para nenhum objeto preto apontar para
+  // um branco. Obrigatório em código nativo que escreve em arrays/maps/
+  // instâncias já existentes.
+  FORCE_INLINE void writeBarrier(const Value &v)
+  {
+    if (gcPhase == GCPhase::MARK && v.isObject())
+      barrierMark(v);
+  }
+
   int getProcessPrivateIndex(const char *name);
  
 
@@ -992,6 +1362,8 @@ public:
   NativeClassDef *registerNativeClass(const char *name, NativeConstructor ctor,
                                       NativeDestructor dtor, int argCount,
                                       bool persistent = false);
+  NativeClassDef *registerNativeValueClass(const char *name, size_t valueSize,
+                                           NativeStructCtor ctor, int argCount);
   void addNativeMethod(NativeClassDef *klass, const char *methodName,
                        NativeMethod method);
   void addNativeProperty(NativeClassDef *klass, const char *propName,
@@ -1011,15 +1383,22 @@ public:
   ProcessDef *addProcess(const char *name, Function *func, int totalFibers);
   void destroyProcess(Process *proc);
   Process *spawnProcess(ProcessDef *proc);
+  // Processo vivo com este id (nullptr se morreu ou o id é inválido)
+  FORCE_INLINE Process *findProcess(uint32 id) const { return processTable.find(id); }
 
   StructDef *addStruct(String *nam, int *id);
 
   StructDef *registerStruct(String *name);
   ClassDef *registerClass(String *nam);
 
+  // Interned: identificadores, constantes, nomes (nunca recolhidas)
   String *createString(const char *str, uint32 len);
   String *createString(const char *str);
 
+  // Runtime: recolhidas pelo GC quando deixam de ser alcançáveis
+  String *newString(const char *str, uint32 len);
+  String *newString(const char *str);
+
   bool containsClassDefenition(String *name);
   bool getClassDefenition(String *name, ClassDef *result);
   bool tryGetClassDefenition(const char *name, ClassDef **result);
@@ -1035,6 +1414,7 @@ public:
 
   uint32 getTotalProcesses() const;
   uint32 getTotalAliveProcesses() const;
+  size_t getProcessMemory() const; // Bytes dos processos vivos (Process + fibers + stacks)
 
   void destroyFunction(Function *func);
   void addFiber(Process *proc, Function *func);
@@ -1052,6 +1432,8 @@ public:
   void registerTime();
   void registerFile();
   void registerSocket();
+  void registerSpatial();
+  void registerStringBuilder();
   void registerAll();
 
   Function *addFunction(const char *name, int arity = 0);
@@ -1064,6 +1446,33 @@ public:
 
   float getCurrentTime() const;
 
+  // Natives que esperariam por I/O suspendem só a fiber que os chamou:
+  // devolvem um placeholder e o valor chega mais tarde via resumeFiber.
+  bool canSuspendFiber() const;
+  FiberTicket suspendFiber();
+  Fiber *waitingFiber(const FiberTicket &ticket); // nullptr se já não espera
+  bool resumeFiber(const FiberTicket &ticket, Value result);
+#ifdef BU_ENABLE_SOCKETS
+  void pollSockets(); // reactor dos sockets, chamado em update()
+#endif
+
+#ifdef BU_ENABLE_SPATIAL
+  // Vizinhos do processo corrente; devolve o seguinte a cada chamada e nil no fim
+  enum SpatialKind
+  {
+    SPATIAL_NEAR = 0,
+    SPATIAL_COLLISION = 1,
+  };
+  Value spatialNext(SpatialKind kind, int type, double radius);
+  void spatialFlush();
+  void setSpatialCellSize(float size);
+  void setCollisionRadius(Process *proc, float radius);
+#endif
+
+  // OP_CONCAT: values[0] + values[1] + ... pela ordem do '+', mas com um só
+  // buffer. Se um '+' falhar devolve false e os operandos em errLeft/errRight.
+  bool concatValues(Value *values, int count, Value *result, Value *errLeft, Value *errRight);
+
   void runtimeError(const char *format, ...);
   void safetimeError(const char *format, ...);
   bool throwException(Value error);
@@ -1081,6 +1490,17 @@ public:
   // Pushes self + args, sets up the frame, and runs the method
   bool callMethod(Value instance, const char *methodName, int argCount, Value *args);
 
+  // Handles pré-resolvidos: resolver uma vez, chamar todos os frames
+  MethodHandle resolveMethod(ClassDef *klass, const char *methodName);
+  MethodHandle resolveMethod(Value instance, const char *methodName);
+  FunctionHandle resolveFunction(const char *name);
+  bool callMethod(const MethodHandle &handle, Value instance, int argCount, Value *args);
+  bool callFunction(const FunctionHandle &handle, int argCount, Value *args, Value *result = nullptr);
+  // Chama o método em todas as instâncias da classe do handle (as outras são
+  // ignoradas); stack e frame preparados uma vez por lote. Devolve quantas correram.
+  int callMethodOnAll(const MethodHandle &handle, const Value *instances, int count,
+                      int argCount, Value *args);
+
   Process *callProcess(ProcessDef *proc, int argCount);
   Process *callProcess(const char *name, int argCount);
 
@@ -1089,13 +1509,29 @@ public:
   bool run(const char *source, bool dump = false);
   bool compile(const char *source, bool dump);
 
+  // Como run/compile mas a partir do ficheiro: reutiliza o bytecode
+  // cache (<path>c) se as fontes e o ambiente nativo não mudaram
+  bool runFile(const char *path, bool dump = false);
+  bool compileFile(const char *path, bool dump = false);
+  void setBytecodeCache(bool enabled) { useBytecodeCache = enabled; }
+
   void reset();
 
   void setHooks(const VMHooks &h);
 
   void render();
 
-  size_t getTotalAlocated() { return totalAllocated; }
+  // Objetos + strings + backing store dos contentores: é isto que o GC ritma
+  FORCE_INLINE size_t getTotalAlocated() const
+  {
+    size_t payload = 0;
+    for (int i = 0; i < GC_PAYLOAD_COUNT; i++)
+      payload += gcPayloadBytes[i];
+    return totalAllocated + stringPool.getRuntimeBytes() + payload;
+  }
+  void getHeapStats(HeapStats *out) const;
+  size_t getTotalStrings() { return stringPool.getRuntimeCount(); }
+  size_t getTotalStringBytes() { return stringPool.getRuntimeBytes(); }
   size_t getTotalClasses() { return totalClasses; }
   size_t getTotalStructs() { return totalStructs; }
   size_t getTotalArrays() { return totalArrays; }
@@ -1194,226 +1630,261 @@ public:
   bool isNil(int index);
 
   // ====== VALUE ====
-  Value makeClosure()
+  Value makeClosure(int upvalueCount)
   {
-    Value v;
-    v.type = ValueType::CLOSURE;
-    v.as.closure = createClosure();
-    return v;
+    return Value::fromPointer(ValueType::CLOSURE, createClosure(upvalueCount));
   }
 
-  FORCE_INLINE Value makeClassInstance()
+  FORCE_INLINE Value makeClassInstance(ClassDef *klass)
   {
-    Value v;
-    v.type = ValueType::CLASSINSTANCE;
-    v.as.sClass = creatClass();
-    return v;
+    return Value::fromPointer(ValueType::CLASSINSTANCE, creatClass(klass));
   }
 
   FORCE_INLINE Value makeNativeClassInstance()
   {
-    Value v;
-    v.type = ValueType::NATIVECLASSINSTANCE;
-    v.as.sClassInstance = createNativeClass(false);  // default: não persistent
-    return v;
+    return Value::fromPointer(ValueType::NATIVECLASSINSTANCE, createNativeClass(false));  // default: não persistent
   }
 
   FORCE_INLINE Value makeNativeClassInstance(bool persistent)
   {
-    Value v;
-    v.type = ValueType::NATIVECLASSINSTANCE;
-    v.as.sClassInstance = createNativeClass(persistent);
-    return v;
+    return Value::fromPointer(ValueType::NATIVECLASSINSTANCE, createNativeClass(persistent));
   }
 
-  FORCE_INLINE Value makeStructInstance()
+  // Instância de uma classe valor com os dados a zero (o host preenche
+  // instance->userData); não chama o constructor
+  FORCE_INLINE Value makeNativeValue(NativeClassDef *klass)
   {
-    Value v;
-    v.type = ValueType::STRUCTINSTANCE;
-    v.as.sInstance = createStruct();
-    return v;
+    NativeClassInstance *instance = createNativeClass(klass->persistent, klass->valueSize);
+    instance->klass = klass;
+    return Value::fromPointer(ValueType::NATIVECLASSINSTANCE, instance);
+  }
+
+  FORCE_INLINE Value makeStructInstance(StructDef *def)
+  {
+    return Value::fromPointer(ValueType::STRUCTINSTANCE, createStruct(def));
   }
   FORCE_INLINE Value makeBuffer(int count, int typeRaw)
   {
-    Value v;
-    v.type = ValueType::BUFFER;
-    v.as.buffer = createBuffer(count, typeRaw);
-    return v;
+    return Value::fromPointer(ValueType::BUFFER, createBuffer(count, typeRaw));
   }
 
   FORCE_INLINE Value makeMap()
   {
-    Value v;
-    v.type = ValueType::MAP;
-    v.as.map = createMap();
-    return v;
+    return Value::fromPointer(ValueType::MAP, createMap());
   }
 
   FORCE_INLINE Value makeArray()
   {
-    Value v;
-    v.type = ValueType::ARRAY;
-    v.as.array = createArray();
-    return v;
+    return Value::fromPointer(ValueType::ARRAY, createArray());
   }
 
   FORCE_INLINE Value makeNativeStructInstance()
   {
-    Value v;
-    v.type = ValueType::NATIVESTRUCTINSTANCE;
-    v.as.sNativeStruct = createNativeStruct(false);  // default: não persistent
-    return v;
+    return Value::fromPointer(ValueType::NATIVESTRUCTINSTANCE, createNativeStruct(false));  // default: não persistent
   }
 
   FORCE_INLINE Value makeNativeStructInstance(bool persistent)
   {
-    Value v;
-    v.type = ValueType::NATIVESTRUCTINSTANCE;
-    v.as.sNativeStruct = createNativeStruct(persistent);
-    return v;
+    return Value::fromPointer(ValueType::NATIVESTRUCTINSTANCE, createNativeStruct(persistent));
   }
+  // String de runtime (GC). Para constantes/identificadores usar makeString(createString(...))
   FORCE_INLINE Value makeString(const char *str)
   {
-    Value v;
-    v.type = ValueType::STRING;
-    v.as.string = createString(str);
-    return v;
+    return Value::fromPointer(ValueType::STRING, newString(str));
   }
   FORCE_INLINE Value makeString(String *str)
   {
-    Value v;
-    v.type = ValueType::STRING;
-    v.as.string = str;
-    return v;
+    return Value::fromPointer(ValueType::STRING, str);
+  }
+  // Texto montado num StringBuffer: uma só String de runtime
+  FORCE_INLINE Value makeString(const StringBuffer &buffer)
+  {
+    return makeString(stringPool.build(buffer));
   }
 
   FORCE_INLINE Value makeNil()
   {
-    Value v;
-    v.type = ValueType::NIL;
-    return v;
+    return Value();
   }
 
   FORCE_INLINE Value makeInt(int i)
   {
-    Value v;
-    v.type = ValueType::INT;
-    v.as.integer = i;
-    return v;
+    return Value::fromSmall(ValueType::INT, (uint32)i);
   }
 
   FORCE_INLINE Value makeUInt(uint32 i)
   {
-    Value v;
-    v.type = ValueType::UINT;
-    v.as.unsignedInteger = i;
-    return v;
+    return Value::fromSmall(ValueType::UINT, (uint32)i);
   }
 
   FORCE_INLINE Value makeDouble(double d)
   {
-    Value v;
-    v.type = ValueType::DOUBLE;
-    v.as.number = d;
-    return v;
+    return Value::fromDouble(d);
+  }
+
+  // Soma numérica do '+': int + int fica int, o resto promove a double.
+  // Partilhada pelo OP_ADD e pelo prefixo numérico do OP_CONCAT.
+  FORCE_INLINE Value addNumbers(const Value &a, const Value &b)
+  {
+    if (a.isInt() && b.isInt())
+      return makeInt(a.asInt() + b.asInt());
+    double da = a.isInt() ? (double)a.asInt() : a.asDouble();
+    double db = b.isInt() ? (double)b.asInt() : b.asDouble();
+    return makeDouble(da + db);
   }
 
   FORCE_INLINE Value makeBool(bool b)
   {
-    Value v;
-    v.type = ValueType::BOOL;
-    v.as.boolean = b;
-    return v;
+    return Value::fromSmall(ValueType::BOOL, b ? 1u : 0u);
   }
 
   FORCE_INLINE Value makeFunction(int idx)
   {
-    Value v;
-    v.type = ValueType::FUNCTION;
-    v.as.integer = idx;
-    return v;
+    return Value::fromSmall(ValueType::FUNCTION, (uint32)idx);
   }
 
   FORCE_INLINE Value makeNative(int idx)
   {
-    Value v;
-    v.type = ValueType::NATIVE;
-    v.as.integer = idx;
-    return v;
+    return Value::fromSmall(ValueType::NATIVE, (uint32)idx);
   }
 
   FORCE_INLINE Value makeNativeClass(int idx)
   {
-    Value v;
-    v.type = ValueType::NATIVECLASS;
-    v.as.integer = idx;
-    return v;
+    return Value::fromSmall(ValueType::NATIVECLASS, (uint32)idx);
   }
 
   FORCE_INLINE Value makeProcess(int idx)
   {
-    Value v;
-    v.type = ValueType::PROCESS;
-    v.as.integer = idx;
-    return v;
+    return Value::fromSmall(ValueType::PROCESS, (uint32)idx);
   }
 
   FORCE_INLINE Value makeStruct(int idx)
   {
-    Value v;
-    v.type = ValueType::STRUCT;
-    v.as.integer = idx;
-    return v;
+    return Value::fromSmall(ValueType::STRUCT, (uint32)idx);
   }
 
   FORCE_INLINE Value makeClass(int idx)
   {
-    Value v;
-    v.type = ValueType::CLASS;
-    v.as.integer = idx;
-    return v;
+    return Value::fromSmall(ValueType::CLASS, (uint32)idx);
   }
 
   FORCE_INLINE Value makePointer(void *pointer)
   {
-    Value v;
-    v.type = ValueType::POINTER;
-    v.as.pointer = pointer;
-    return v;
+    return Value::fromPointer(ValueType::POINTER, pointer);
   }
 
   FORCE_INLINE Value makeNativeStruct(int idx)
   {
-    Value v;
-    v.type = ValueType::NATIVESTRUCT;
-    v.as.integer = idx;
-    return v;
+    return Value::fromSmall(ValueType::NATIVESTRUCT, (uint32)idx);
   }
 
   FORCE_INLINE Value makeByte(int idx)
   {
-    Value v;
-    v.type = ValueType::BYTE;
-    v.as.byte = idx;
-    return v;
+    return Value::fromSmall(ValueType::BYTE, (uint8)idx);
   }
 
   FORCE_INLINE Value makeFloat(float idx)
   {
-    Value v;
-    v.type = ValueType::FLOAT;
-    v.as.real = idx;
-    return v;
+    return Value::fromFloat(idx);
   }
   FORCE_INLINE Value makeModuleRef(uint16 moduleId, uint16 funcId)
   {
-    Value v;
-    v.type = ValueType::MODULEREFERENCE;
     uint32 packed = 0;
 
     packed |= (moduleId & 0xFFFF) << 16; // 16 bits
     packed |= (funcId & 0xFFFF);         // 16 bits
-    v.as.unsignedInteger = packed;
-    return v;
+    return Value::fromSmall(ValueType::MODULEREFERENCE, packed);
+  }
+
+  // ====== FOREACH ====
+  // O iterador é um int: posição em arrays, buffers e strings, slot da
+  // HashMap nos maps. Nada é alocado por loop nem por volta.
+
+  // Próxima posição depois de iter (nil = início).
+  // 1: *out é válido, 0: fim, -1: seq não é iterável
+  FORCE_INLINE int iterNext(const Value &seq, const Value &iter, int *out)
+  {
+    int index = iter.isNil() ? 0 : iter.rawInt() + 1;
+    int size;
+    if (seq.isArray())
+      size = (int)seq.asArray()->values.size();
+    else if (seq.isMap())
+    {
+      index = seq.asMap()->table.nextFilled(index);
+      size = index + 1; // -1 no fim
+    }
+    else if (seq.isBuffer())
+      size = seq.asBuffer()->count;
+    else if (seq.isString())
+      size = (int)seq.asString()->length();
+    else
+      return -1;
+
+    if (index < 0 || index >= size)
+      return 0;
+    *out = index;
+    return 1;
+  }
+
+  // Elemento na posição index: maps dão a chave, strings 1 char (interned)
+  FORCE_INLINE bool iterValue(const Value &seq, int index, Value *out)
+  {
+    if (seq.isArray())
+    {
+      ArrayInstance *array = seq.asArray();
+      if (index < 0 || index >= (int)array->values.size())
+        return false;
+      *out = array->values[index];
+      return true;
+    }
+    if (seq.isMap())
+    {
+      auto *entry = seq.asMap()->table.entryAt(index);
+      if (!entry)
+        return false;
+      *out = entry->key;
+      return true;
+    }
+    if (seq.isBuffer())
+    {
+      BufferInstance *buffer = seq.asBuffer();
+      if (index < 0 || index >= buffer->count)
+        return false;
+      *out = bufferElement(buffer, index);
+      return true;
+    }
+    if (seq.isString())
+    {
+      String *str = seq.asString();
+      if (index < 0 || index >= (int)str->length())
+        return false;
+      *out = makeString(stringPool.charString((uint8)str->chars()[index]));
+      return true;
+    }
+    return false;
+  }
+
+  FORCE_INLINE Value bufferElement(BufferInstance *buffer, int index)
+  {
+    const uint8 *ptr = buffer->data + (size_t)index * buffer->elementSize;
+    switch (buffer->type)
+    {
+    case BufferType::UINT8:
+      return makeInt((int)*ptr);
+    case BufferType::INT16:
+      return makeInt((int)*(const int16 *)ptr);
+    case BufferType::UINT16:
+      return makeUInt((uint32)*(const uint16 *)ptr);
+    case BufferType::INT32:
+      return makeInt((int)*(const int32 *)ptr);
+    case BufferType::UINT32:
+      return makeUInt(*(const uint32 *)ptr);
+    case BufferType::FLOAT:
+      return makeDouble((double)*(const float *)ptr);
+    case BufferType::DOUBLE:
+      return makeDouble(*(const double *)ptr);
+    default:
+      return makeNil();
+    }
   }
 };
\ No newline at end of file
@@ -10,6 +10,7 @@
  *                 Must implement: size_t operator()(const K&) const
  * @tparam Eq A callable type for key equality comparison.
  *            Must implement: bool operator()(const K&, const K&) const
+ * @tparam Alloc Allocation policy (PlainAlloc, or TrackedAlloc for GC payloads).
  *
  * @details
  * - Uses open addressing with linear probing for collision resolution
@@ -43,12 +44,12 @@
 #include <cassert>
 #include <cstring>
 
-template <typename K, typename V, typename Hasher, typename Eq>
+template <typename K, typename V, typename Hasher, typename Eq, typename Alloc = PlainAlloc>
 struct HashMap
 {
   enum State : uint8
   {
-    EMPTY = 0, // Explícito! memset garante isso
+    EMPTY = 0,
     FILLED = 1,
     TOMBSTONE = 2
   };
@@ -79,13 +80,21 @@ struct HashMap
   {
     if (!entries)
       return;
-    aFree(entries);
+    Alloc::release(entries, capacity * sizeof(Entry));
     entries = nullptr;
     capacity = count = tombstones = 0;
   }
 
   size_t mask() const { return capacity - 1; }
 
+  // Só o state conta numa entrada vazia: key/value ficam por inicializar
+  // (memset não serve, o K pode não ser trivial nem ter nil a zeros)
+  static void markEmpty(Entry *e, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+      e[i].state = EMPTY;
+  }
+
   Entry *findSlot(const K &key, size_t hash)
   {
     size_t index = hash & mask();
@@ -139,8 +148,8 @@ struct HashMap
     Entry *old = entries;
     size_t oldCap = capacity;
 
-    entries = (Entry *)aAlloc(newCap * sizeof(Entry));
-    std::memset(entries, 0, newCap * sizeof(Entry)); // State = EMPTY = 0
+    entries = (Entry *)Alloc::allocate(newCap * sizeof(Entry));
+    markEmpty(entries, newCap);
 
     capacity = newCap;
     count = 0;
@@ -158,7 +167,7 @@ struct HashMap
           count++;
         }
       }
-      aFree(old);
+      Alloc::release(old, oldCap * sizeof(Entry));
     }
   }
 
@@ -296,7 +305,7 @@ struct HashMap
   {
     if (entries)
     {
-      std::memset(entries, 0, capacity * sizeof(Entry));
+      markEmpty(entries, capacity);
       count = 0;
       tombstones = 0;
     }
@@ -333,6 +342,26 @@ struct HashMap
       }
     }
   }
+
+  // Cursor (foreach sem alocar): primeira entrada ocupada em [from, capacity),
+  // ou -1 no fim. Se a tabela crescer a meio, o cursor continua válido
+  // (só pode saltar ou repetir entradas).
+  int nextFilled(int from) const
+  {
+    for (size_t i = from < 0 ? 0 : (size_t)from; i < capacity; i++)
+    {
+      if (entries[i].state == FILLED)
+        return (int)i;
+    }
+    return -1;
+  }
+
+  const Entry *entryAt(int index) const
+  {
+    if (index < 0 || (size_t)index >= capacity || entries[index].state != FILLED)
+      return nullptr;
+    return &entries[index];
+  }
 };
 
 //******************************************************************************
@@ -1,6 +1,10 @@
 #pragma once
 #include "config.hpp"
 
+// Formato do bytecode cache (.buc). Incrementar sempre que opcodes,
+// operandos ou o layout de Function/ClassDef/ProcessDef mudem.
+static constexpr uint32 BYTECODE_VERSION = 4;
+
 enum Opcode : uint8
 {
     // Literals (0-3)
@@ -126,4 +130,64 @@ enum Opcode : uint8
     // Multi-return (88)
     OP_RETURN_N = 88,  // Returns N values from script function
 
-};
\ No newline at end of file
+    // Superinstruções (89-93), geradas só pelo peephole (compiler_peephole.cpp)
+    OP_GET_LOCAL_GET_LOCAL_ADD = 89, // [a][b]            local[a] + local[b]
+    OP_LOCAL_LESS_CONST_JUMP = 90,   // [a][k16][jmp16]   local[a] < k ; jump if false
+    OP_LOCAL_LESS_LOCAL_JUMP = 91,   // [a][b][jmp16]     local[a] < local[b] ; jump if false
+    OP_INC_LOCAL = 92,               // [a][k16]          local[a] += k (k int), sem stack
+    OP_GET_PROPERTY_SELF = 93,       // [name16][ic16]    GET_LOCAL 0 + GET_PROPERTY
+
+    // Quickening (94-107): o runtime reescreve o opcode genérico no sítio depois
+    // de ver os tipos dos operandos. Mesmo tamanho (1 byte, sem operandos);
+    // se a guarda falhar volta ao genérico. Nunca saem do compilador nem vão
+    // para o cache (ver unquickenOpcode).
+    OP_ADD_II = 94,
+    OP_ADD_DD = 95,
+    OP_SUBTRACT_II = 96,
+    OP_SUBTRACT_DD = 97,
+    OP_MULTIPLY_II = 98,
+    OP_MULTIPLY_DD = 99,
+    OP_LESS_II = 100,
+    OP_LESS_DD = 101,
+    OP_LESS_EQUAL_II = 102,
+    OP_LESS_EQUAL_DD = 103,
+    OP_GREATER_II = 104,
+    OP_GREATER_DD = 105,
+    OP_GREATER_EQUAL_II = 106,
+    OP_GREATER_EQUAL_DD = 107,
+
+    // Cadeias de '+' com strings (Compiler::addChain)
+    OP_CONCAT = 108,                 // [n]               v0 + v1 + ... + v(n-1), um só buffer
+
+};
+
+// Opcode genérico de um opcode quickened (os outros ficam iguais)
+FORCE_INLINE uint8 unquickenOpcode(uint8 op)
+{
+    switch (op)
+    {
+    case OP_ADD_II:
+    case OP_ADD_DD:
+        return OP_ADD;
+    case OP_SUBTRACT_II:
+    case OP_SUBTRACT_DD:
+        return OP_SUBTRACT;
+    case OP_MULTIPLY_II:
+    case OP_MULTIPLY_DD:
+        return OP_MULTIPLY;
+    case OP_LESS_II:
+    case OP_LESS_DD:
+        return OP_LESS;
+    case OP_LESS_EQUAL_II:
+    case OP_LESS_EQUAL_DD:
+        return OP_LESS_EQUAL;
+    case OP_GREATER_II:
+    case OP_GREATER_DD:
+        return OP_GREATER;
+    case OP_GREATER_EQUAL_II:
+    case OP_GREATER_EQUAL_DD:
+        return OP_GREATER_EQUAL;
+    default:
+        return op;
+    }
+}
\ No newline at end of file
@@ -22,10 +22,15 @@ void OsEPrintf(const char* fmt, ...);
 
 int OsFileWrite(const char *filename, const void *data, size_t size);
 int OsFileRead(const char *filename, void *buffer, size_t maxSize);
+int OsFileReadAt(const char *filename, void *buffer, size_t size, long position);
 bool OsFileExists(const char *filename);
 int OsFileSize(const char *filename);
 bool OsFileDelete(const char *filename);
 
+// Ficheiro mapeado só para leitura (bytecode cache)
+const void *OsMapFile(const char *filename, size_t *outSize);
+void OsUnmapFile(const void *data, size_t size);
+
 // Dynamic library loading
 void* OsLoadLibrary(const char* path);
 void* OsGetSymbol(void* handle, const char* symbol);
@@ -32,6 +32,41 @@ struct CStringEq
     }
 };
 
+// Texto que cresce por append (StringBuilder, OP_CONCAT). Capacidade em
+// potências de 2, por isso montar n bytes custa O(n); só vira String no fim
+// (StringPool::build).
+struct StringBuffer
+{
+    char *data = nullptr;
+    uint32 length = 0;
+    uint32 capacity = 0;
+
+    StringBuffer() {}
+    ~StringBuffer() { aFree(data); }
+    StringBuffer(const StringBuffer &) = delete;
+    StringBuffer &operator=(const StringBuffer &) = delete;
+
+    void reserve(uint32 needed);
+    FORCE_INLINE void append(const char *str, uint32 len)
+    {
+        if (length + len > capacity)
+            reserve(length + len);
+        std::memcpy(data + length, str, len);
+        length += len;
+    }
+    FORCE_INLINE void append(String *str) { append(str->chars(), (uint32)str->length()); }
+    FORCE_INLINE void appendChar(char c)
+    {
+        if (length + 1 > capacity)
+            reserve(length + 1);
+        data[length++] = c;
+    }
+    void appendInt(int value);
+    void appendUInt(uint32 value);
+    void appendDouble(double value);
+    void clear() { length = 0; }
+};
+
 class StringPool
 {
 private:
@@ -45,18 +80,40 @@ private:
     Vector<String *> map;
     String *allocString();
     void deallocString(String *s);
+    void copyChars(String *s, const char *str, uint32 len);
+
+    // Strings de runtime (concat, substring, receive, ...) - recolhidas pelo GC
+    Vector<String *> runtime;
+    size_t runtimeBytes = 0;
+    size_t sweepIndex = 0;
+    uint8 allocMark = 0; // 1 durante o sweep incremental: as novas sobrevivem
+    void freeRuntime(String *s);
+
+    String *charStrings[256] = {}; // strings de 1 char (interned), criadas a pedido
 
 public:
     StringPool();
     ~StringPool();
 
     size_t getBytesAllocated() { return bytesAllocated; }
+    size_t getRuntimeBytes() const { return runtimeBytes; }
+    size_t getRuntimeCount() const { return runtime.size(); }
 
+    // Interned (identificadores, constantes, nomes de natives)
     String *create(const char *str, uint32 len);
     void destroy(String *s);
 
     String *create(const char *str);
 
+    // Não interned, fica a cargo do GC
+    String *createRuntime(const char *str, uint32 len);
+    String *createRuntime(const char *str);
+
+    void sweep();        // liberta strings de runtime não marcadas
+    void beginSweep();
+    bool sweepStep(size_t *budget); // true quando acabou
+    void clearRuntime(); // liberta todas as strings de runtime
+
     String *format(const char *fmt, ...);
 
     String *getString(int index);
@@ -65,6 +122,7 @@ public:
     int indexOf(String *str, const char *substr, int startIndex = 0);
 
     String *concat(String *a, String *b);
+    String *build(const StringBuffer &buffer); // de runtime; "" é a interned
     String *upper(String *src);
     String *lower(String *src);
     String *substring(String *src, uint32 start, uint32 end);
@@ -78,6 +136,7 @@ public:
     bool startsWith(String *str, String *prefix);
     bool endsWith(String *str, String *suffix);
     String *at(String *str, int index);
+    String *charString(uint8 c); // interned: não aloca depois da 1ª vez
     String *repeat(String *str, int count);
 
     String *toString(int value);
@@ -113,6 +172,93 @@ public:
     size_t size() const { return pool.size(); }
 };
 
+// Slot map dos processos vivos: id = slot | geração << INDEX_BITS.
+// Um id de um processo morto (slot reutilizado) deixa de bater na geração.
+// A geração nunca é 0, por isso um id nunca coincide com o índice de um
+// ProcessDef (o mesmo ValueType::PROCESS serve os dois).
+// A lista livre é FIFO (um slot só volta depois de todos os outros livres)
+// e um slot que chega à última geração é reformado em vez de dar a volta:
+// um id antigo nunca volta a bater noutro processo.
+class ProcessTable
+{
+    struct Slot
+    {
+        Process *proc;
+        uint32 generation;
+        uint32 nextFree;
+    };
+
+    Vector<Slot> slots;
+    uint32 freeHead;
+    uint32 freeTail;
+
+    void pushFree(uint32 index);
+
+public:
+    static const uint32 INDEX_BITS = 18;
+    static const uint32 INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static const uint32 GENERATION_MASK = (1u << (31 - INDEX_BITS)) - 1; // ids cabem num int positivo
+    static const uint32 INVALID_ID = 0;
+
+    ProcessTable();
+
+    uint32 insert(Process *proc); // INVALID_ID se a tabela estiver cheia
+    void remove(uint32 id);
+    void clear();
+
+    FORCE_INLINE Process *find(uint32 id) const
+    {
+        uint32 index = id & INDEX_MASK;
+        if (index >= slots.size())
+            return nullptr;
+        const Slot &slot = slots[index];
+        return slot.generation == (id >> INDEX_BITS) ? slot.proc : nullptr;
+    }
+
+    static FORCE_INLINE bool isHandle(uint32 id) { return (id >> INDEX_BITS) != 0; }
+};
+
+// Min-heap dos processos adormecidos (frame(N), yield longo, I/O): o update()
+// só lhes volta a tocar quando a hora chega. Uma entrada fica obsoleta se o
+// processo morrer ou for acordado antes (o seq deixa de bater).
+struct SleepEntry
+{
+    float time;
+    uint32 id;
+    uint32 seq;
+};
+
+class SleepQueue
+{
+    Vector<SleepEntry> heap;
+
+    void siftUp(size_t i);
+    void siftDown(size_t i);
+
+public:
+    void push(float time, uint32 id, uint32 seq);
+    void pop();
+    const SleepEntry &top() const { return heap[0]; }
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    void clear() { heap.clear(); }
+
+    // Fica só com as entradas em que keep(entry) é true
+    template <typename Keep>
+    void retain(Keep keep)
+    {
+        size_t n = 0;
+        for (size_t i = 0; i < heap.size(); i++)
+        {
+            if (keep(heap[i]))
+                heap[n++] = heap[i];
+        }
+        heap.resize(n);
+        for (size_t i = n / 2; i-- > 0;)
+            siftDown(i);
+    }
+};
+
 inline bool compareString(String *a, String *b)
 {
     if (a == nullptr || b == nullptr)
@@ -0,0 +1,80 @@
+#pragma once
+#include "config.hpp"
+#include "map.hpp"
+
+struct Process;
+
+// Chave de célula: 3 x 21 bits (cx, cy, cz)
+struct CellKeyHasher
+{
+    size_t operator()(uint64 key) const
+    {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        return (size_t)key;
+    }
+};
+
+struct CellKeyEq
+{
+    bool operator()(uint64 a, uint64 b) const { return a == b; }
+};
+
+// Grelha uniforme (hash espacial) sobre x/y/z dos processos.
+// Cada célula é uma lista intrusiva (Process::cellNext/cellPrev): inserir,
+// mudar de célula e remover são O(1) e não alocam por processo.
+class SpatialGrid
+{
+    HashMap<uint64, Process *, CellKeyHasher, CellKeyEq> cells;
+    float cellSize = 64.0f;
+    float invCellSize = 1.0f / 64.0f;
+    size_t count = 0;
+
+    void link(Process *proc, uint64 key);
+    void unlink(Process *proc);
+
+public:
+    static constexpr int COORD_BITS = 21;
+
+    void setCellSize(float size);
+    float getCellSize() const { return cellSize; }
+    size_t size() const { return count; }
+
+    FORCE_INLINE int coord(double v) const { return (int)floor(v * invCellSize); }
+
+    static FORCE_INLINE uint64 key(int cx, int cy, int cz)
+    {
+        const uint64 mask = (1ULL << COORD_BITS) - 1;
+        return (((uint64)cx & mask) << (2 * COORD_BITS)) |
+               (((uint64)cy & mask) << COORD_BITS) |
+               ((uint64)cz & mask);
+    }
+
+    // Insere ou muda de célula (não faz nada se a célula é a mesma)
+    void place(Process *proc, double x, double y, double z);
+    void remove(Process *proc);
+    void clear();
+
+    // Cabeça da lista da célula (nullptr se vazia)
+    Process *cell(int cx, int cy, int cz) const
+    {
+        Process *head = nullptr;
+        cells.get(key(cx, cy, cz), &head);
+        return head;
+    }
+};
+
+// Query em curso (get_near/collision): os resultados ficam num buffer
+// reutilizado e cada chamada devolve o seguinte. Só vale no frame em que
+// foi feita: no frame seguinte as posições mudaram e a query recomeça.
+struct SpatialQuery
+{
+    int frame = -1;
+    uint32 caller = 0;
+    int kind = -1;
+    int type = -1;
+    double radius = 0.0;
+    size_t next = 0;
+    bool active = false;
+};
@@ -8,6 +8,8 @@ struct String
   static constexpr size_t IS_LONG_FLAG = 0x80000000u;
   
   int index;
+  uint8 marked;   // GC (só strings de runtime)
+  bool interned;  // identificadores/constantes: vivem até StringPool::clear()
   size_t hash;
   size_t length_and_flag;
 
@@ -24,6 +26,20 @@ struct String
   FORCE_INLINE char *chars() { return isLong() ? ptr : data; }
 };
 
+// FNV-1a 64 bits (bytecode cache: fontes e ambiente nativo)
+inline uint64 hashBytes64(const void *data, size_t len, uint64 h = 14695981039346656037ull)
+{
+  const uint8 *p = (const uint8 *)data;
+  const uint8 *end = p + len;
+
+  while (p != end)
+  {
+    h ^= *p++;
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
 inline size_t hashString(const char *s, uint32 len)
 {
   size_t h = 2166136261u;
@@ -9,8 +9,9 @@ typedef const char* (*FileLoaderCallback)(const char* filename, size_t* outSize,
 
 static constexpr int MAX_PRIVATES = 16;
  
-static constexpr int STACK_MAX = 1024;
+static constexpr int STACK_MAX = 1024;   // Base máxima de um frame (overflow)
 static constexpr int FRAMES_MAX = 1024;
+static constexpr int FIBER_STACK_SLACK = 16;
 static constexpr int GOSUB_MAX = 16;
 static constexpr int TRY_MAX = 8;
 
@@ -2,6 +2,7 @@
 #include "config.hpp"
 #include "string.hpp"
 #include "pool.hpp"
+#include <cstdint>
 
 struct StructInstance;
 struct ArrayInstance;
@@ -44,8 +45,115 @@ enum class ValueType : uint8
   CLOSURE,
 };
 
+#ifdef USE_NAN_BOXING
+// NaN-boxing: um Value é um double de 64 bits. Os NaN quiet com tag != 0
+// (bits 48-50, mais o bit de sinal) guardam os outros tipos:
+//   0x7FF9..0x7FFF  objetos GC (ponteiro de 48 bits)
+//   0xFFF9..0xFFFB  native instances / pointer (ponteiro de 48 bits)
+//   0xFFFC          tipos pequenos: ValueType nos bits 32-39, payload de 32 bits
+// makeDouble() canoniza os NaN para a tag 0, logo nunca colidem.
+static constexpr uint64 NAN_QNAN = 0x7FF8000000000000ull;
+static constexpr uint64 NAN_PAYLOAD = 0x0000FFFFFFFFFFFFull;
+static constexpr uint64 NAN_CANONICAL = 0x7FF8000000000000ull;
+static constexpr uint32 NAN_SMALL_TOP = 0xFFFC;
+
+static constexpr uint32 nanTop(ValueType type)
+{
+  return type == ValueType::STRING                 ? 0x7FF9
+         : type == ValueType::ARRAY                ? 0x7FFA
+         : type == ValueType::MAP                  ? 0x7FFB
+         : type == ValueType::BUFFER               ? 0x7FFC
+         : type == ValueType::CLASSINSTANCE        ? 0x7FFD
+         : type == ValueType::STRUCTINSTANCE       ? 0x7FFE
+         : type == ValueType::CLOSURE              ? 0x7FFF
+         : type == ValueType::NATIVECLASSINSTANCE  ? 0xFFF9
+         : type == ValueType::NATIVESTRUCTINSTANCE ? 0xFFFA
+         : type == ValueType::POINTER              ? 0xFFFB
+                                                   : NAN_SMALL_TOP;
+}
+
+extern const ValueType nanBoxedTypes[16];
+#endif
+
 struct Value
 {
+#ifdef USE_NAN_BOXING
+  uint64 bits;
+
+  FORCE_INLINE Value() : bits((uint64)NAN_SMALL_TOP << 48) {}
+
+  FORCE_INLINE ValueType getType() const
+  {
+    uint32 top = (uint32)(bits >> 48);
+    if ((top & 0x7FF8) != 0x7FF8 || (top & 7) == 0)
+      return ValueType::DOUBLE;
+    if (top == NAN_SMALL_TOP)
+      return (ValueType)((bits >> 32) & 0xFF);
+    return nanBoxedTypes[((top >> 12) & 8) | (top & 7)];
+  }
+
+  // Comparação numa instrução: 'type' é constante em todos os isX()
+  FORCE_INLINE bool hasType(ValueType type) const
+  {
+    if (type == ValueType::DOUBLE)
+      return isDouble();
+    return nanTop(type) == NAN_SMALL_TOP
+               ? (bits >> 32) == (((uint64)NAN_SMALL_TOP << 16) | (uint64)type)
+               : (bits >> 48) == nanTop(type);
+  }
+
+  FORCE_INLINE bool isDouble() const
+  {
+    return (bits & NAN_QNAN) != NAN_QNAN || (bits & 0x0007000000000000ull) == 0;
+  }
+
+  static FORCE_INLINE Value fromSmall(ValueType type, uint32 payload)
+  {
+    Value v;
+    v.bits = ((uint64)NAN_SMALL_TOP << 48) | ((uint64)type << 32) | payload;
+    return v;
+  }
+  static FORCE_INLINE Value fromPointer(ValueType type, const void *ptr)
+  {
+    Value v;
+    v.bits = ((uint64)nanTop(type) << 48) | ((uint64)(uintptr_t)ptr & NAN_PAYLOAD);
+    return v;
+  }
+  static FORCE_INLINE Value fromDouble(double d)
+  {
+    Value v;
+    std::memcpy(&v.bits, &d, sizeof(double));
+    if (UNLIKELY(d != d))
+      v.bits = NAN_CANONICAL;
+    return v;
+  }
+  static FORCE_INLINE Value fromFloat(float f)
+  {
+    uint32 raw;
+    std::memcpy(&raw, &f, sizeof(float));
+    return fromSmall(ValueType::FLOAT, raw);
+  }
+
+  FORCE_INLINE uint32 rawPayload() const { return (uint32)bits; }
+  FORCE_INLINE void *rawPointer() const { return (void *)(uintptr_t)(bits & NAN_PAYLOAD); }
+  FORCE_INLINE int rawInt() const { return (int)(uint32)bits; }
+  FORCE_INLINE uint32 rawUInt() const { return (uint32)bits; }
+  FORCE_INLINE uint8 rawByte() const { return (uint8)bits; }
+  FORCE_INLINE bool rawBool() const { return (uint32)bits != 0; }
+  FORCE_INLINE float rawFloat() const
+  {
+    float f;
+    uint32 raw = (uint32)bits;
+    std::memcpy(&f, &raw, sizeof(float));
+    return f;
+  }
+  FORCE_INLINE double rawDouble() const
+  {
+    double d;
+    std::memcpy(&d, &bits, sizeof(double));
+    return d;
+  }
+#else
   ValueType type;
   union
   {
@@ -70,141 +178,193 @@ struct Value
 
   } as;
 
-  Value();
+  FORCE_INLINE Value() : type(ValueType::NIL) { as.number = 0; }
+
+  FORCE_INLINE ValueType getType() const { return type; }
+  FORCE_INLINE bool hasType(ValueType t) const { return type == t; }
+  FORCE_INLINE bool isDouble() const { return type == ValueType::DOUBLE; }
+
+  static FORCE_INLINE Value fromSmall(ValueType type, uint32 payload)
+  {
+    Value v;
+    v.type = type;
+    v.as.unsignedInteger = payload;
+    return v;
+  }
+  static FORCE_INLINE Value fromPointer(ValueType type, const void *ptr)
+  {
+    Value v;
+    v.type = type;
+    v.as.pointer = (void *)ptr;
+    return v;
+  }
+  static FORCE_INLINE Value fromDouble(double d)
+  {
+    Value v;
+    v.type = ValueType::DOUBLE;
+    v.as.number = d;
+    return v;
+  }
+  static FORCE_INLINE Value fromFloat(float f)
+  {
+    Value v;
+    v.type = ValueType::FLOAT;
+    v.as.real = f;
+    return v;
+  }
+
+  FORCE_INLINE uint32 rawPayload() const { return as.unsignedInteger; }
+  FORCE_INLINE void *rawPointer() const { return as.pointer; }
+  FORCE_INLINE int rawInt() const { return as.integer; }
+  FORCE_INLINE uint32 rawUInt() const { return as.unsignedInteger; }
+  FORCE_INLINE uint8 rawByte() const { return as.byte; }
+  FORCE_INLINE bool rawBool() const { return as.boolean; }
+  FORCE_INLINE float rawFloat() const { return as.real; }
+  FORCE_INLINE double rawDouble() const { return as.number; }
+#endif
+
   Value(const Value &other) = default;
   Value(Value &&other) noexcept = default;
   Value &operator=(const Value &other) = default;
   Value &operator=(Value &&other) noexcept = default;
 
   // Type checks
-  FORCE_INLINE bool isNumber() const { return ((type == ValueType::INT) || (type == ValueType::DOUBLE) || (type == ValueType::BYTE) || (type == ValueType::FLOAT) || (type == ValueType::UINT)); }
-  FORCE_INLINE bool isNil() const { return type == ValueType::NIL; }
-  FORCE_INLINE bool isBool() const { return type == ValueType::BOOL; }
-  FORCE_INLINE bool isInt() const { return type == ValueType::INT; }
-  FORCE_INLINE bool isByte() const { return type == ValueType::BYTE; }
-  FORCE_INLINE bool isDouble() const { return type == ValueType::DOUBLE; }
-  FORCE_INLINE bool isFloat() const { return type == ValueType::FLOAT; }
-  FORCE_INLINE bool isUInt() const { return type == ValueType::UINT; }
-  FORCE_INLINE bool isString() const { return type == ValueType::STRING; }
-  FORCE_INLINE bool isFunction() const { return type == ValueType::FUNCTION; }
-  FORCE_INLINE bool isNative() const { return type == ValueType::NATIVE; }
-  FORCE_INLINE bool isNativeClass() const { return type == ValueType::NATIVECLASS; }
-  FORCE_INLINE bool isProcess() const { return type == ValueType::PROCESS; }
-  FORCE_INLINE bool isStruct() const { return type == ValueType::STRUCT; }
-  FORCE_INLINE bool isStructInstance() const { return type == ValueType::STRUCTINSTANCE; }
-  FORCE_INLINE bool isMap() const { return type == ValueType::MAP; }
-  FORCE_INLINE bool isArray() const { return type == ValueType::ARRAY; }
-  FORCE_INLINE bool isBuffer() const { return type == ValueType::BUFFER; }
-  FORCE_INLINE bool isClass() const { return type == ValueType::CLASS; }
-  FORCE_INLINE bool isClassInstance() const { return type == ValueType::CLASSINSTANCE; }
-  FORCE_INLINE bool isNativeClassInstance() const { return type == ValueType::NATIVECLASSINSTANCE; }
-  FORCE_INLINE bool isPointer() const { return type == ValueType::POINTER; }
-  FORCE_INLINE bool isNativeStruct() const { return type == ValueType::NATIVESTRUCT; }
-  FORCE_INLINE bool isNativeStructInstance() const { return type == ValueType::NATIVESTRUCTINSTANCE; }
-  FORCE_INLINE bool isModuleRef() const { return type == ValueType::MODULEREFERENCE; }
-  FORCE_INLINE bool isClosure() const { return type == ValueType::CLOSURE; }
-
-  FORCE_INLINE bool isObject() const { return (isBuffer() || isMap() || isArray() || isClassInstance() || isStructInstance() || isNativeClassInstance() || isNativeStructInstance() || isClosure()); }
+  FORCE_INLINE bool isNumber() const { return isInt() || isDouble() || isByte() || isFloat() || isUInt(); }
+  FORCE_INLINE bool isNil() const { return hasType(ValueType::NIL); }
+  FORCE_INLINE bool isBool() const { return hasType(ValueType::BOOL); }
+  FORCE_INLINE bool isInt() const { return hasType(ValueType::INT); }
+  FORCE_INLINE bool isByte() const { return hasType(ValueType::BYTE); }
+  FORCE_INLINE bool isFloat() const { return hasType(ValueType::FLOAT); }
+  FORCE_INLINE bool isUInt() const { return hasType(ValueType::UINT); }
+  FORCE_INLINE bool isString() const { return hasType(ValueType::STRING); }
+  FORCE_INLINE bool isFunction() const { return hasType(ValueType::FUNCTION); }
+  FORCE_INLINE bool isNative() const { return hasType(ValueType::NATIVE); }
+  FORCE_INLINE bool isNativeClass() const { return hasType(ValueType::NATIVECLASS); }
+  FORCE_INLINE bool isProcess() const { return hasType(ValueType::PROCESS); }
+  FORCE_INLINE bool isStruct() const { return hasType(ValueType::STRUCT); }
+  FORCE_INLINE bool isStructInstance() const { return hasType(ValueType::STRUCTINSTANCE); }
+  FORCE_INLINE bool isMap() const { return hasType(ValueType::MAP); }
+  FORCE_INLINE bool isArray() const { return hasType(ValueType::ARRAY); }
+  FORCE_INLINE bool isBuffer() const { return hasType(ValueType::BUFFER); }
+  FORCE_INLINE bool isClass() const { return hasType(ValueType::CLASS); }
+  FORCE_INLINE bool isClassInstance() const { return hasType(ValueType::CLASSINSTANCE); }
+  FORCE_INLINE bool isNativeClassInstance() const { return hasType(ValueType::NATIVECLASSINSTANCE); }
+  FORCE_INLINE bool isPointer() const { return hasType(ValueType::POINTER); }
+  FORCE_INLINE bool isNativeStruct() const { return hasType(ValueType::NATIVESTRUCT); }
+  FORCE_INLINE bool isNativeStructInstance() const { return hasType(ValueType::NATIVESTRUCTINSTANCE); }
+  FORCE_INLINE bool isModuleRef() const { return hasType(ValueType::MODULEREFERENCE); }
+  FORCE_INLINE bool isClosure() const { return hasType(ValueType::CLOSURE); }
+
+#ifdef USE_NAN_BOXING
+  // Todos os objetos GC têm tag 0x7FF9..0x7FFF ou 0xFFF9..0xFFFA
+  FORCE_INLINE bool isObject() const
+  {
+    uint32 top = (uint32)(bits >> 48);
+    return (top >= 0x7FF9 && top <= 0x7FFF) || top == 0xFFF9 || top == 0xFFFA;
+  }
+#else
+  FORCE_INLINE bool isObject() const { return (isString() || isBuffer() || isMap() || isArray() || isClassInstance() || isStructInstance() || isNativeClassInstance() || isNativeStructInstance() || isClosure()); }
+#endif
 
   // Conversions
 
-  FORCE_INLINE const char *asStringChars() const { return as.string->chars(); }
-  FORCE_INLINE String *asString() const { return as.string; }
-  FORCE_INLINE int asFunctionId() const { return as.integer; }
-  FORCE_INLINE int asNativeId() const { return as.integer; }
-  FORCE_INLINE int asProcessId() const { return as.integer; }
+  FORCE_INLINE const char *asStringChars() const { return ((String *)rawPointer())->chars(); }
+  FORCE_INLINE String *asString() const { return ((String *)rawPointer()); }
+  FORCE_INLINE int asFunctionId() const { return rawInt(); }
+  FORCE_INLINE int asNativeId() const { return rawInt(); }
+  FORCE_INLINE int asProcessId() const { return rawInt(); }
 
   FORCE_INLINE Closure * asClosure() const
   {
-    return as.closure;
+    return ((Closure *)rawPointer());
   }
   
 
   FORCE_INLINE int asStructId() const
   {
-    return as.integer;
+    return rawInt();
   }
 
   FORCE_INLINE int asClassId() const
   {
-    return as.integer;
+    return rawInt();
   }
 
   FORCE_INLINE int asClassNativeId() const
   {
-    return as.integer;
+    return rawInt();
   }
 
   FORCE_INLINE void *asPointer() const
   {
 #ifdef DEBUG
-    if (type != ValueType::POINTER)
+    if (!isPointer())
     {
       Error("Cannot convert to pointer!");
     }
 #endif
-    return as.pointer;
+    return rawPointer();
   }
 
   FORCE_INLINE int asNativeStructId() const
   {
-    return as.integer;
+    return rawInt();
   }
 
   FORCE_INLINE StructInstance *asStructInstance() const
   {
-    return as.sInstance;
+    return ((StructInstance *)rawPointer());
   }
 
   FORCE_INLINE ArrayInstance *asArray() const
   {
-    return as.array;
+    return ((ArrayInstance *)rawPointer());
   }
 
   FORCE_INLINE MapInstance *asMap() const
   {
-    return as.map;
+    return ((MapInstance *)rawPointer());
   }
 
   FORCE_INLINE BufferInstance *asBuffer() const
   {
-    return as.buffer;
+    return ((BufferInstance *)rawPointer());
   }
 
   FORCE_INLINE NativeClassInstance *asNativeClassInstance() const
   {
-    return as.sClassInstance;
+    return ((NativeClassInstance *)rawPointer());
   }
 
   FORCE_INLINE ClassInstance *asClassInstance() const
   {
-    return as.sClass;
+    return ((ClassInstance *)rawPointer());
   }
 
   FORCE_INLINE NativeStructInstance *asNativeStructInstance() const
   {
-    return as.sNativeStruct;
+    return ((NativeStructInstance *)rawPointer());
   }
 
   FORCE_INLINE uint32 asUInt() const
   {
-    if (LIKELY(type == ValueType::UINT))
+    if (LIKELY(hasType(ValueType::UINT)))
     {
-      return as.unsignedInteger;
+      return rawUInt();
     }
 
-    switch (type)
+    switch (getType())
     {
     case ValueType::INT:
-      return (uint32)as.integer;
+      return (uint32)rawInt();
     case ValueType::BYTE:
-      return (uint32)as.byte;
+      return (uint32)rawByte();
     case ValueType::BOOL:
-      return (uint32)as.boolean;
+      return (uint32)rawBool();
     case ValueType::FLOAT:
-      return (uint32)as.real;
+      return (uint32)rawFloat();
     case ValueType::DOUBLE:
-      return (uint32)as.number;
+      return (uint32)rawDouble();
     default:
 #ifdef DEBUG
       Error("Cannot convert to uint!");
@@ -215,23 +375,23 @@ struct Value
 
   FORCE_INLINE uint8 asByte() const
   {
-    if (LIKELY(type == ValueType::BYTE))
+    if (LIKELY(hasType(ValueType::BYTE)))
     {
-      return as.byte;
+      return rawByte();
     }
 
-    switch (type)
+    switch (getType())
     {
     case ValueType::INT:
-      return (uint8)as.integer;
+      return (uint8)rawInt();
     case ValueType::UINT:
-      return (uint8)as.unsignedInteger;
+      return (uint8)rawUInt();
     case ValueType::BOOL:
-      return (uint8)as.boolean;
+      return (uint8)rawBool();
     case ValueType::FLOAT:
-      return (uint8)as.real;
+      return (uint8)rawFloat();
     case ValueType::DOUBLE:
-      return (uint8)as.number;
+      return (uint8)rawDouble();
     default:
 #ifdef DEBUG
       Error("Cannot convert to byte!");
@@ -242,22 +402,22 @@ struct Value
 
   FORCE_INLINE int asInt() const
   {
-    if (LIKELY(type == ValueType::INT))
+    if (LIKELY(hasType(ValueType::INT)))
     {
-      return as.integer;
+      return rawInt();
     }
-    switch (type)
+    switch (getType())
     {
     case ValueType::DOUBLE:
-      return (int)as.number;
+      return (int)rawDouble();
     case ValueType::FLOAT:
-      return (int)as.real;
+      return (int)rawFloat();
     case ValueType::BYTE:
-      return (int)as.byte;
+      return (int)rawByte();
     case ValueType::UINT:
-      return (int)as.unsignedInteger;
+      return (int)rawUInt();
     case ValueType::BOOL:
-      return (int)as.boolean;
+      return (int)rawBool();
     default:
 #ifdef DEBUG
       Error("Cannot convert to int!");
@@ -268,22 +428,22 @@ struct Value
 
   FORCE_INLINE float asFloat() const
   {
-    if (LIKELY(type == ValueType::FLOAT))
+    if (LIKELY(hasType(ValueType::FLOAT)))
     {
-      return as.real;
+      return rawFloat();
     }
-    switch (type)
+    switch (getType())
     {
     case ValueType::DOUBLE:
-      return (float)as.number;
+      return (float)rawDouble();
     case ValueType::INT:
-      return (float)as.integer;
+      return (float)rawInt();
     case ValueType::BYTE:
-      return (float)as.byte;
+      return (float)rawByte();
     case ValueType::UINT:
-      return (float)as.unsignedInteger;
+      return (float)rawUInt();
     case ValueType::BOOL:
-      return (float)as.boolean;
+      return (float)rawBool();
     default:
 #ifdef DEBUG
       Error("Cannot convert to float!");
@@ -295,23 +455,23 @@ struct Value
   FORCE_INLINE double asDouble() const
   {
 
-    if (LIKELY(type == ValueType::DOUBLE))
+    if (LIKELY(hasType(ValueType::DOUBLE)))
     {
-      return as.number;
+      return rawDouble();
     }
 
-    switch (type)
+    switch (getType())
     {
     case ValueType::FLOAT:
-      return (double)as.real;
+      return (double)rawFloat();
     case ValueType::INT:
-      return (double)as.integer;
+      return (double)rawInt();
     case ValueType::BYTE:
-      return (double)as.byte;
+      return (double)rawByte();
     case ValueType::UINT:
-      return (double)as.unsignedInteger;
+      return (double)rawUInt();
     case ValueType::BOOL:
-      return (double)as.boolean;
+      return (double)rawBool();
     default:
 #ifdef DEBUG
       Error("Cannot convert to double!");
@@ -322,24 +482,24 @@ struct Value
 
   FORCE_INLINE bool asBool() const
   {
-    if (LIKELY(type == ValueType::BOOL))
+    if (LIKELY(hasType(ValueType::BOOL)))
     {
-      return as.boolean;
+      return rawBool();
     }
 
     // Qualquer número != 0 é true
-    switch (type)
+    switch (getType())
     {
     case ValueType::INT:
-      return as.integer != 0;
+      return rawInt() != 0;
     case ValueType::UINT:
-      return as.unsignedInteger != 0;
+      return rawUInt() != 0;
     case ValueType::BYTE:
-      return as.byte != 0;
+      return rawByte() != 0;
     case ValueType::FLOAT:
-      return as.real != 0.0f;
+      return rawFloat() != 0.0f;
     case ValueType::DOUBLE:
-      return as.number != 0.0;
+      return rawDouble() != 0.0;
     case ValueType::NIL:
       return false;
     default:
@@ -350,23 +510,23 @@ struct Value
   FORCE_INLINE double asNumber() const
   {
 
-    if (LIKELY(type == ValueType::DOUBLE))
+    if (LIKELY(hasType(ValueType::DOUBLE)))
     {
-      return as.number;
+      return rawDouble();
     }
 
-    switch (type)
+    switch (getType())
     {
     case ValueType::FLOAT:
-      return (double)as.real;
+      return (double)rawFloat();
     case ValueType::INT:
-      return (double)as.integer;
+      return (double)rawInt();
     case ValueType::BYTE:
-      return (double)as.byte;
+      return (double)rawByte();
     case ValueType::UINT:
-      return (double)as.unsignedInteger;
+      return (double)rawUInt();
     case ValueType::BOOL:
-      return (double)as.boolean;
+      return (double)rawBool();
     default:
 #ifdef DEBUG
       Error("Cannot convert to number!");
@@ -393,10 +553,10 @@ static FORCE_INLINE bool valuesEqual(const Value &a, const Value &b)
   }
 
   // Rest require exact type match
-  if (a.type != b.type)
+  if (a.getType() != b.getType())
     return false;
 
-  switch (a.type)
+  switch (a.getType())
   {
   case ValueType::BOOL:
     return a.asBool() == b.asBool();
@@ -443,7 +603,7 @@ static FORCE_INLINE bool valuesEqual(const Value &a, const Value &b)
 
 static FORCE_INLINE bool isTruthy(const Value &value)
 {
-  switch (value.type)
+  switch (value.getType())
   {
   case ValueType::NIL:
     return false;
@@ -7,8 +7,9 @@
  * disables copying to ensure efficient memory management.
  * 
  * @tparam T The POD type stored in the vector. Must be a Plain Old Data type.
+ * @tparam Alloc Allocation policy (PlainAlloc, or TrackedAlloc for GC payloads).
  * 
- * @note This class uses custom memory allocation functions (aAlloc/aFree).
+ * @note This class uses custom memory allocation functions (Alloc::allocate/release).
  * @note Copy operations are explicitly deleted; only move semantics are supported.
  * @note All operations assume T is a POD type and use memcpy/memmove for efficiency.
  * 
@@ -51,7 +52,7 @@
 #include <utility>  
 
 // Vector otimizado para tipos POD (sem constructor/destructor)
-template <typename T>
+template <typename T, typename Alloc = PlainAlloc>
 class Vector
 {
 private:
@@ -114,7 +115,7 @@ public:
     {
         if (data_)
         {
-            aFree(data_);
+            Alloc::release(data_, capacity_ * sizeof(T));
             data_ = nullptr;
             size_ = 0;
             capacity_ = 0;
@@ -127,13 +128,13 @@ public:
             return;
 
         // Aloca novo bloco
-        T *newData = (T *)aAlloc(newCapacity * sizeof(T));
+        T *newData = (T *)Alloc::allocate(newCapacity * sizeof(T));
 
         // Copia dados antigos (POD - usa memcpy)
         if (data_)
         {
             std::memcpy(newData, data_, size_ * sizeof(T));
-            aFree(data_);
+            Alloc::release(data_, capacity_ * sizeof(T));
         }
 
         data_ = newData;
@@ -197,6 +198,19 @@ public:
         size_ = newSize;
     }
 
+    void resize(size_t newSize, const T &fill)
+    {
+        if (newSize > capacity_)
+        {
+            reserve(newSize);
+        }
+        for (size_t i = size_; i < newSize; i++)
+        {
+            data_[i] = fill;
+        }
+        size_ = newSize;
+    }
+
     // Accessors
     T &operator[](size_t i) { return data_[i]; }
     const T &operator[](size_t i) const { return data_[i]; }
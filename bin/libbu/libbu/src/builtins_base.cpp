@@ -19,32 +19,32 @@ static void valueToString(const Value &v, std::string &out)
 {
   char buffer[256];
 
-  switch (v.type)
+  switch (v.getType())
   {
   case ValueType::NIL:
     out += "nil";
     break;
   case ValueType::BOOL:
-    out += v.as.boolean ? "true" : "false";
+    out += v.rawBool() ? "true" : "false";
     break;
   case ValueType::BYTE:
-    snprintf(buffer, 256, "%u", v.as.byte);
+    snprintf(buffer, 256, "%u", v.rawByte());
     out += buffer;
     break;
   case ValueType::INT:
-    snprintf(buffer, 256, "%d", v.as.integer);
+    snprintf(buffer, 256, "%d", v.rawInt());
     out += buffer;
     break;
   case ValueType::UINT:
-    snprintf(buffer, 256, "%u", v.as.unsignedInteger);
+    snprintf(buffer, 256, "%u", v.rawUInt());
     out += buffer;
     break;
   case ValueType::FLOAT:
-    snprintf(buffer, 256, "%.2f", v.as.real);
+    snprintf(buffer, 256, "%.2f", v.rawFloat());
     out += buffer;
     break;
   case ValueType::DOUBLE:
-    snprintf(buffer, 256, "%.2f", v.as.number);
+    snprintf(buffer, 256, "%.2f", v.rawDouble());
     out += buffer;
     break;
   case ValueType::STRING:
@@ -91,19 +91,19 @@ int native_int(Interpreter *vm, int argCount, Value *args)
   const Value &arg = args[0];
   int intValue = 0;
 
-  switch (arg.type)
+  switch (arg.getType())
   {
   case ValueType::INT:
-    intValue = arg.as.integer;
+    intValue = arg.rawInt();
     break;
   case ValueType::UINT:
-    intValue = static_cast<int>(arg.as.unsignedInteger);
+    intValue = static_cast<int>(arg.rawUInt());
     break;
   case ValueType::FLOAT:
-    intValue = static_cast<int>(arg.as.real);
+    intValue = static_cast<int>(arg.rawFloat());
     break;
   case ValueType::DOUBLE:
-    intValue = static_cast<int>(arg.as.number);
+    intValue = static_cast<int>(arg.rawDouble());
     break;
   case ValueType::STRING:
   {
@@ -131,19 +131,19 @@ int native_real(Interpreter *vm, int argCount, Value *args)
   const Value &arg = args[0];
   double floatValue = 0.0;
 
-  switch (arg.type)
+  switch (arg.getType())
   {
   case ValueType::INT:
-    floatValue = static_cast<double>(arg.as.integer);
+    floatValue = static_cast<double>(arg.rawInt());
     break;
   case ValueType::UINT:
-    floatValue = static_cast<double>(arg.as.unsignedInteger);
+    floatValue = static_cast<double>(arg.rawUInt());
     break;
   case ValueType::FLOAT:
-    floatValue = arg.as.real;
+    floatValue = arg.rawFloat();
     break;
   case ValueType::DOUBLE:
-    floatValue = static_cast<double>(arg.as.number);
+    floatValue = static_cast<double>(arg.rawDouble());
     break;
   case ValueType::STRING:
   {
@@ -162,7 +162,7 @@ int native_real(Interpreter *vm, int argCount, Value *args)
 
 int native_format(Interpreter *vm, int argCount, Value *args)
 {
-  if (argCount < 1 || args[0].type != ValueType::STRING)
+  if (argCount < 1 || args[0].getType() != ValueType::STRING)
   {
     vm->runtimeError("format expects string as first argument");
     return 0;
@@ -194,7 +194,7 @@ int native_format(Interpreter *vm, int argCount, Value *args)
 
 int native_write(Interpreter *vm, int argCount, Value *args)
 {
-  if (argCount < 1 || args[0].type != ValueType::STRING)
+  if (argCount < 1 || args[0].getType() != ValueType::STRING)
   {
     vm->runtimeError("write expects string as first argument");
     return 0;
@@ -254,6 +254,87 @@ int native_gc(Interpreter *vm, int argCount, Value *args)
   return 0;
 }
 
+int native_gc_step(Interpreter *vm, int argCount, Value *args)
+{
+  if (argCount != 1 || !args[0].isNumber())
+  {
+    vm->runtimeError("_gc_step expects budget in microseconds");
+    return 0;
+  }
+  vm->gcStep(args[0].asNumber());
+  return 0;
+}
+
+int native_gc_incremental(Interpreter *vm, int argCount, Value *args)
+{
+  if (argCount != 1 || !args[0].isBool())
+  {
+    vm->runtimeError("_gc_incremental expects bool");
+    return 0;
+  }
+  vm->setGCIncremental(args[0].asBool());
+  return 0;
+}
+
+int native_gc_stats(Interpreter *vm, int argCount, Value *args)
+{
+  const GCStats &stats = vm->getGCStats();
+
+  Value result = vm->makeMap();
+  MapInstance *map = result.asMap();
+
+  map->table.set(vm->makeString("cycles"), vm->makeInt((int)stats.cycles));
+  map->table.set(vm->makeString("pauses"), vm->makeInt((int)stats.pauses));
+  map->table.set(vm->makeString("last_pause_us"), vm->makeDouble(stats.lastPauseUs));
+  map->table.set(vm->makeString("max_pause_us"), vm->makeDouble(stats.maxPauseUs));
+  map->table.set(vm->makeString("total_pause_us"), vm->makeDouble(stats.totalPauseUs));
+  map->table.set(vm->makeString("last_freed_bytes"), vm->makeInt((int)stats.lastFreedBytes));
+
+  vm->push(result);
+  return 1;
+}
+
+static void heapStatsEntry(Interpreter *vm, MapInstance *map, const char *name, const HeapTypeStats &t)
+{
+  Value entry = vm->makeMap();
+  MapInstance *m = entry.asMap();
+  m->table.set(vm->makeString("count"), vm->makeInt((int)t.count));
+  m->table.set(vm->makeString("object_bytes"), vm->makeInt((int)t.objectBytes));
+  m->table.set(vm->makeString("payload_bytes"), vm->makeInt((int)t.payloadBytes));
+  map->table.set(vm->makeString(name), entry);
+}
+
+// _heap_stats() -> {arrays: {count, object_bytes, payload_bytes}, ..., total_bytes}
+int native_heap_stats(Interpreter *vm, int argCount, Value *args)
+{
+  HeapStats stats;
+  vm->getHeapStats(&stats);
+
+  Value result = vm->makeMap();
+  MapInstance *map = result.asMap();
+
+  heapStatsEntry(vm, map, "arrays", stats.arrays);
+  heapStatsEntry(vm, map, "maps", stats.maps);
+  heapStatsEntry(vm, map, "structs", stats.structs);
+  heapStatsEntry(vm, map, "classes", stats.classes);
+  heapStatsEntry(vm, map, "closures", stats.closures);
+  heapStatsEntry(vm, map, "upvalues", stats.upvalues);
+  heapStatsEntry(vm, map, "buffers", stats.buffers);
+  heapStatsEntry(vm, map, "native_classes", stats.nativeClasses);
+  heapStatsEntry(vm, map, "native_structs", stats.nativeStructs);
+  heapStatsEntry(vm, map, "strings", stats.strings);
+  map->table.set(vm->makeString("total_bytes"), vm->makeInt((int)stats.totalBytes));
+
+  vm->push(result);
+  return 1;
+}
+
+int native_process_memory(Interpreter *vm, int argCount, Value *args)
+{
+  // double: um int passa os 2 GB
+  vm->push(vm->makeDouble((double)vm->getProcessMemory()));
+  return 1;
+}
 
 int native_ticks(Interpreter *vm, int argCount, Value *args)
 {
@@ -276,6 +357,11 @@ void Interpreter::registerBase()
   registerNative("print_stack", native_print_stack, -1);
   registerNative("ticks", native_ticks, 1);
   registerNative("_gc", native_gc, 0);
+  registerNative("_gc_step", native_gc_step, 1);
+  registerNative("_gc_incremental", native_gc_incremental, 1);
+  registerNative("_gc_stats", native_gc_stats, 0);
+  registerNative("_heap_stats", native_heap_stats, 0);
+  registerNative("_process_memory", native_process_memory, 0);
   registerNative("str", native_string, 1);
   registerNative("int", native_int, 1);
   registerNative("real", native_real, 1);
@@ -284,6 +370,7 @@ void Interpreter::registerBase()
 void Interpreter::registerAll()
 {
   registerBase();
+  registerStringBuilder();
 
 #ifdef BU_ENABLE_MATH
   registerMath();
@@ -315,4 +402,8 @@ void Interpreter::registerAll()
 #ifdef BU_ENABLE_SOCKETS
   registerSocket();
 #endif
+
+#ifdef BU_ENABLE_SPATIAL
+  registerSpatial();
+#endif
 }
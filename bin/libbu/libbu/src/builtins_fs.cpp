@@ -45,8 +45,8 @@ int native_fs_read(Interpreter *vm, int argCount, Value *args)
         return 1;
     }
 
-    buffer[bytesRead] = '\0';
-    vm->push(vm->makeString(buffer));
+    // String de runtime com tamanho: aceita zeros e não fica no pool
+    vm->push(vm->makeString(vm->newString(buffer, bytesRead)));
     free(buffer);
 
     return 1;
@@ -61,9 +61,67 @@ int native_fs_write(Interpreter *vm, int argCount, Value *args)
     }
 
     const char *path = args[0].asStringChars();
-    const char *data = args[1].asStringChars();
+    String *data = args[1].asString();
+
+    vm->push(vm->makeBool(OsFileWrite(path, data->chars(), data->length()) >= 0));
+    return 1;
+}
+
+// fs.read_into(path, buffer, [offset], [length], [position])
+// Lê do ficheiro (a partir de position) direto para a fatia do buffer.
+// Devolve os bytes lidos ou -1.
+int native_fs_read_into(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount < 2 || !args[0].isString() || !args[1].isBuffer())
+    {
+        vm->runtimeError("read_into expects (path, buffer, [offset], [length], [position])");
+        vm->push(vm->makeInt(-1));
+        return 1;
+    }
+
+    BufferInstance *buf = args[1].asBuffer();
+    int offset, length;
+    if (!buf->slice(argCount < 4 ? argCount : 4, args, 2, &offset, &length))
+    {
+        vm->runtimeError("read_into: invalid offset/length for buffer of %d bytes", buf->byteSize());
+        vm->push(vm->makeInt(-1));
+        return 1;
+    }
+
+    long position = 0;
+    if (argCount >= 5 && args[4].isInt())
+        position = args[4].asInt();
+
+    if (length == 0)
+    {
+        vm->push(vm->makeInt(0));
+        return 1;
+    }
+
+    vm->push(vm->makeInt(OsFileReadAt(args[0].asStringChars(), buf->data + offset, length, position)));
+    return 1;
+}
+
+// fs.write_buffer(path, buffer, [offset], [length])
+int native_fs_write_buffer(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount < 2 || !args[0].isString() || !args[1].isBuffer())
+    {
+        vm->runtimeError("write_buffer expects (path, buffer, [offset], [length])");
+        vm->push(vm->makeBool(false));
+        return 1;
+    }
+
+    BufferInstance *buf = args[1].asBuffer();
+    int offset, length;
+    if (!buf->slice(argCount, args, 2, &offset, &length))
+    {
+        vm->runtimeError("write_buffer: invalid offset/length for buffer of %d bytes", buf->byteSize());
+        vm->push(vm->makeBool(false));
+        return 1;
+    }
 
-    vm->push(vm->makeBool(OsFileWrite(path, data, strlen(data)) > 0));
+    vm->push(vm->makeBool(OsFileWrite(args[0].asStringChars(), buf->data + offset, length) >= 0));
     return 1;
 }
 
@@ -248,11 +306,11 @@ int native_fs_stat(Interpreter *vm, int argCount, Value *args)
         return 1;
     }
 
-    m->table.set(vm->makeString("size").asString(), vm->makeInt((int)st.st_size));
-    m->table.set(vm->makeString("isdir").asString(), vm->makeBool(S_ISDIR(st.st_mode)));
-    m->table.set(vm->makeString("isfile").asString(), vm->makeBool(S_ISREG(st.st_mode)));
-    m->table.set(vm->makeString("mode").asString(), vm->makeInt(st.st_mode));
-    m->table.set(vm->makeString("mtime").asString(), vm->makeInt((int)st.st_mtime));
+    m->table.set(vm->makeString("size"), vm->makeInt((int)st.st_size));
+    m->table.set(vm->makeString("isdir"), vm->makeBool(S_ISDIR(st.st_mode)));
+    m->table.set(vm->makeString("isfile"), vm->makeBool(S_ISREG(st.st_mode)));
+    m->table.set(vm->makeString("mode"), vm->makeInt(st.st_mode));
+    m->table.set(vm->makeString("mtime"), vm->makeInt((int)st.st_mtime));
 #endif
 
     vm->push(map);
@@ -264,6 +322,8 @@ void Interpreter::registerFS()
     addModule("fs")
         .addFunction("read", native_fs_read, 1)
         .addFunction("write", native_fs_write, 2)
+        .addFunction("read_into", native_fs_read_into, -1)
+        .addFunction("write_buffer", native_fs_write_buffer, -1)
         .addFunction("append", native_fs_append, 2)
         .addFunction("remove", native_fs_remove, 1)
         .addFunction("mkdir", native_fs_mkdir, 1)
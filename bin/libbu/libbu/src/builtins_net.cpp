@@ -30,6 +30,10 @@
 #include <unistd.h>
 #include <errno.h>
 #include <netdb.h>
+#include <poll.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
 #define INVALID_SOCKET -1
 #define SOCKET_ERROR -1
 #define closesocket close
@@ -43,6 +47,16 @@ enum class SocketType
     UDP
 };
 
+// Operação em que uma fiber está suspensa (sockets async)
+enum class IOWait : uint8
+{
+    NONE,
+    ACCEPT,
+    RECEIVE,
+    RECEIVE_INTO,
+    CONNECT
+};
+
 struct SocketHandle
 {
     SOCKET socket;
@@ -51,8 +65,29 @@ struct SocketHandle
     bool isConnected;
     uint16_t port;
     std::string host;
+
+    bool isAsync = false; // accept/receive/connect suspendem a fiber
+    IOWait waitOp = IOWait::NONE;
+    int waitOffset = 0;
+    int waitSize = 0;
+    FiberTicket waiter;
+    bool inReactor = false;
 };
 
+// Texto de uma chave de map (headers, query, json): strings e ints
+static std::string mapKeyText(const Value &key)
+{
+    if (key.isString())
+        return key.asStringChars();
+    if (key.isInt())
+        return std::to_string(key.asInt());
+    if (key.isNumber())
+        return std::to_string(key.asDouble());
+    if (key.isBool())
+        return key.asBool() ? "true" : "false";
+    return "";
+}
+
 // Extrair headers de um map
 static std::map<std::string, std::string> extractHeaders(Interpreter *vm, Value mapValue)
 {
@@ -65,23 +100,24 @@ static std::map<std::string, std::string> extractHeaders(Interpreter *vm, Value
 
     MapInstance *map = mapValue.asMap();
 
-    map->table.forEach([&](String *key, Value value)
+    map->table.forEach([&](Value k, Value value)
                        {
+                           std::string key = mapKeyText(k);
                            if (value.isString())
                            {
-                               headers[key->chars()] = value.asStringChars();
+                               headers[key] = value.asStringChars();
                            } else if (value.isInt())
                            {
-                               headers[key->chars()] = std::to_string(value.asInt());
+                               headers[key] = std::to_string(value.asInt());
                            } else if (value.isFloat())
                            {
-                               headers[key->chars()] = std::to_string(value.asFloat());
+                               headers[key] = std::to_string(value.asFloat());
                            }else if (value.isBool())
                            {
-                               headers[key->chars()] = std::to_string(value.asBool());
+                               headers[key] = std::to_string(value.asBool());
                            }else if (value.isDouble())
                            {
-                               headers[key->chars()] = std::to_string(value.asDouble());
+                               headers[key] = std::to_string(value.asDouble());
                            } 
                            else
                            {
@@ -104,14 +140,14 @@ static std::string buildQueryString(Interpreter *vm, Value mapValue)
     MapInstance *map = mapValue.asMap();
     bool first = true;
 
-    map->table.forEach([&](String *key, Value value)
+    map->table.forEach([&](Value key, Value value)
                        {
         if (!first) {
             query += "&";
         }
         first = false;
 
-        query += key->chars();
+        query += mapKeyText(key);
         query += "=";
 
         if (value.isString())
@@ -226,6 +262,129 @@ static std::vector<SocketHandle *> openSockets;
 static int nextSocketId = 1;
 static bool wsaInitialized = false;
 
+//
+// REACTOR
+// Um socket async que daria EWOULDBLOCK suspende só a fiber que chamou;
+// update() chama pollSockets() e a operação é repetida quando o socket
+// fica pronto (epoll em Linux, poll/WSAPoll no resto).
+//
+
+static int waitingSockets = 0;
+#ifdef __linux__
+static int reactorFd = -1;
+#endif
+
+static bool wouldBlock()
+{
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EWOULDBLOCK || errno == EAGAIN;
+#endif
+}
+
+static bool setSocketBlocking(SOCKET sock, bool blocking)
+{
+#ifdef _WIN32
+    u_long mode = blocking ? 0 : 1;
+    return ioctlsocket(sock, FIONBIO, &mode) == 0;
+#else
+    int flags = fcntl(sock, F_GETFL, 0);
+    if (flags == -1)
+        return false;
+
+    flags = blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK);
+    return fcntl(sock, F_SETFL, flags) == 0;
+#endif
+}
+
+// Arma o socket para a operação pendente (one-shot)
+static bool reactorWatch(int id, SocketHandle *handle)
+{
+#ifdef __linux__
+    if (reactorFd == -1)
+    {
+        reactorFd = epoll_create1(EPOLL_CLOEXEC);
+        if (reactorFd == -1)
+            return false;
+    }
+
+    epoll_event ev = {};
+    ev.events = (handle->waitOp == IOWait::CONNECT ? EPOLLOUT : EPOLLIN) | EPOLLONESHOT;
+    ev.data.u32 = (uint32)id;
+    int op = handle->inReactor ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (epoll_ctl(reactorFd, op, handle->socket, &ev) != 0)
+        return false;
+#endif
+    handle->inReactor = true;
+    return true;
+}
+
+static void reactorForget(SocketHandle *handle)
+{
+#ifdef __linux__
+    if (handle->inReactor && reactorFd != -1)
+        epoll_ctl(reactorFd, EPOLL_CTL_DEL, handle->socket, nullptr);
+#endif
+    handle->inReactor = false;
+}
+
+// Suspende a fiber corrente até o reactor completar a operação.
+// O native devolve um placeholder (que fica na stack da fiber, logo vivo
+// para o GC) e resumeFiber troca-o pelo resultado.
+static int suspendOnSocket(Interpreter *vm, int id, SocketHandle *handle, IOWait op,
+                           int offset, int size, Value placeholder)
+{
+    if (handle->waitOp != IOWait::NONE)
+    {
+        vm->runtimeError("Socket %d already has a waiting fiber", id);
+        vm->push(vm->makeNil());
+        return 1;
+    }
+
+    handle->waitOp = op;
+    handle->waitOffset = offset;
+    handle->waitSize = size;
+    if (!reactorWatch(id, handle))
+    {
+        handle->waitOp = IOWait::NONE;
+        vm->push(vm->makeNil());
+        return 1;
+    }
+
+    handle->waiter = vm->suspendFiber();
+    waitingSockets++;
+    vm->push(placeholder);
+    return 1;
+}
+
+// Acorda a fiber suspensa no socket (close/quit) com nil
+static void wakeWaiter(Interpreter *vm, SocketHandle *handle, Value result)
+{
+    if (handle->waitOp == IOWait::NONE)
+        return;
+
+    FiberTicket waiter = handle->waiter;
+    handle->waitOp = IOWait::NONE;
+    handle->waiter = FiberTicket();
+    waitingSockets--;
+    vm->resumeFiber(waiter, result);
+}
+
+static void closeHandle(Interpreter *vm, int id)
+{
+    SocketHandle *handle = openSockets[id - 1];
+    wakeWaiter(vm, handle, vm->makeNil());
+    reactorForget(handle);
+
+    if (handle->type != SocketType::UDP)
+        shutdown(handle->socket, SHUT_RDWR);
+
+    closesocket(handle->socket);
+    delete handle;
+    openSockets[id - 1] = nullptr;
+}
+
 static void SocketModuleCleanup()
 {
     for (auto handle : openSockets)
@@ -238,6 +397,15 @@ static void SocketModuleCleanup()
         }
     }
     openSockets.clear();
+    waitingSockets = 0;
+
+#ifdef __linux__
+    if (reactorFd != -1)
+    {
+        close(reactorFd);
+        reactorFd = -1;
+    }
+#endif
 
 #ifdef _WIN32
     if (wsaInitialized)
@@ -270,6 +438,11 @@ int native_socket_init(Interpreter *vm, int argCount, Value *args)
 
 int native_socket_quit(Interpreter *vm, int argCount, Value *args)
 {
+    for (auto handle : openSockets)
+    {
+        if (handle)
+            wakeWaiter(vm, handle, vm->makeNil());
+    }
     SocketModuleCleanup();
     return 0;
 }
@@ -304,28 +477,28 @@ int native_socket_http_get(Interpreter *vm, int argCount, Value *args)
         Value val;
 
         // 1. Headers
-        if (options->table.get(vm->makeString("headers").asString(), &val))
+        if (options->table.get(vm->makeString("headers"), &val))
         {
             if (val.isMap())
                 customHeaders = extractHeaders(vm, val);
         }
 
         // 2. Params
-        if (options->table.get(vm->makeString("params").asString(), &val))
+        if (options->table.get(vm->makeString("params"), &val))
         {
             if (val.isMap())
                 queryParams = buildQueryString(vm, val);
         }
 
         // 3. Timeout
-        if (options->table.get(vm->makeString("timeout").asString(), &val))
+        if (options->table.get(vm->makeString("timeout"), &val))
         {
             if (val.isInt())
                 timeout = val.asInt();
         }
 
         // 4. User Agent Explícito
-        if (options->table.get(vm->makeString("user_agent").asString(), &val))
+        if (options->table.get(vm->makeString("user_agent"), &val))
         {
             if (val.isString())
                 userAgent = val.asStringChars();
@@ -449,20 +622,20 @@ int native_socket_http_get(Interpreter *vm, int argCount, Value *args)
     Value result = vm->makeMap();
     MapInstance *map = result.asMap();
 
-    map->table.set(vm->makeString("status_code").asString(), vm->makeInt(httpResp.statusCode));
-    map->table.set(vm->makeString("status_text").asString(), vm->makeString(httpResp.statusText.c_str()));
-    map->table.set(vm->makeString("body").asString(), vm->makeString(httpResp.body.c_str()));
-    map->table.set(vm->makeString("success").asString(), vm->makeBool(httpResp.success));
-    map->table.set(vm->makeString("url").asString(), vm->makeString(url.c_str()));
-    map->table.set(vm->makeString("received").asString(), vm->makeInt(response.length()));
+    map->table.set(vm->makeString("status_code"), vm->makeInt(httpResp.statusCode));
+    map->table.set(vm->makeString("status_text"), vm->makeString(httpResp.statusText.c_str()));
+    map->table.set(vm->makeString("body"), vm->makeString(httpResp.body.c_str()));
+    map->table.set(vm->makeString("success"), vm->makeBool(httpResp.success));
+    map->table.set(vm->makeString("url"), vm->makeString(url.c_str()));
+    map->table.set(vm->makeString("received"), vm->makeInt(response.length()));
 
     Value headersMap = vm->makeMap();
     MapInstance *headers = headersMap.asMap();
     for (const auto &h : httpResp.headers)
     {
-        headers->table.set(vm->makeString(h.first.c_str()).asString(), vm->makeString(h.second.c_str()));
+        headers->table.set(vm->makeString(h.first.c_str()), vm->makeString(h.second.c_str()));
     }
-    map->table.set(vm->makeString("headers").asString(), headersMap);
+    map->table.set(vm->makeString("headers"), headersMap);
 
     vm->push(result);
     return 1;
@@ -504,11 +677,11 @@ static std::string serializeJson(Interpreter *vm, Value value)
         std::string json = "{";
         MapInstance *map = value.asMap();
         bool first = true;
-        map->table.forEach([&](String *k, Value v)
+        map->table.forEach([&](Value k, Value v)
                            {
             if (!first) json += ",";
             first = false;
-            json += "\"" + std::string(k->chars()) + "\":" + serializeJson(vm, v); });
+            json += "\"" + mapKeyText(k) + "\":" + serializeJson(vm, v); });
         json += "}";
         return json;
     }
@@ -555,14 +728,14 @@ int native_socket_http_post(Interpreter *vm, int argCount, Value *args)
         Value val;
 
         // 1. Headers
-        if (options->table.get(vm->makeString("headers").asString(), &val))
+        if (options->table.get(vm->makeString("headers"), &val))
         {
             if (val.isMap())
                 customHeaders = extractHeaders(vm, val);
         }
 
         // 2. Data (Raw String ou Form Map)
-        if (options->table.get(vm->makeString("data").asString(), &val))
+        if (options->table.get(vm->makeString("data"), &val))
         {
             if (val.isString())
             {
@@ -575,7 +748,7 @@ int native_socket_http_post(Interpreter *vm, int argCount, Value *args)
         }
 
         // 3. JSON (Auto-serialize) - TEM PRIORIDADE SOBRE 'data'
-        if (options->table.get(vm->makeString("json").asString(), &val))
+        if (options->table.get(vm->makeString("json"), &val))
         {
             //   serializa   JSON
             postData = serializeJson(vm, val);
@@ -583,14 +756,14 @@ int native_socket_http_post(Interpreter *vm, int argCount, Value *args)
         }
 
         // 4. Timeout
-        if (options->table.get(vm->makeString("timeout").asString(), &val))
+        if (options->table.get(vm->makeString("timeout"), &val))
         {
             if (val.isInt())
                 timeout = val.asInt();
         }
 
         // 5. User Agent Explícito
-        if (options->table.get(vm->makeString("user_agent").asString(), &val))
+        if (options->table.get(vm->makeString("user_agent"), &val))
         {
             if (val.isString())
                 userAgent = val.asStringChars();
@@ -717,19 +890,19 @@ int native_socket_http_post(Interpreter *vm, int argCount, Value *args)
     Value result = vm->makeMap();
     MapInstance *map = result.asMap();
 
-    map->table.set(vm->makeString("status_code").asString(), vm->makeInt(httpResp.statusCode));
-    map->table.set(vm->makeString("status_text").asString(), vm->makeString(httpResp.statusText.c_str()));
-    map->table.set(vm->makeString("body").asString(), vm->makeString(httpResp.body.c_str()));
-    map->table.set(vm->makeString("success").asString(), vm->makeBool(httpResp.success));
-    map->table.set(vm->makeString("url").asString(), vm->makeString(url.c_str()));
+    map->table.set(vm->makeString("status_code"), vm->makeInt(httpResp.statusCode));
+    map->table.set(vm->makeString("status_text"), vm->makeString(httpResp.statusText.c_str()));
+    map->table.set(vm->makeString("body"), vm->makeString(httpResp.body.c_str()));
+    map->table.set(vm->makeString("success"), vm->makeBool(httpResp.success));
+    map->table.set(vm->makeString("url"), vm->makeString(url.c_str()));
 
     Value headersMap = vm->makeMap();
     MapInstance *headers = headersMap.asMap();
     for (const auto &h : httpResp.headers)
     {
-        headers->table.set(vm->makeString(h.first.c_str()).asString(), vm->makeString(h.second.c_str()));
+        headers->table.set(vm->makeString(h.first.c_str()), vm->makeString(h.second.c_str()));
     }
-    map->table.set(vm->makeString("headers").asString(), headersMap);
+    map->table.set(vm->makeString("headers"), headersMap);
 
     vm->push(result);
 
@@ -1003,6 +1176,42 @@ int native_socket_tcp_listen(Interpreter *vm, int argCount, Value *args)
     return 1;
 }
 
+// false se o accept bloquearia; senão result = id do cliente (ou nil)
+static bool tryAccept(Interpreter *vm, SocketHandle *serverHandle, Value *result)
+{
+    sockaddr_in clientAddr = {0};
+    socklen_t addrLen = sizeof(clientAddr);
+
+    SOCKET clientSock = accept(serverHandle->socket, (sockaddr *)&clientAddr, &addrLen);
+
+    if (clientSock == INVALID_SOCKET)
+    {
+        if (wouldBlock())
+            return false;
+        *result = vm->makeNil();
+        return true;
+    }
+
+    SocketHandle *clientHandle = new SocketHandle();
+    clientHandle->socket = clientSock;
+    clientHandle->type = SocketType::TCP_CLIENT;
+    clientHandle->isBlocking = true;
+    clientHandle->isConnected = true;
+    clientHandle->port = ntohs(clientAddr.sin_port);
+    clientHandle->host = inet_ntoa(clientAddr.sin_addr);
+
+    // Clientes de um servidor async herdam o modo
+    if (serverHandle->isAsync && setSocketBlocking(clientSock, false))
+    {
+        clientHandle->isBlocking = false;
+        clientHandle->isAsync = true;
+    }
+
+    openSockets.push_back(clientHandle);
+    *result = vm->makeInt(nextSocketId++);
+    return true;
+}
+
 int native_socket_tcp_accept(Interpreter *vm, int argCount, Value *args)
 {
     if (argCount < 1 || !args[0].isInt())
@@ -1020,35 +1229,15 @@ int native_socket_tcp_accept(Interpreter *vm, int argCount, Value *args)
         return 0;
     }
 
-    sockaddr_in clientAddr = {0};
-    socklen_t addrLen = sizeof(clientAddr);
-
-    SOCKET clientSock = accept(serverHandle->socket, (sockaddr *)&clientAddr, &addrLen);
-
-    if (clientSock == INVALID_SOCKET)
+    Value result;
+    if (!tryAccept(vm, serverHandle, &result))
     {
-#ifdef _WIN32
-        int err = WSAGetLastError();
-        if (err == WSAEWOULDBLOCK)
-            return 0;
-#else
-        if (errno == EWOULDBLOCK || errno == EAGAIN)
-            return 0;
-#endif
+        if (serverHandle->isAsync && vm->canSuspendFiber())
+            return suspendOnSocket(vm, id, serverHandle, IOWait::ACCEPT, 0, 0, vm->makeNil());
         return 0;
     }
 
-    SocketHandle *clientHandle = new SocketHandle();
-    clientHandle->socket = clientSock;
-    clientHandle->type = SocketType::TCP_CLIENT;
-    clientHandle->isBlocking = true;
-    clientHandle->isConnected = true;
-    clientHandle->port = ntohs(clientAddr.sin_port);
-    clientHandle->host = inet_ntoa(clientAddr.sin_addr);
-
-    openSockets.push_back(clientHandle);
-    vm->push(vm->makeInt(nextSocketId++));
-
+    vm->push(result);
     return 1;
 }
 
@@ -1056,12 +1245,13 @@ int native_socket_tcp_connect(Interpreter *vm, int argCount, Value *args)
 {
     if (argCount < 2 || !args[0].isString() || !args[1].isInt())
     {
-        vm->runtimeError("tcp_connect expects (host, port)");
+        vm->runtimeError("tcp_connect expects (host, port, [async])");
         return 0;
     }
 
     const char *host = args[0].asStringChars();
     int port = args[1].asInt();
+    bool async = argCount >= 3 && args[2].isBool() && args[2].asBool();
 
     struct hostent *he = gethostbyname(host);
     if (!he)
@@ -1082,8 +1272,13 @@ int native_socket_tcp_connect(Interpreter *vm, int argCount, Value *args)
     addr.sin_port = htons(port);
     memcpy(&addr.sin_addr, he->h_addr_list[0], he->h_length);
 
+    if (async && !setSocketBlocking(sock, false))
+        async = false;
+
+    bool pending = false;
     if (connect(sock, (sockaddr *)&addr, sizeof(addr)) == SOCKET_ERROR)
     {
+        pending = true;
 #ifdef _WIN32
         int err = WSAGetLastError();
         if (err != WSAEWOULDBLOCK)
@@ -1105,14 +1300,23 @@ int native_socket_tcp_connect(Interpreter *vm, int argCount, Value *args)
     SocketHandle *handle = new SocketHandle();
     handle->socket = sock;
     handle->type = SocketType::TCP_CLIENT;
-    handle->isBlocking = true;
+    handle->isBlocking = !async;
+    handle->isAsync = async;
     handle->isConnected = true;
     handle->port = port;
     handle->host = host;
 
     openSockets.push_back(handle);
-    vm->push(vm->makeInt(nextSocketId++));
+    int id = nextSocketId++;
 
+    // Ligação em curso: a fiber acorda com o id (ou nil se falhar)
+    if (async && pending && vm->canSuspendFiber())
+    {
+        handle->isConnected = false;
+        return suspendOnSocket(vm, id, handle, IOWait::CONNECT, 0, 0, vm->makeNil());
+    }
+
+    vm->push(vm->makeInt(id));
     return 1;
 }
 
@@ -1180,30 +1384,48 @@ int native_socket_set_blocking(Interpreter *vm, int argCount, Value *args)
 
     SocketHandle *handle = openSockets[id - 1];
 
-#ifdef _WIN32
-    u_long mode = blocking ? 0 : 1;
-    if (ioctlsocket(handle->socket, FIONBIO, &mode) != 0)
+    if (!setSocketBlocking(handle->socket, blocking))
     {
         vm->push(vm->makeBool(false));
         return 1;
     }
-#else
-    int flags = fcntl(handle->socket, F_GETFL, 0);
-    if (flags == -1)
+
+    handle->isBlocking = blocking;
+    if (blocking)
+        handle->isAsync = false;
+    vm->push(vm->makeBool(true));
+    return 1;
+}
+
+// set_async(id, true): não bloqueante, mas accept/receive suspendem a
+// fiber em vez de devolver nil; o resto do processo continua a correr
+int native_socket_set_async(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount < 2 || !args[0].isInt() || !args[1].isBool())
     {
         vm->push(vm->makeBool(false));
         return 1;
     }
 
-    flags = blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK);
-    if (fcntl(handle->socket, F_SETFL, flags) != 0)
+    int id = args[0].asInt();
+    bool async = args[1].asBool();
+
+    if (id <= 0 || id > openSockets.size() || !openSockets[id - 1])
     {
         vm->push(vm->makeBool(false));
         return 1;
     }
-#endif
 
-    handle->isBlocking = blocking;
+    SocketHandle *handle = openSockets[id - 1];
+    if (async && !setSocketBlocking(handle->socket, false))
+    {
+        vm->push(vm->makeBool(false));
+        return 1;
+    }
+
+    if (async)
+        handle->isBlocking = false;
+    handle->isAsync = async;
     vm->push(vm->makeBool(true));
     return 1;
 }
@@ -1242,6 +1464,43 @@ int native_socket_set_nodelay(Interpreter *vm, int argCount, Value *args)
     return 1;
 }
 
+// Bytes enviados, 0 se bloquearia, -1 em erro
+static int trySend(SocketHandle *handle, const void *data, int len)
+{
+    int sent = send(handle->socket, (const char *)data, len, 0);
+
+    if (sent == SOCKET_ERROR)
+    {
+        if (wouldBlock())
+            return 0;
+        handle->isConnected = false;
+        return -1;
+    }
+    return sent;
+}
+
+// (id, buffer, ...) de um socket TCP; nullptr se os args não servem
+static SocketHandle *streamSocketArg(Interpreter *vm, int argCount, Value *args, const char *name)
+{
+    if (argCount < 2 || !args[0].isInt() || !args[1].isBuffer())
+    {
+        vm->runtimeError("%s expects (socket, buffer, [offset], [length])", name);
+        return nullptr;
+    }
+
+    int id = args[0].asInt();
+    if (id <= 0 || id > openSockets.size() || !openSockets[id - 1])
+        return nullptr;
+
+    SocketHandle *handle = openSockets[id - 1];
+    if (handle->type == SocketType::UDP)
+    {
+        vm->runtimeError("%s needs a TCP socket", name);
+        return nullptr;
+    }
+    return handle;
+}
+
 int native_socket_send(Interpreter *vm, int argCount, Value *args)
 {
     if (argCount < 2 || !args[0].isInt() || !args[1].isString())
@@ -1274,34 +1533,74 @@ int native_socket_send(Interpreter *vm, int argCount, Value *args)
 
     const char *data = args[1].asStringChars();
     int len = args[1].asString()->length();
-    int sent = send(handle->socket, data, len, 0);
 
-    if (sent == SOCKET_ERROR)
+    vm->push(vm->makeInt(trySend(handle, data, len)));
+    return 1;
+}
+
+// send_buffer(id, buffer, [offset], [length]): envia a fatia sem cópias
+int native_socket_send_buffer(Interpreter *vm, int argCount, Value *args)
+{
+    SocketHandle *handle = streamSocketArg(vm, argCount, args, "send_buffer");
+    if (!handle)
     {
-#ifdef _WIN32
-        int err = WSAGetLastError();
-        if (err == WSAEWOULDBLOCK)
-        {
-            vm->push(vm->makeInt(0));
-            return 1;
-        }
-        handle->isConnected = false;
-#else
-        if (errno == EWOULDBLOCK || errno == EAGAIN)
-        {
-            vm->push(vm->makeInt(0));
-            return 1;
-        }
-        handle->isConnected = false;
-#endif
         vm->push(vm->makeInt(-1));
         return 1;
     }
 
-    vm->push(vm->makeInt(sent));
+    if (!handle->isConnected)
+    {
+        vm->runtimeError("Socket not connected");
+        vm->push(vm->makeInt(-1));
+        return 1;
+    }
+
+    BufferInstance *buf = args[1].asBuffer();
+    int offset, length;
+    if (!buf->slice(argCount, args, 2, &offset, &length))
+    {
+        vm->runtimeError("send_buffer: invalid offset/length for buffer of %d bytes", buf->byteSize());
+        vm->push(vm->makeInt(-1));
+        return 1;
+    }
+
+    vm->push(vm->makeInt(trySend(handle, buf->data + offset, length)));
     return 1;
 }
 
+// recv direto para dst; false se bloquearia, received = 0 se fechou/erro
+static bool tryRecv(SocketHandle *handle, void *dst, int size, int *received)
+{
+    int n = recv(handle->socket, (char *)dst, size, 0);
+
+    if (n == SOCKET_ERROR)
+    {
+        if (wouldBlock())
+            return false;
+        n = 0;
+    }
+
+    if (n == 0)
+        handle->isConnected = false;
+
+    *received = n;
+    return true;
+}
+
+// false se o recv bloquearia; senão result = dados (nil se fechou/erro)
+static bool tryReceive(Interpreter *vm, SocketHandle *handle, int maxSize, Value *result)
+{
+    std::vector<char> buffer(maxSize);
+    int received;
+    if (!tryRecv(handle, buffer.data(), maxSize, &received))
+        return false;
+
+    // String de runtime com tamanho: aceita zeros e é recolhida pelo GC
+    *result = received > 0 ? vm->makeString(vm->newString(buffer.data(), received))
+                           : vm->makeNil();
+    return true;
+}
+
 int native_socket_receive(Interpreter *vm, int argCount, Value *args)
 {
     if (argCount < 1 || !args[0].isInt())
@@ -1329,39 +1628,56 @@ int native_socket_receive(Interpreter *vm, int argCount, Value *args)
         return 1;
     }
 
-    std::vector<char> buffer(maxSize);
-    int received = recv(handle->socket, buffer.data(), maxSize, 0);
+    Value result;
+    if (!tryReceive(vm, handle, maxSize, &result))
+    {
+        if (handle->isAsync && vm->canSuspendFiber())
+            return suspendOnSocket(vm, id, handle, IOWait::RECEIVE, 0, maxSize, vm->makeNil());
+        result = vm->makeNil();
+    }
 
-    if (received == SOCKET_ERROR)
+    vm->push(result);
+    return 1;
+}
+
+// receive_into(id, buffer, [offset], [length]): recv direto para o buffer.
+// Devolve os bytes lidos (0 se fechou), nil se bloquearia.
+int native_socket_receive_into(Interpreter *vm, int argCount, Value *args)
+{
+    SocketHandle *handle = streamSocketArg(vm, argCount, args, "receive_into");
+    if (!handle)
     {
-#ifdef _WIN32
-        int err = WSAGetLastError();
-        if (err == WSAEWOULDBLOCK)
-        {
-            vm->push(vm->makeNil());
-            return 1;
-        }
-        handle->isConnected = false;
-#else
-        if (errno == EWOULDBLOCK || errno == EAGAIN)
-        {
-            vm->push(vm->makeNil());
-            return 1;
-        }
-        handle->isConnected = false;
-#endif
         vm->push(vm->makeNil());
         return 1;
     }
 
-    if (received == 0)
+    BufferInstance *buf = args[1].asBuffer();
+    int offset, length;
+    if (!buf->slice(argCount, args, 2, &offset, &length))
     {
-        handle->isConnected = false;
+        vm->runtimeError("receive_into: invalid offset/length for buffer of %d bytes", buf->byteSize());
         vm->push(vm->makeNil());
         return 1;
     }
 
-    vm->push(vm->makeString(std::string(buffer.data(), received).c_str()));
+    if (length == 0)
+    {
+        vm->push(vm->makeInt(0));
+        return 1;
+    }
+
+    int received;
+    if (!tryRecv(handle, buf->data + offset, length, &received))
+    {
+        // O buffer fica como placeholder: a stack da fiber mantém-no vivo
+        if (handle->isAsync && vm->canSuspendFiber())
+            return suspendOnSocket(vm, args[0].asInt(), handle, IOWait::RECEIVE_INTO,
+                                   offset, length, args[1]);
+        vm->push(vm->makeNil());
+        return 1;
+    }
+
+    vm->push(vm->makeInt(received));
     return 1;
 }
 
@@ -1472,9 +1788,9 @@ int native_socket_recvfrom(Interpreter *vm, int argCount, Value *args)
 
     Value result = vm->makeMap();
     MapInstance *map = result.asMap();
-    map->table.set(vm->makeString("data").asString(), vm->makeString(std::string(buffer.data(), received).c_str()));
-    map->table.set(vm->makeString("host").asString(), vm->makeString(inet_ntoa(fromAddr.sin_addr)));
-    map->table.set(vm->makeString("port").asString(), vm->makeInt(ntohs(fromAddr.sin_port)));
+    map->table.set(vm->makeString("data"), vm->makeString(std::string(buffer.data(), received).c_str()));
+    map->table.set(vm->makeString("host"), vm->makeString(inet_ntoa(fromAddr.sin_addr)));
+    map->table.set(vm->makeString("port"), vm->makeInt(ntohs(fromAddr.sin_port)));
 
     vm->push(result);
     return 1;
@@ -1507,13 +1823,14 @@ int native_socket_info(Interpreter *vm, int argCount, Value *args)
     else if (handle->type == SocketType::UDP)
         typeStr = "udp";
 
-    map->table.set(vm->makeString("type").asString(), vm->makeString(typeStr));
-    map->table.set(vm->makeString("port").asString(), vm->makeInt(handle->port));
-    map->table.set(vm->makeString("blocking").asString(), vm->makeBool(handle->isBlocking));
-    map->table.set(vm->makeString("connected").asString(), vm->makeBool(handle->isConnected));
+    map->table.set(vm->makeString("type"), vm->makeString(typeStr));
+    map->table.set(vm->makeString("port"), vm->makeInt(handle->port));
+    map->table.set(vm->makeString("blocking"), vm->makeBool(handle->isBlocking));
+    map->table.set(vm->makeString("async"), vm->makeBool(handle->isAsync));
+    map->table.set(vm->makeString("connected"), vm->makeBool(handle->isConnected));
 
     if (!handle->host.empty())
-        map->table.set(vm->makeString("host").asString(), vm->makeString(handle->host.c_str()));
+        map->table.set(vm->makeString("host"), vm->makeString(handle->host.c_str()));
 
     vm->push(result);
     return 1;
@@ -1534,13 +1851,7 @@ int native_socket_close(Interpreter *vm, int argCount, Value *args)
         return 1;
     }
 
-    SocketHandle *handle = openSockets[id - 1];
-    if (handle->type != SocketType::UDP)
-        shutdown(handle->socket, SHUT_RDWR);
-
-    closesocket(handle->socket);
-    delete handle;
-    openSockets[id - 1] = nullptr;
+    closeHandle(vm, id);
 
     vm->push(vm->makeBool(true));
     return 1;
@@ -1566,6 +1877,137 @@ int native_socket_is_connected(Interpreter *vm, int argCount, Value *args)
     return 1;
 }
 
+// Fim de connect async: SO_ERROR diz se ligou
+static bool finishConnect(SocketHandle *handle)
+{
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (getsockopt(handle->socket, SOL_SOCKET, SO_ERROR, (char *)&err, &len) != 0 || err != 0)
+        return false;
+    handle->isConnected = true;
+    return true;
+}
+
+// Socket pronto: repete a operação e entrega o resultado à fiber
+static void completeWait(Interpreter *vm, int id)
+{
+    if (id <= 0 || id > (int)openSockets.size() || !openSockets[id - 1])
+        return;
+
+    SocketHandle *handle = openSockets[id - 1];
+    Value result = vm->makeNil();
+    bool done = true;
+    bool failed = false;
+
+    switch (handle->waitOp)
+    {
+    case IOWait::ACCEPT:
+        done = tryAccept(vm, handle, &result);
+        break;
+    case IOWait::RECEIVE:
+        // Sem ninguém à espera os dados ficam no socket
+        if (!vm->waitingFiber(handle->waiter))
+        {
+            wakeWaiter(vm, handle, result);
+            return;
+        }
+        done = tryReceive(vm, handle, handle->waitSize, &result);
+        break;
+    case IOWait::RECEIVE_INTO:
+    {
+        // O buffer é o placeholder no topo da stack da fiber
+        Fiber *fiber = vm->waitingFiber(handle->waiter);
+        if (!fiber)
+        {
+            wakeWaiter(vm, handle, result);
+            return;
+        }
+
+        BufferInstance *buf = fiber->stackTop[-1].asBuffer();
+        int size = handle->waitSize;
+        if (handle->waitOffset + size > buf->byteSize())
+            size = buf->byteSize() - handle->waitOffset;
+
+        int received = 0;
+        done = size <= 0 || tryRecv(handle, buf->data + handle->waitOffset, size, &received);
+        result = vm->makeInt(received);
+        break;
+    }
+    case IOWait::CONNECT:
+        failed = !finishConnect(handle);
+        if (!failed)
+            result = vm->makeInt(id);
+        break;
+    default:
+        return;
+    }
+
+    // Acordou sem nada para ler: volta a armar
+    if (!done)
+    {
+        if (!reactorWatch(id, handle))
+            wakeWaiter(vm, handle, vm->makeNil());
+        return;
+    }
+
+    FiberTicket waiter = handle->waiter;
+    handle->waitOp = IOWait::NONE;
+    handle->waiter = FiberTicket();
+    waitingSockets--;
+
+    bool delivered = vm->resumeFiber(waiter, result);
+
+    // O processo morreu entretanto: ninguém fica com o cliente aceite
+    if (!delivered && handle->type == SocketType::TCP_SERVER && result.isInt())
+        closeHandle(vm, result.asInt());
+
+    if (failed)
+        closeHandle(vm, id);
+}
+
+void Interpreter::pollSockets()
+{
+    if (waitingSockets == 0)
+        return;
+
+#ifdef __linux__
+    epoll_event events[64];
+    int count = epoll_wait(reactorFd, events, 64, 0);
+    for (int i = 0; i < count; i++)
+        completeWait(this, (int)events[i].data.u32);
+#else
+    std::vector<pollfd> fds;
+    std::vector<int> ids;
+    for (size_t i = 0; i < openSockets.size(); i++)
+    {
+        SocketHandle *handle = openSockets[i];
+        if (!handle || handle->waitOp == IOWait::NONE)
+            continue;
+
+        pollfd pfd;
+        pfd.fd = handle->socket;
+        pfd.events = handle->waitOp == IOWait::CONNECT ? POLLOUT : POLLIN;
+        pfd.revents = 0;
+        fds.push_back(pfd);
+        ids.push_back((int)i + 1);
+    }
+
+#ifdef _WIN32
+    int count = WSAPoll(fds.data(), (ULONG)fds.size(), 0);
+#else
+    int count = poll(fds.data(), (nfds_t)fds.size(), 0);
+#endif
+    if (count <= 0)
+        return;
+
+    for (size_t i = 0; i < fds.size(); i++)
+    {
+        if (fds[i].revents)
+            completeWait(this, ids[i]);
+    }
+#endif
+}
+
 // No registerSocket():
 
 void Interpreter::registerSocket()
@@ -1583,12 +2025,14 @@ void Interpreter::registerSocket()
 
         .addFunction("tcp_listen", native_socket_tcp_listen, -1)
         .addFunction("tcp_accept", native_socket_tcp_accept, 1)
-        .addFunction("tcp_connect", native_socket_tcp_connect, 2)
+        .addFunction("tcp_connect", native_socket_tcp_connect, -1)
 
         .addFunction("udp_create", native_socket_udp_create, 1)
 
         .addFunction("send", native_socket_send, 2)
         .addFunction("receive", native_socket_receive, -1)
+        .addFunction("send_buffer", native_socket_send_buffer, -1)
+        .addFunction("receive_into", native_socket_receive_into, -1)
         .addFunction("sendto", native_socket_sendto, 4)
         .addFunction("recvfrom", native_socket_recvfrom, -1)
 
@@ -1596,6 +2040,7 @@ void Interpreter::registerSocket()
 
         .addFunction("set_blocking", native_socket_set_blocking, 2)
         .addFunction("set_nodelay", native_socket_set_nodelay, 2)
+        .addFunction("set_async", native_socket_set_async, 2)
 
         // HTTP Utilities (estilo requests com properties)
         .addFunction("http_get", native_socket_http_get, -1)
@@ -1691,4 +2136,25 @@ socket.download_file("http://example.com/file.zip", "./file.zip", {
 if socket.ping("google.com", 443, 5):
     print("Host alcançável!")
 
+# Sockets async: accept/receive/connect suspendem só a fiber que chamou,
+# os outros processos continuam a correr e o reactor acorda-a em update()
+process server(port)
+{
+    var s = socket.tcp_listen(port);
+    socket.set_async(s, true);
+    var c = socket.tcp_accept(s);          // clientes herdam o modo async
+    var msg = socket.receive(c, 1024);     // nil quando o outro lado fecha
+    socket.send(c, "pong:" + msg);
+    socket.close(c);                       // close acorda quem espera com nil
+    socket.close(s);
+}
+
+process client(port)
+{
+    var c = socket.tcp_connect("127.0.0.1", port, true);   // nil se falhar
+    socket.send(c, "ping");
+    print(socket.receive(c, 1024));
+    socket.close(c);
+}
+
 */
\ No newline at end of file
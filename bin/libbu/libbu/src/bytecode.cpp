@@ -0,0 +1,748 @@
+#include "interpreter.hpp"
+#include "compiler.hpp"
+#include "opcode.hpp"
+#include "platform.hpp"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// ============================================
+// BYTECODE CACHE (.buc)
+// ============================================
+// Layout (endianness da máquina: é um cache local, não formato de troca):
+//   header | plugins | includes | globals | functions | structs | classes | processes
+// Os ids (funções, classes, structs, processes) são índices nas tabelas da VM,
+// por isso o load recria tudo pela mesma ordem depois de um reset().
+// Ids nativos (natives, native classes/structs, módulos) dependem do que o host
+// registou: environmentHash() invalida o cache se isso mudar.
+
+static const uint32 BYTECODE_MAGIC = 0x43425542; // "BUBC"
+static const uint32 NULL_STRING = 0xFFFFFFFFu;
+
+struct BytecodeHeader
+{
+  uint32 magic;
+  uint32 version;
+  uint32 valueSize; // 16 (tag + union) ou 8 (NaN-boxing)
+  uint32 mainProcess;
+  uint64 sourceSize;
+  uint64 sourceHash;
+  uint64 envHash;
+  uint64 payloadSize;
+};
+
+struct BytecodeWriter
+{
+  std::vector<uint8> data;
+
+  void bytes(const void *p, size_t n)
+  {
+    const uint8 *b = (const uint8 *)p;
+    data.insert(data.end(), b, b + n);
+  }
+  void u8(uint8 v) { data.push_back(v); }
+  void u32(uint32 v) { bytes(&v, sizeof(v)); }
+  void i32(int v) { bytes(&v, sizeof(v)); }
+  void u64(uint64 v) { bytes(&v, sizeof(v)); }
+  void f64(double v) { bytes(&v, sizeof(v)); }
+  void str(const char *s, size_t len)
+  {
+    u32((uint32)len);
+    bytes(s, len);
+  }
+  void str(const std::string &s) { str(s.c_str(), s.size()); }
+  void str(String *s)
+  {
+    if (!s)
+    {
+      u32(NULL_STRING);
+      return;
+    }
+    str(s->chars(), s->length());
+  }
+};
+
+struct BytecodeReader
+{
+  const uint8 *p;
+  const uint8 *end;
+  bool ok;
+
+  BytecodeReader(const void *data, size_t size)
+      : p((const uint8 *)data), end((const uint8 *)data + size), ok(true) {}
+
+  const uint8 *take(size_t n)
+  {
+    if (!ok || (size_t)(end - p) < n)
+    {
+      ok = false;
+      return nullptr;
+    }
+    const uint8 *at = p;
+    p += n;
+    return at;
+  }
+  void bytes(void *out, size_t n)
+  {
+    if (const uint8 *at = take(n))
+      std::memcpy(out, at, n);
+  }
+  uint8 u8()
+  {
+    uint8 v = 0;
+    bytes(&v, sizeof(v));
+    return v;
+  }
+  uint32 u32()
+  {
+    uint32 v = 0;
+    bytes(&v, sizeof(v));
+    return v;
+  }
+  int i32()
+  {
+    int v = 0;
+    bytes(&v, sizeof(v));
+    return v;
+  }
+  uint64 u64()
+  {
+    uint64 v = 0;
+    bytes(&v, sizeof(v));
+    return v;
+  }
+  double f64()
+  {
+    double v = 0;
+    bytes(&v, sizeof(v));
+    return v;
+  }
+  // Devolve false para string nula; 'len' fica com o tamanho
+  bool str(const char **out, uint32 *len)
+  {
+    *len = u32();
+    if (*len == NULL_STRING)
+      return false;
+    *out = (const char *)take(*len);
+    return *out != nullptr;
+  }
+  std::string stdstr()
+  {
+    const char *s = nullptr;
+    uint32 len = 0;
+    if (!str(&s, &len))
+      return std::string();
+    return std::string(s, len);
+  }
+  // Contagens absurdas = ficheiro corrompido
+  uint32 count(size_t minItemSize)
+  {
+    uint32 n = u32();
+    if (ok && (size_t)n * minItemSize > (size_t)(end - p))
+      ok = false;
+    return ok ? n : 0;
+  }
+};
+
+static bool writeValue(BytecodeWriter &w, const Value &v)
+{
+  ValueType type = v.getType();
+  w.u8((uint8)type);
+  switch (type)
+  {
+  case ValueType::DOUBLE:
+    w.f64(v.rawDouble());
+    return true;
+  case ValueType::STRING:
+    w.str(v.asString());
+    return true;
+  case ValueType::NIL:
+  case ValueType::BOOL:
+  case ValueType::BYTE:
+  case ValueType::INT:
+  case ValueType::UINT:
+  case ValueType::FLOAT:
+  case ValueType::FUNCTION:
+  case ValueType::NATIVE:
+  case ValueType::NATIVECLASS:
+  case ValueType::PROCESS:
+  case ValueType::STRUCT:
+  case ValueType::CLASS:
+  case ValueType::NATIVESTRUCT:
+  case ValueType::MODULEREFERENCE:
+    w.u32(v.rawPayload());
+    return true;
+  default:
+    return false; // objetos de runtime não vão para o cache
+  }
+}
+
+// O cache guarda sempre a forma genérica: o quickening é estado de runtime
+static void unquickenChunk(const Code *chunk, const Vector<Function *> &functions, std::vector<uint8> &out)
+{
+  out.assign(chunk->code, chunk->code + chunk->count);
+  for (size_t off = 0; off < chunk->count;)
+  {
+    out[off] = unquickenOpcode(out[off]);
+    int len = Compiler::instructionLength(chunk, off, functions);
+    if (len == 0)
+      break;
+    off += len;
+  }
+}
+
+static bool writeFunction(BytecodeWriter &w, Function *func, const Vector<Function *> &functions)
+{
+  w.str(func->name);
+  w.i32(func->arity);
+  w.u8(func->hasReturn ? 1 : 0);
+  w.i32(func->upvalueCount);
+  w.i32(func->cacheCount);
+
+  Code *chunk = func->chunk;
+  w.u32((uint32)chunk->count);
+  std::vector<uint8> code;
+  unquickenChunk(chunk, functions, code);
+  w.bytes(code.data(), code.size());
+  w.bytes(chunk->lines, chunk->count * sizeof(int));
+  w.u32((uint32)chunk->constants.size());
+  for (size_t i = 0; i < chunk->constants.size(); i++)
+  {
+    if (!writeValue(w, chunk->constants[i]))
+      return false;
+  }
+  return true;
+}
+
+static Value readValue(Interpreter *vm, BytecodeReader &r)
+{
+  ValueType type = (ValueType)r.u8();
+  switch (type)
+  {
+  case ValueType::DOUBLE:
+    return vm->makeDouble(r.f64());
+  case ValueType::STRING:
+  {
+    // O pool procura por C string: precisa do '\0' que o ficheiro não tem
+    std::string str = r.stdstr();
+    return vm->makeString(vm->createString(str.c_str(), (uint32)str.size()));
+  }
+  case ValueType::NIL:
+    r.u32();
+    return vm->makeNil();
+  case ValueType::BOOL:
+  case ValueType::BYTE:
+  case ValueType::INT:
+  case ValueType::UINT:
+  case ValueType::FLOAT:
+  case ValueType::FUNCTION:
+  case ValueType::NATIVE:
+  case ValueType::NATIVECLASS:
+  case ValueType::PROCESS:
+  case ValueType::STRUCT:
+  case ValueType::CLASS:
+  case ValueType::NATIVESTRUCT:
+  case ValueType::MODULEREFERENCE:
+    return Value::fromSmall(type, r.u32());
+  default:
+    r.ok = false;
+    return vm->makeNil();
+  }
+}
+
+// O nome já foi lido (addFunction/canRegisterFunction precisam dele)
+static void readFunctionBody(Interpreter *vm, BytecodeReader &r, Function *func)
+{
+  func->arity = r.i32();
+  func->hasReturn = r.u8() != 0;
+  func->upvalueCount = r.i32();
+  int cacheCount = r.i32();
+  if (cacheCount < 0 || cacheCount > 0xFFFF)
+  {
+    r.ok = false;
+    return;
+  }
+  for (int i = 0; i < cacheCount; i++)
+  {
+    func->addInlineCache();
+  }
+
+  Code *chunk = func->chunk;
+  uint32 count = r.count(1 + sizeof(int));
+  chunk->reserve(count);
+  r.bytes(chunk->code, count);
+  r.bytes(chunk->lines, count * sizeof(int));
+  chunk->count = r.ok ? count : 0;
+
+  uint32 constants = r.count(1);
+  chunk->constants.reserve(constants);
+  for (uint32 i = 0; i < constants && r.ok; i++)
+  {
+    chunk->constants.push(readValue(vm, r));
+  }
+}
+
+// ============================================
+// AMBIENTE NATIVO
+// ============================================
+
+uint64 Interpreter::environmentHash()
+{
+  uint64 h = hashBytes64(nullptr, 0);
+  uint64 unordered = 0; // HashMaps: soma não depende da ordem de iteração
+
+  uint32 base = (uint32)globalsArray.size();
+  h = hashBytes64(&base, sizeof(base), h);
+
+  for (size_t i = 0; i < natives.size(); i++)
+  {
+    h = hashBytes64(natives[i].name->chars(), natives[i].name->length(), h);
+    h = hashBytes64(&natives[i].arity, sizeof(int), h);
+  }
+  for (size_t i = 0; i < nativeClasses.size(); i++)
+  {
+    h = hashBytes64(nativeClasses[i]->name->chars(), nativeClasses[i]->name->length(), h);
+  }
+  for (size_t i = 0; i < nativeStructs.size(); i++)
+  {
+    h = hashBytes64(nativeStructs[i]->name->chars(), nativeStructs[i]->name->length(), h);
+  }
+  for (size_t i = 0; i < modules.size(); i++)
+  {
+    ModuleDef *mod = modules[i];
+    uint64 functionSeed = hashBytes64(mod->name->chars(), mod->name->length());
+    uint64 constantSeed = hashBytes64("#", 1, functionSeed);
+    h = hashBytes64(&functionSeed, sizeof(functionSeed), h);
+    mod->functionNames.forEach([&](String *name, uint16 id)
+                               { unordered += hashBytes64(&id, sizeof(id), hashBytes64(name->chars(), name->length(), functionSeed)); });
+    mod->constantNames.forEach([&](String *name, uint16 id)
+                               { unordered += hashBytes64(&id, sizeof(id), hashBytes64(name->chars(), name->length(), constantSeed)); });
+  }
+  nativeGlobalIndices.forEach([&](String *name, uint16 index)
+                              { unordered += hashBytes64(&index, sizeof(index), hashBytes64(name->chars(), name->length())); });
+
+  return hashBytes64(&unordered, sizeof(unordered), h);
+}
+
+// ============================================
+// SAVE
+// ============================================
+
+bool Interpreter::saveBytecode(const char *cachePath, const char *source, size_t sourceSize,
+                               ProcessDef *mainProc)
+{
+  BytecodeWriter w;
+
+  const std::vector<std::string> &plugins = compiler->getRequiredPlugins();
+  w.u32((uint32)plugins.size());
+  for (size_t i = 0; i < plugins.size(); i++)
+  {
+    w.str(plugins[i]);
+  }
+
+  const std::vector<Compiler::IncludeDep> &includes = compiler->getIncludes();
+  w.u32((uint32)includes.size());
+  for (size_t i = 0; i < includes.size(); i++)
+  {
+    w.str(includes[i].name);
+    w.u64(includes[i].hash);
+  }
+
+  const std::vector<std::string> &globalNames = compiler->getGlobalIndexToName();
+  w.u32((uint32)globalNames.size());
+  for (size_t i = 0; i < globalNames.size(); i++)
+  {
+    w.str(globalNames[i]);
+  }
+
+  w.u32((uint32)functions.size());
+  for (size_t i = 0; i < functions.size(); i++)
+  {
+    if (!writeFunction(w, functions[i], functions))
+      return false;
+  }
+
+  w.u32((uint32)structs.size());
+  for (size_t i = 0; i < structs.size(); i++)
+  {
+    StructDef *def = structs[i];
+    w.str(def->name);
+    w.u8(def->argCount);
+    w.u32((uint32)def->names.count);
+    def->names.forEach([&](String *name, uint8 index)
+                       {
+      w.str(name);
+      w.u8(index); });
+  }
+
+  bool ok = true;
+  w.u32((uint32)classes.size());
+  for (size_t i = 0; i < classes.size(); i++)
+  {
+    ClassDef *def = classes[i];
+    w.str(def->name);
+    w.str(def->parent);
+    w.u8(def->inherited ? 1 : 0);
+    w.i32(def->fieldCount);
+    w.i32(def->superclass ? def->superclass->index : -1);
+    w.str(def->nativeSuperclass ? def->nativeSuperclass->name : nullptr);
+
+    w.u32((uint32)def->fieldNames.count);
+    def->fieldNames.forEach([&](String *name, uint8 index)
+                            {
+      w.str(name);
+      w.u8(index); });
+
+    w.u32((uint32)def->fieldDefaults.size());
+    for (size_t j = 0; j < def->fieldDefaults.size(); j++)
+    {
+      ok = ok && writeValue(w, def->fieldDefaults[j]);
+    }
+
+    w.u32((uint32)def->methods.count);
+    def->methods.forEach([&](String *, Function *method)
+                         { ok = ok && writeFunction(w, method, functions); });
+  }
+  if (!ok)
+    return false;
+
+  w.u32((uint32)processes.size());
+  for (size_t i = 0; i < processes.size(); i++)
+  {
+    ProcessDef *def = processes[i];
+    w.str(def->name);
+    w.i32(def->fibers[0].frames[0].func->index);
+    w.i32(def->totalFibers);
+    w.u32((uint32)def->argsNames.size());
+    for (size_t j = 0; j < def->argsNames.size(); j++)
+    {
+      w.u8(def->argsNames[j]);
+    }
+  }
+
+  BytecodeHeader header;
+  header.magic = BYTECODE_MAGIC;
+  header.version = BYTECODE_VERSION;
+  header.valueSize = (uint32)sizeof(Value);
+  header.mainProcess = (uint32)mainProc->index;
+  header.sourceSize = sourceSize;
+  header.sourceHash = hashBytes64(source, sourceSize);
+  header.envHash = environmentHash();
+  header.payloadSize = w.data.size();
+
+  // Escreve para .tmp e renomeia: um crash a meio nunca deixa um cache truncado
+  char tmpPath[512];
+  snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", cachePath);
+  FILE *f = fopen(tmpPath, "wb");
+  if (!f)
+    return false;
+  bool written = fwrite(&header, sizeof(header), 1, f) == 1 &&
+                 fwrite(w.data.data(), 1, w.data.size(), f) == w.data.size();
+  written = (fclose(f) == 0) && written;
+  if (!written)
+  {
+    OsFileDelete(tmpPath);
+    return false;
+  }
+  OsFileDelete(cachePath); // rename() no Windows não substitui
+  return rename(tmpPath, cachePath) == 0;
+}
+
+// ============================================
+// LOAD
+// ============================================
+
+ProcessDef *Interpreter::loadBytecode(const char *cachePath, const char *source, size_t sourceSize)
+{
+  size_t size = 0;
+  const void *data = OsMapFile(cachePath, &size);
+  if (!data)
+    return nullptr;
+
+  BytecodeReader r(data, size);
+  BytecodeHeader header;
+  r.bytes(&header, sizeof(header));
+
+  // 1. Validação (nada criado na VM até aqui)
+  bool valid = r.ok &&
+               header.magic == BYTECODE_MAGIC &&
+               header.version == BYTECODE_VERSION &&
+               header.valueSize == sizeof(Value) &&
+               header.payloadSize == size - sizeof(header) &&
+               header.sourceSize == sourceSize &&
+               header.sourceHash == hashBytes64(source, sourceSize);
+
+  // Plugins primeiro: registam natives que entram no environmentHash
+  uint32 pluginCount = valid ? r.count(4) : 0;
+  for (uint32 i = 0; i < pluginCount && valid; i++)
+  {
+    std::string name = r.stdstr();
+    if (!r.ok || (!containsModule(name.c_str()) && !loadPluginByName(name.c_str())))
+      valid = false;
+  }
+
+  uint32 includeCount = valid ? r.count(12) : 0;
+  for (uint32 i = 0; i < includeCount && valid; i++)
+  {
+    std::string name = r.stdstr();
+    uint64 hash = r.u64();
+    size_t includeSize = 0;
+    const char *includeSource = fileLoader ? fileLoader(name.c_str(), &includeSize, fileLoaderUserdata) : nullptr;
+    if (!r.ok || !includeSource || hashBytes64(includeSource, includeSize) != hash)
+      valid = false;
+  }
+
+  if (!valid || header.envHash != environmentHash())
+  {
+    OsUnmapFile(data, size);
+    return nullptr;
+  }
+
+  // 2. Recria as tabelas pela ordem original (ids iguais aos do compilador)
+  uint32 globalCount = r.count(4);
+  globalIndexToName_.clear();
+  globalIndexToName_.reserve(globalCount);
+  for (uint32 i = 0; i < globalCount && r.ok; i++)
+  {
+    std::string name = r.stdstr();
+    globalIndexToName_.push(createString(name.c_str(), (uint32)name.size()));
+  }
+
+  uint32 functionCount = r.count(4);
+  for (uint32 i = 0; i < functionCount && r.ok; i++)
+  {
+    std::string name = r.stdstr();
+    Function *func = addFunction(name.c_str(), 0);
+    if (!func)
+    {
+      r.ok = false;
+      break;
+    }
+    readFunctionBody(this, r, func);
+  }
+
+  uint32 structCount = r.count(4);
+  for (uint32 i = 0; i < structCount && r.ok; i++)
+  {
+    std::string name = r.stdstr();
+    StructDef *def = registerStruct(createString(name.c_str(), (uint32)name.size()));
+    if (!def)
+    {
+      r.ok = false;
+      break;
+    }
+    def->argCount = r.u8();
+    uint32 fieldCount = r.count(5);
+    for (uint32 j = 0; j < fieldCount && r.ok; j++)
+    {
+      std::string field = r.stdstr();
+      uint8 index = r.u8();
+      def->names.set(createString(field.c_str(), (uint32)field.size()), index);
+    }
+  }
+
+  uint32 classCount = r.count(4);
+  for (uint32 i = 0; i < classCount && r.ok; i++)
+  {
+    std::string name = r.stdstr();
+    ClassDef *def = registerClass(createString(name.c_str(), (uint32)name.size()));
+    if (!def)
+    {
+      r.ok = false;
+      break;
+    }
+
+    const char *s = nullptr;
+    uint32 len = 0;
+    if (r.str(&s, &len))
+    {
+      std::string parent(s, len);
+      def->parent = createString(parent.c_str(), len);
+    }
+    def->inherited = r.u8() != 0;
+    def->fieldCount = r.i32();
+
+    int superIndex = r.i32();
+    if (superIndex >= 0 && superIndex < (int)i)
+      def->superclass = classes[superIndex];
+    else if (superIndex != -1)
+      r.ok = false;
+
+    if (r.str(&s, &len))
+    {
+      std::string nativeName(s, len);
+      if (!tryGetNativeClassDef(nativeName.c_str(), &def->nativeSuperclass))
+        r.ok = false;
+    }
+
+    uint32 fieldCount = r.count(5);
+    for (uint32 j = 0; j < fieldCount && r.ok; j++)
+    {
+      std::string field = r.stdstr();
+      uint8 index = r.u8();
+      def->fieldNames.set(createString(field.c_str(), (uint32)field.size()), index);
+    }
+
+    uint32 defaultCount = r.count(1);
+    for (uint32 j = 0; j < defaultCount && r.ok; j++)
+    {
+      def->fieldDefaults.push(readValue(this, r));
+    }
+
+    uint32 methodCount = r.count(4);
+    for (uint32 j = 0; j < methodCount && r.ok; j++)
+    {
+      std::string methodName = r.stdstr();
+      Function *method = def->canRegisterFunction(createString(methodName.c_str(), (uint32)methodName.size()));
+      if (!method)
+      {
+        r.ok = false;
+        break;
+      }
+      addFunctionsClasses(method);
+      readFunctionBody(this, r, method);
+      if (methodName == "init")
+        def->constructor = method;
+    }
+  }
+
+  // Processes por último: addProcess inicializa a fiber 0 com o chunk já carregado
+  uint32 processCount = r.count(12);
+  for (uint32 i = 0; i < processCount && r.ok; i++)
+  {
+    std::string name = r.stdstr();
+    int funcIndex = r.i32();
+    int totalFibers = r.i32();
+    if (!r.ok || funcIndex < 0 || funcIndex >= (int)functions.size() || totalFibers < 1)
+    {
+      r.ok = false;
+      break;
+    }
+    ProcessDef *def = addProcess(name.c_str(), functions[funcIndex], totalFibers);
+    if (!def || def->index != (int)i)
+    {
+      r.ok = false;
+      break;
+    }
+    uint32 argCount = r.count(1);
+    for (uint32 j = 0; j < argCount && r.ok; j++)
+    {
+      def->argsNames.push(r.u8());
+    }
+    def->finalize();
+  }
+
+  bool complete = r.ok && r.p == r.end && header.mainProcess < processes.size();
+  OsUnmapFile(data, size);
+
+  if (!complete)
+  {
+    Warning("Bytecode cache '%s' is corrupted, recompiling", cachePath);
+    reset();
+    return nullptr;
+  }
+  return processes[header.mainProcess];
+}
+
+// ============================================
+// SCRIPTS EM FICHEIRO
+// ============================================
+
+// O script principal lê-se direto do disco (não pelo fileLoader, que só
+// serve os includes): a cache fica ao lado deste caminho exato.
+ProcessDef *Interpreter::loadScript(const char *path)
+{
+  reset();
+
+  int size = OsFileSize(path);
+  if (size < 0)
+  {
+    Error("Cannot open script '%s'", path);
+    return nullptr;
+  }
+
+  std::string source((size_t)size, '\0');
+  if (size > 0 && OsFileRead(path, &source[0], (size_t)size) != size)
+  {
+    Error("Cannot read script '%s'", path);
+    return nullptr;
+  }
+
+  // Caminho truncado seria a cache de outro ficheiro: sem cache
+  char cachePath[512];
+  int cacheLen = snprintf(cachePath, sizeof(cachePath), "%sc", path);
+  bool useCache = useBytecodeCache && cacheLen > 0 && cacheLen < (int)sizeof(cachePath);
+  if (useBytecodeCache && !useCache)
+  {
+    Warning("Script path too long for bytecode cache: '%s'", path);
+  }
+
+  ProcessDef *proc = nullptr;
+  if (useCache)
+  {
+    proc = loadBytecode(cachePath, source.data(), source.size());
+  }
+
+  if (!proc)
+  {
+    proc = compiler->compile(source);
+    if (!proc)
+    {
+      return nullptr;
+    }
+
+    const std::vector<std::string> &compilerMapping = compiler->getGlobalIndexToName();
+    globalIndexToName_.clear();
+    globalIndexToName_.reserve(compilerMapping.size());
+    for (size_t i = 0; i < compilerMapping.size(); i++)
+    {
+      globalIndexToName_.push(createString(compilerMapping[i].c_str()));
+    }
+
+    if (useCache &&
+        !saveBytecode(cachePath, source.data(), source.size(), proc))
+    {
+      Warning("Could not write bytecode cache '%s'", cachePath);
+    }
+  }
+
+  if (globalsArray.size() < globalIndexToName_.size())
+  {
+    globalsArray.resize(globalIndexToName_.size(), makeNil());
+  }
+
+  return proc;
+}
+
+bool Interpreter::runFile(const char *path, bool dump)
+{
+  ProcessDef *proc = loadScript(path);
+  if (!proc)
+  {
+    return false;
+  }
+
+  if (dump)
+  {
+    disassemble();
+  }
+
+  return startMainProcess(proc);
+}
+
+bool Interpreter::compileFile(const char *path, bool dump)
+{
+  ProcessDef *proc = loadScript(path);
+  if (!proc)
+  {
+    return false;
+  }
+
+  if (dump)
+  {
+    disassemble();
+  }
+
+  return !hasFatalError_;
+}
@@ -8,7 +8,7 @@ Code::Code(size_t capacity)
     code = (uint8 *)aAlloc(capacity * sizeof(uint8));
     lines = (int *)aAlloc(capacity * sizeof(int));
 
-    constants.reserve(1024);
+    constants.reserve(16); // cresce on demand; 1024 por função pesava no arranque
     m_frozen = false;
     nilIndex = -1;
     trueIndex = -1;
@@ -26,7 +26,7 @@ void Code::freeze()
 int Code::addConstant(Value value)
 {
     // 1. Tipos mutáveis - sempre  novo
-    switch (value.type)
+    switch (value.getType())
     {
         case ValueType::CLASSINSTANCE:
         case ValueType::NATIVECLASSINSTANCE:
@@ -43,7 +43,7 @@ int Code::addConstant(Value value)
     }
     
     // 2. Fast path para valores muito comuns
-    if (value.type == ValueType::NIL)
+    if (value.getType() == ValueType::NIL)
     {
         if (nilIndex == -1)
         {
@@ -53,7 +53,7 @@ int Code::addConstant(Value value)
         return nilIndex;
     }
     
-    if (value.type == ValueType::BOOL)
+    if (value.getType() == ValueType::BOOL)
     {
         if (value.asBool())
         {
@@ -76,12 +76,12 @@ int Code::addConstant(Value value)
     }
     
     // 3. Loop para outros tipos
-    if (value.type == ValueType::STRING)
+    if (value.getType() == ValueType::STRING)
     {
         String *str = value.asString();
         for (int i = 0; i < constants.size(); i++)
         {
-            if (constants[i].type == ValueType::STRING &&
+            if (constants[i].getType() == ValueType::STRING &&
                 constants[i].asString() == str)  
             {
                // Warning("Constant already exists");
@@ -89,11 +89,11 @@ int Code::addConstant(Value value)
             }
         }
     }
-    else if (value.type == ValueType::INT)
+    else if (value.getType() == ValueType::INT)
     {
         for (int i = 0; i < constants.size(); i++)
         {
-            if (constants[i].type == ValueType::INT &&
+            if (constants[i].getType() == ValueType::INT &&
                 constants[i].asInt() == value.asInt())
             {
               //  Warning("Constant already exists");
@@ -101,11 +101,11 @@ int Code::addConstant(Value value)
             }
         }
     }
-    else if (value.type == ValueType::DOUBLE)
+    else if (value.getType() == ValueType::DOUBLE)
     {
         for (int i = 0; i < constants.size(); i++)
         {
-            if (constants[i].type == ValueType::DOUBLE &&
+            if (constants[i].getType() == ValueType::DOUBLE &&
                 constants[i].asDouble() == value.asDouble())
             {
               //  Warning("Constant already exists");
@@ -113,19 +113,19 @@ int Code::addConstant(Value value)
             }
         }
     }
-    else if (value.type == ValueType::CLASS || 
-             value.type == ValueType::STRUCT || 
-             value.type == ValueType::NATIVE  || 
-             value.type == ValueType::FUNCTION ||
-             value.type == ValueType::NATIVECLASS || 
-             value.type == ValueType::PROCESS || 
-             value.type == ValueType::NATIVESTRUCT
+    else if (value.getType() == ValueType::CLASS || 
+             value.getType() == ValueType::STRUCT || 
+             value.getType() == ValueType::NATIVE  || 
+             value.getType() == ValueType::FUNCTION ||
+             value.getType() == ValueType::NATIVECLASS || 
+             value.getType() == ValueType::PROCESS || 
+             value.getType() == ValueType::NATIVESTRUCT
             )
     {
         for (int i = 0; i < constants.size(); i++)
         {
-            if (constants[i].type == value.type &&
-                constants[i].as.integer == value.as.integer)
+            if (constants[i].getType() == value.getType() &&
+                constants[i].rawInt() == value.rawInt())
             {
               // Warning("Constant already exists");
                 return i;
@@ -205,84 +205,84 @@ uint8 Code::operator[](size_t index)
     return code[index];
 }
 
-bool ValueEq::operator()(const Value &a, const Value &b) const
+// Número com valor inteiro que cabe num int? Então é essa a chave.
+static FORCE_INLINE bool integralKey(const Value &v, int *out)
 {
+    double d = v.asDouble();
+    if (d >= -2147483648.0 && d <= 2147483647.0 && d == (double)(int)d)
     {
-        if (a.type != b.type)
-            return false;
+        *out = (int)d;
+        return true;
+    }
+    return false;
+}
 
-        switch (a.type)
-        {
-        case ValueType::NIL:
-            return true;
+static FORCE_INLINE bool isIdentityKey(const Value &v)
+{
+    return v.isObject() || v.isPointer();
+}
 
-        case ValueType::BOOL:
-            return a.asBool() == b.asBool();
+bool ValueEq::equalSlow(const Value &a, const Value &b)
+{
+    if (a.isNumber() && b.isNumber())
+        return a.asDouble() == b.asDouble();
 
-        case ValueType::INT:
-            return a.asInt() == b.asInt();
+    if (a.getType() != b.getType())
+        return false;
 
-        case ValueType::DOUBLE:
-            return a.asDouble() == b.asDouble();
+    switch (a.getType())
+    {
+    case ValueType::NIL:
+        return true;
 
-        case ValueType::STRING:
-            return a.asString() == b.asString(); 
+    case ValueType::BOOL:
+        return a.asBool() == b.asBool();
 
-        case ValueType::CLASS:
-        case ValueType::STRUCT:
-        case ValueType::NATIVE:
-            return a.as.integer == b.as.integer;
+    case ValueType::STRING:
+        return StringEq{}(a.asString(), b.asString());
 
-        default:
-            return false;
-        }
+    default:
+        if (isIdentityKey(a))
+            return a.rawPointer() == b.rawPointer();
+        // ids (function, class, process, ...)
+        return a.rawPayload() == b.rawPayload();
     }
 }
 
-size_t ValueHasher::operator()(const Value &v) const
+size_t ValueHasher::hashSlow(const Value &v)
 {
+    if (v.isNumber())
     {
-        switch (v.type)
-        {
-        case ValueType::NIL:
-            return 0;
-        case ValueType::BOOL:
-            return v.asBool() ? 1 : 0;
+        int i;
+        if (integralKey(v, &i))
+            return mixInt((uint32)i);
 
-        case ValueType::INT:
-        {
-            // MurmurHash3 finalizer (mix bits)
-            uint32_t h = static_cast<uint32_t>(v.asInt());
-            h ^= h >> 16;
-            h *= 0x85ebca6b;
-            h ^= h >> 13;
-            h *= 0xc2b2ae35;
-            h ^= h >> 16;
-            return h;
-        }
+        // Reinterpret bits como uint64
+        double d = v.asDouble();
+        uint64_t bits;
+        memcpy(&bits, &d, sizeof(double));
+        bits ^= bits >> 33;
+        bits *= 0xff51afd7ed558ccdULL;
+        bits ^= bits >> 33;
+        bits *= 0xc4ceb9fe1a85ec53ULL;
+        bits ^= bits >> 33;
+        return static_cast<size_t>(bits);
+    }
 
-        case ValueType::DOUBLE:
+    switch (v.getType())
+    {
+    case ValueType::NIL:
+        return 0;
+    case ValueType::BOOL:
+        return v.asBool() ? 1 : 0;
+    case ValueType::STRING:
+        return v.asString()->hash;
+    default:
+        if (isIdentityKey(v))
         {
-            // Reinterpret bits como uint64
-            double d = v.asDouble();
-            uint64_t bits;
-            memcpy(&bits, &d, sizeof(double));
-            // Hash as uint64
-            bits ^= bits >> 33;
-            bits *= 0xff51afd7ed558ccdULL;
-            bits ^= bits >> 33;
-            bits *= 0xc4ceb9fe1a85ec53ULL;
-            bits ^= bits >> 33;
-            return static_cast<size_t>(bits);
-        }
-        case ValueType::STRING:
-            return v.asString()->hash;
-        case ValueType::CLASS:
-        case ValueType::STRUCT:
-        case ValueType::NATIVE:
-            return v.as.integer; // Id do objeto
-        default:
-            return 0; // Objetos não vão no cache
+            uint64_t p = (uint64_t)(uintptr_t)v.rawPointer();
+            return mixInt((uint32)(p >> 3) ^ (uint32)(p >> 35));
         }
+        return mixInt(v.rawPayload() ^ ((uint32)v.getType() << 24));
     }
-}
\ No newline at end of file
+}
@@ -204,6 +204,8 @@ ProcessDef *Compiler::compile(const std::string &source)
   stats.totalWarnings = 0;
   enclosingStack_.clear();
   declaredGlobals_.clear();
+  includes_.clear();
+  requiredPlugins_.clear();
   upvalueCount_ = 0;
   isProcess_ = true;  // Top-level code IS a process
 
@@ -274,6 +276,8 @@ ProcessDef *Compiler::compile(const std::string &source)
     return nullptr;
   }
 
+  optimizeChunk(function);
+
   currentProcess->finalize();
 
   importedModules.clear();
@@ -352,6 +356,8 @@ ProcessDef *Compiler::compileExpression(const std::string &source)
     return nullptr;
   }
 
+  optimizeChunk(function);
+
   //   currentProcess->totalFibers = numFibers_;
   // currentProcess->fibers =      (Fiber *)malloc(numFibers_ * sizeof(Fiber));
   currentProcess->finalize();
@@ -638,6 +644,17 @@ void Compiler::emitShort(uint16 value)
   emitByte(value & 0xFF);
 }
 
+// Reserva um inline cache na função atual (GET/SET_PROPERTY, INVOKE)
+void Compiler::emitCacheSlot()
+{
+  if (function->cacheCount >= 65535)
+  {
+    error("Too many property access sites in one function");
+    return;
+  }
+  emitShort(function->addInlineCache());
+}
+
 void Compiler::emitDiscard(uint8 count)
 {
   emitByte(OP_DISCARD);
@@ -252,7 +252,8 @@ void Compiler::number(bool canAssign)
 void Compiler::string(bool canAssign)
 {
     (void)canAssign;
-    emitConstant(vm_->makeString(previous.lexeme.c_str()));
+    emitConstant(vm_->makeString(vm_->createString(previous.lexeme.c_str())));
+    stringLiteralEnd_ = (int)currentChunk->count;
 }
 
 void Compiler::literal(bool canAssign)
@@ -305,19 +306,58 @@ void Compiler::unary(bool canAssign)
         return;
     }
 }
+// a + b + c ... (o '+' da esquerda já foi consumido). Somas normais até
+// aparecer um literal string; daí em diante os operandos ficam no stack e um
+// só OP_CONCAT junta tudo num buffer, em vez de uma String nova por '+'.
+// A ordem é a mesma (esquerda para a direita): "x" + 1 + 2 continua "x12".
+void Compiler::addChain()
+{
+    bool chain = stringLiteralEnd_ == (int)currentChunk->count;
+    int pending = 1; // valores no stack ainda por juntar
+
+    do
+    {
+        parsePrecedence((Precedence)(PREC_TERM + 1));
+        if (!chain && stringLiteralEnd_ == (int)currentChunk->count)
+            chain = true;
+
+        if (!chain)
+        {
+            emitByte(OP_ADD);
+            continue;
+        }
+
+        if (++pending == 255)
+        {
+            emitBytes(OP_CONCAT, (uint8)pending);
+            pending = 1;
+        }
+    } while (match(TOKEN_PLUS));
+
+    // Com dois operandos o OP_ADD já faz uma só concatenação (e é dobrado
+    // pelo peephole quando ambos são constantes)
+    if (pending == 2)
+        emitByte(OP_ADD);
+    else if (pending > 2)
+        emitBytes(OP_CONCAT, (uint8)pending);
+}
+
 void Compiler::binary(bool canAssign)
 {
     (void)canAssign;
     TokenType operatorType = previous.type;
     ParseRule *rule = getRule(operatorType);
 
+    if (operatorType == TOKEN_PLUS)
+    {
+        addChain();
+        return;
+    }
+
     parsePrecedence((Precedence)(rule->prec + 1));
 
     switch (operatorType)
     {
-    case TOKEN_PLUS:
-        emitByte(OP_ADD);
-        break;
     case TOKEN_MINUS:
         emitByte(OP_SUBTRACT);
         break;
@@ -457,7 +497,7 @@ void Compiler::mapLiteral(bool canAssign)
             if (match(TOKEN_IDENTIFIER))
             {
                 Token key = previous;
-                emitConstant(vm_->makeString(key.lexeme.c_str()));
+                emitConstant(vm_->makeString(vm_->createString(key.lexeme.c_str())));
                 consume(TOKEN_COLON, "Expect ':' after map key");
                 expression();
                 if (hadError)
@@ -466,7 +506,25 @@ void Compiler::mapLiteral(bool canAssign)
             else if (match(TOKEN_STRING))
             {
                 Token key = previous;
-                emitConstant(vm_->makeString(key.lexeme.c_str()));
+                emitConstant(vm_->makeString(vm_->createString(key.lexeme.c_str())));
+                consume(TOKEN_COLON, "Expect ':' after map key");
+                expression();
+                if (hadError)
+                    return;
+            }
+            else if (match(TOKEN_INT) || match(TOKEN_FLOAT))
+            {
+                number(false);
+                consume(TOKEN_COLON, "Expect ':' after map key");
+                expression();
+                if (hadError)
+                    return;
+            }
+            else if (match(TOKEN_LBRACKET))
+            {
+                // {[expr]: valor} - chave calculada
+                expression();
+                consume(TOKEN_RBRACKET, "Expect ']' after map key");
                 consume(TOKEN_COLON, "Expect ':' after map key");
                 expression();
                 if (hadError)
@@ -474,7 +532,7 @@ void Compiler::mapLiteral(bool canAssign)
             }
             else
             {
-                error("Expect identifier or string as map key");
+                error("Expect identifier, string, number or [expression] as map key");
                 break;
             }
 
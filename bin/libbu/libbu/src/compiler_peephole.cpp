@@ -0,0 +1,555 @@
+#include "compiler.hpp"
+#include "interpreter.hpp"
+#include "opcode.hpp"
+#include "value.hpp"
+#include <climits>
+
+// ============================================
+// PEEPHOLE
+// Passagem final sobre o Code de cada função: dobra constantes e funde
+// sequências quentes em superinstruções. O chunk é reescrito e os saltos
+// (relativos e os endereços absolutos do OP_TRY) são recalculados no fim.
+// Nunca funde por cima de um alvo de salto.
+// ============================================
+
+namespace
+{
+  struct PeepInstr
+  {
+    int newStart; // offset no código novo
+    int line;
+    uint8 op;
+    bool target; // a primeira instrução original era alvo de salto
+  };
+
+  struct PeepJump
+  {
+    int newStart;   // offset da instrução no código novo
+    int newEnd;     // ip depois da instrução (base dos saltos relativos)
+    int oldTarget;  // alvo no código original
+    int oldTarget2; // só OP_TRY (finally)
+    uint8 op;
+  };
+
+  FORCE_INLINE uint16 readShortAt(const uint8 *code, size_t offset)
+  {
+    return (uint16)((code[offset] << 8) | code[offset + 1]);
+  }
+
+  FORCE_INLINE bool isRelativeJump(uint8 op)
+  {
+    return op == OP_JUMP || op == OP_JUMP_IF_FALSE || op == OP_LOOP || op == OP_GOSUB ||
+           op == OP_LOCAL_LESS_CONST_JUMP || op == OP_LOCAL_LESS_LOCAL_JUMP;
+  }
+
+  FORCE_INLINE void writeShortAt(std::vector<uint8> &code, size_t offset, uint16 value)
+  {
+    code[offset] = (value >> 8) & 0xff;
+    code[offset + 1] = value & 0xff;
+  }
+
+  class Peephole
+  {
+  public:
+    Peephole(Interpreter *vm, const Vector<Function *> &functions, Code *chunk)
+        : vm_(vm), functions_(functions), chunk_(chunk) {}
+
+    bool run();
+
+  private:
+    int instructionLength(int offset) const;
+    bool scan();
+
+    void emit(int oldStart, int len);
+    void emitFused(const uint8 *bytes, int len, int oldTarget);
+
+    bool tailFree(size_t n, int oldStart) const;
+    const PeepInstr &tail(size_t fromEnd) const { return emitted_[emitted_.size() - 1 - fromEnd]; }
+    const uint8 *bytesOf(const PeepInstr &in) const { return &out_[in.newStart]; }
+    void rewind(size_t n);
+
+    bool foldConstants(uint8 op, int oldStart);
+    bool fuseAddLocals(int oldStart);
+    bool fuseLessJump(int oldStart);
+    bool fuseIncLocal(int oldStart);
+    bool fusePropertySelf(int oldStart);
+
+    int jumpTarget(int offset) const;
+    bool patchJumps();
+
+    Interpreter *vm_;
+    const Vector<Function *> &functions_; // para o tamanho do OP_CLOSURE
+    Code *chunk_;
+
+    std::vector<int> starts_;
+    std::vector<uint8> isTarget_;
+    std::vector<int> remap_;
+
+    std::vector<uint8> out_;
+    std::vector<int> outLines_;
+    std::vector<PeepInstr> emitted_;
+    std::vector<PeepJump> jumps_;
+
+    int pendingLine_ = 0;
+    bool pendingTarget_ = false;
+  };
+}
+
+int Peephole::instructionLength(int offset) const
+{
+  return Compiler::instructionLength(chunk_, (size_t)offset, functions_);
+}
+
+int Compiler::instructionLength(const Code *chunk, size_t offset, const Vector<Function *> &functions)
+{
+  switch (chunk->code[offset])
+  {
+  case OP_GET_LOCAL:
+  case OP_SET_LOCAL:
+  case OP_GET_PRIVATE:
+  case OP_SET_PRIVATE:
+  case OP_CALL:
+  case OP_SPAWN:
+  case OP_PRINT:
+  case OP_DISCARD:
+  case OP_GET_UPVALUE:
+  case OP_SET_UPVALUE:
+  case OP_RETURN_N:
+  case OP_CONCAT:
+    return 2;
+
+  case OP_CONSTANT:
+  case OP_GET_GLOBAL:
+  case OP_SET_GLOBAL:
+  case OP_DEFINE_GLOBAL:
+  case OP_JUMP:
+  case OP_JUMP_IF_FALSE:
+  case OP_LOOP:
+  case OP_GOSUB:
+  case OP_DEFINE_ARRAY:
+  case OP_DEFINE_MAP:
+  case OP_GET_LOCAL_GET_LOCAL_ADD:
+    return 3;
+
+  case OP_INC_LOCAL:
+    return 4;
+
+  case OP_GET_PROPERTY:
+  case OP_SET_PROPERTY:
+  case OP_SUPER_INVOKE:
+  case OP_TRY:
+  case OP_LOCAL_LESS_LOCAL_JUMP:
+  case OP_GET_PROPERTY_SELF:
+    return 5;
+
+  case OP_INVOKE:
+  case OP_LOCAL_LESS_CONST_JUMP:
+    return 6;
+
+  case OP_CLOSURE:
+  {
+    if (offset + 2 >= chunk->count)
+      return 0;
+    Value fn = chunk->constants[readShortAt(chunk->code, offset + 1)];
+    if (!fn.isFunction())
+      return 0;
+    int id = fn.asFunctionId();
+    if (id < 0 || (size_t)id >= functions.size())
+      return 0;
+    return 3 + functions[id]->upvalueCount * 2;
+  }
+
+  default:
+    return unquickenOpcode(chunk->code[offset]) <= OP_RETURN_N ? 1 : 0;
+  }
+}
+
+// Alvo de um salto relativo (só para isRelativeJump)
+int Peephole::jumpTarget(int offset) const
+{
+  const uint8 *code = chunk_->code;
+  switch (code[offset])
+  {
+  case OP_JUMP:
+  case OP_JUMP_IF_FALSE:
+    return offset + 3 + readShortAt(code, offset + 1);
+  case OP_LOOP:
+    return offset + 3 - readShortAt(code, offset + 1);
+  case OP_GOSUB:
+    return offset + 3 + (int16)readShortAt(code, offset + 1);
+  case OP_LOCAL_LESS_LOCAL_JUMP:
+    return offset + 5 + readShortAt(code, offset + 3);
+  case OP_LOCAL_LESS_CONST_JUMP:
+    return offset + 6 + readShortAt(code, offset + 4);
+  default:
+    return 0;
+  }
+}
+
+bool Peephole::scan()
+{
+  const int count = (int)chunk_->count;
+  std::vector<uint8> isStart(count + 1, 0);
+  isTarget_.assign(count + 1, 0);
+  isStart[count] = 1;
+
+  for (int off = 0; off < count;)
+  {
+    int len = instructionLength(off);
+    if (len == 0 || off + len > count)
+      return false;
+
+    isStart[off] = 1;
+    starts_.push_back(off);
+
+    uint8 op = chunk_->code[off];
+    if (isRelativeJump(op))
+    {
+      int target = jumpTarget(off);
+      if (target < 0 || target > count)
+        return false;
+      isTarget_[target] = 1;
+    }
+    if (op == OP_GOSUB)
+      isTarget_[off + 3] = 1; // endereço de retorno
+    if (op == OP_TRY)
+    {
+      uint16 catchAddr = readShortAt(chunk_->code, off + 1);
+      uint16 finallyAddr = readShortAt(chunk_->code, off + 3);
+      if (catchAddr != 0xFFFF)
+      {
+        if (catchAddr > count)
+          return false;
+        isTarget_[catchAddr] = 1;
+      }
+      if (finallyAddr != 0xFFFF)
+      {
+        if (finallyAddr > count)
+          return false;
+        isTarget_[finallyAddr] = 1;
+      }
+    }
+    off += len;
+  }
+
+  for (int i = 0; i <= count; i++)
+  {
+    if (isTarget_[i] && !isStart[i])
+      return false;
+  }
+  return true;
+}
+
+// As últimas n instruções emitidas + a atual podem ser fundidas:
+// só a primeira do grupo pode ser alvo de salto.
+bool Peephole::tailFree(size_t n, int oldStart) const
+{
+  if (emitted_.size() < n || isTarget_[oldStart])
+    return false;
+  for (size_t i = 0; i + 1 < n; i++)
+  {
+    if (tail(i).target)
+      return false;
+  }
+  return true;
+}
+
+// Remove as últimas n instruções; a próxima herda linha e "alvo" da primeira
+void Peephole::rewind(size_t n)
+{
+  const PeepInstr &first = tail(n - 1);
+  pendingLine_ = first.line;
+  pendingTarget_ = first.target;
+  out_.resize(first.newStart);
+  outLines_.resize(first.newStart);
+  emitted_.resize(emitted_.size() - n);
+}
+
+void Peephole::emit(int oldStart, int len)
+{
+  uint8 op = chunk_->code[oldStart];
+  int newStart = (int)out_.size();
+  int line = chunk_->lines[oldStart];
+
+  remap_[oldStart] = newStart;
+  for (int i = 0; i < len; i++)
+  {
+    out_.push_back(chunk_->code[oldStart + i]);
+    outLines_.push_back(line);
+  }
+  emitted_.push_back({newStart, line, op, isTarget_[oldStart] != 0});
+
+  if (isRelativeJump(op))
+  {
+    jumps_.push_back({newStart, newStart + len, jumpTarget(oldStart), -1, op});
+  }
+  else if (op == OP_TRY)
+  {
+    uint16 catchAddr = readShortAt(chunk_->code, oldStart + 1);
+    uint16 finallyAddr = readShortAt(chunk_->code, oldStart + 3);
+    jumps_.push_back({newStart, newStart + len,
+                      catchAddr == 0xFFFF ? -1 : (int)catchAddr,
+                      finallyAddr == 0xFFFF ? -1 : (int)finallyAddr, op});
+  }
+}
+
+// Emite uma instrução sintetizada no lugar das que o rewind() removeu
+void Peephole::emitFused(const uint8 *bytes, int len, int oldTarget)
+{
+  int newStart = (int)out_.size();
+  for (int i = 0; i < len; i++)
+  {
+    out_.push_back(bytes[i]);
+    outLines_.push_back(pendingLine_);
+  }
+  emitted_.push_back({newStart, pendingLine_, bytes[0], pendingTarget_});
+
+  if (isRelativeJump(bytes[0]))
+  {
+    jumps_.push_back({newStart, newStart + len, oldTarget, -1, bytes[0]});
+  }
+}
+
+// CONSTANT a, CONSTANT b, ADD/SUB/MUL -> CONSTANT (a op b)
+bool Peephole::foldConstants(uint8 op, int oldStart)
+{
+  if (!tailFree(2, oldStart) || tail(0).op != OP_CONSTANT || tail(1).op != OP_CONSTANT)
+    return false;
+
+  Value a = chunk_->constants[readShortAt(bytesOf(tail(1)), 1)];
+  Value b = chunk_->constants[readShortAt(bytesOf(tail(0)), 1)];
+  Value result;
+
+  if (a.isInt() && b.isInt())
+  {
+    long long r;
+    if (op == OP_ADD)
+      r = (long long)a.asInt() + b.asInt();
+    else if (op == OP_SUBTRACT)
+      r = (long long)a.asInt() - b.asInt();
+    else
+      r = (long long)a.asInt() * b.asInt();
+
+    // Overflow fica para o runtime (mantém o comportamento)
+    if (r < INT_MIN || r > INT_MAX)
+      return false;
+    result = vm_->makeInt((int)r);
+  }
+  else if ((a.isInt() || a.isDouble()) && (b.isInt() || b.isDouble()))
+  {
+    double da = a.isInt() ? (double)a.asInt() : a.asDouble();
+    double db = b.isInt() ? (double)b.asInt() : b.asDouble();
+    if (op == OP_ADD)
+      result = vm_->makeDouble(da + db);
+    else if (op == OP_SUBTRACT)
+      result = vm_->makeDouble(da - db);
+    else
+      result = vm_->makeDouble(da * db);
+  }
+  else
+  {
+    return false;
+  }
+
+  int constant = chunk_->addConstant(result);
+  if (constant > UINT16_MAX)
+    return false;
+
+  rewind(2);
+  uint8 bytes[3] = {OP_CONSTANT, (uint8)(constant >> 8), (uint8)constant};
+  emitFused(bytes, 3, -1);
+  return true;
+}
+
+// GET_LOCAL a, GET_LOCAL b, ADD -> GET_LOCAL_GET_LOCAL_ADD a b
+bool Peephole::fuseAddLocals(int oldStart)
+{
+  if (!tailFree(2, oldStart) || tail(0).op != OP_GET_LOCAL || tail(1).op != OP_GET_LOCAL)
+    return false;
+
+  uint8 bytes[3] = {OP_GET_LOCAL_GET_LOCAL_ADD, bytesOf(tail(1))[1], bytesOf(tail(0))[1]};
+  rewind(2);
+  emitFused(bytes, 3, -1);
+  return true;
+}
+
+// GET_LOCAL a, CONSTANT k | GET_LOCAL b, LESS, JUMP_IF_FALSE
+bool Peephole::fuseLessJump(int oldStart)
+{
+  if (!tailFree(3, oldStart) || tail(0).op != OP_LESS || tail(2).op != OP_GET_LOCAL)
+    return false;
+
+  const int target = jumpTarget(oldStart);
+  const uint8 slot = bytesOf(tail(2))[1];
+  const PeepInstr &rhs = tail(1);
+
+  if (rhs.op == OP_CONSTANT)
+  {
+    const uint8 *k = bytesOf(rhs);
+    uint8 bytes[6] = {OP_LOCAL_LESS_CONST_JUMP, slot, k[1], k[2], 0xff, 0xff};
+    rewind(3);
+    emitFused(bytes, 6, target);
+    return true;
+  }
+  if (rhs.op == OP_GET_LOCAL)
+  {
+    uint8 bytes[5] = {OP_LOCAL_LESS_LOCAL_JUMP, slot, bytesOf(rhs)[1], 0xff, 0xff};
+    rewind(3);
+    emitFused(bytes, 5, target);
+    return true;
+  }
+  return false;
+}
+
+// i += k  : GET_LOCAL a, CONSTANT k, ADD, SET_LOCAL a, POP
+// i++     : GET_LOCAL a, DUP, CONSTANT k, ADD, SET_LOCAL a, POP, POP
+bool Peephole::fuseIncLocal(int oldStart)
+{
+  size_t n;
+  if (tailFree(4, oldStart) && tail(3).op == OP_GET_LOCAL && tail(2).op == OP_CONSTANT &&
+      tail(1).op == OP_ADD && tail(0).op == OP_SET_LOCAL)
+  {
+    n = 4;
+  }
+  else if (tailFree(6, oldStart) && tail(5).op == OP_GET_LOCAL && tail(4).op == OP_DUP &&
+           tail(3).op == OP_CONSTANT && tail(2).op == OP_ADD && tail(1).op == OP_SET_LOCAL &&
+           tail(0).op == OP_POP)
+  {
+    n = 6;
+  }
+  else
+  {
+    return false;
+  }
+
+  const uint8 slot = bytesOf(tail(n - 1))[1];
+  const uint8 *setLocal = bytesOf(tail(n == 4 ? 0 : 1));
+  const uint8 *k = bytesOf(tail(n == 4 ? 2 : 3));
+
+  if (setLocal[1] != slot || !chunk_->constants[readShortAt(k, 1)].isInt())
+    return false;
+
+  uint8 bytes[4] = {OP_INC_LOCAL, slot, k[1], k[2]};
+  rewind(n);
+  emitFused(bytes, 4, -1);
+  return true;
+}
+
+// GET_LOCAL 0, GET_PROPERTY name ic -> GET_PROPERTY_SELF name ic
+bool Peephole::fusePropertySelf(int oldStart)
+{
+  if (!tailFree(1, oldStart) || tail(0).op != OP_GET_LOCAL || bytesOf(tail(0))[1] != 0)
+    return false;
+
+  const uint8 *prop = chunk_->code + oldStart;
+  uint8 bytes[5] = {OP_GET_PROPERTY_SELF, prop[1], prop[2], prop[3], prop[4]};
+  rewind(1);
+  emitFused(bytes, 5, -1);
+  return true;
+}
+
+bool Peephole::patchJumps()
+{
+  for (size_t i = 0; i < jumps_.size(); i++)
+  {
+    const PeepJump &j = jumps_[i];
+
+    if (j.op == OP_TRY)
+    {
+      if (j.oldTarget != -1)
+        writeShortAt(out_, j.newStart + 1, (uint16)remap_[j.oldTarget]);
+      if (j.oldTarget2 != -1)
+        writeShortAt(out_, j.newStart + 3, (uint16)remap_[j.oldTarget2]);
+      continue;
+    }
+
+    int target = remap_[j.oldTarget];
+    if (target < 0)
+      return false;
+
+    int operand = j.newEnd - 2;
+    if (j.op == OP_LOOP)
+    {
+      writeShortAt(out_, operand, (uint16)(j.newEnd - target));
+    }
+    else if (j.op == OP_GOSUB)
+    {
+      writeShortAt(out_, operand, (uint16)(int16)(target - j.newEnd));
+    }
+    else
+    {
+      if (target < j.newEnd)
+        return false;
+      writeShortAt(out_, operand, (uint16)(target - j.newEnd));
+    }
+  }
+  return true;
+}
+
+bool Peephole::run()
+{
+  if (chunk_->count == 0 || !scan())
+    return false;
+
+  const int count = (int)chunk_->count;
+  remap_.assign(count + 1, -1);
+  out_.reserve(count);
+  outLines_.reserve(count);
+
+  for (size_t i = 0; i < starts_.size(); i++)
+  {
+    int off = starts_[i];
+    int len = (i + 1 < starts_.size() ? starts_[i + 1] : count) - off;
+    uint8 op = chunk_->code[off];
+
+    bool fused = false;
+    switch (op)
+    {
+    case OP_ADD:
+      fused = foldConstants(op, off) || fuseAddLocals(off);
+      break;
+    case OP_SUBTRACT:
+    case OP_MULTIPLY:
+      fused = foldConstants(op, off);
+      break;
+    case OP_JUMP_IF_FALSE:
+      fused = fuseLessJump(off);
+      break;
+    case OP_POP:
+      fused = fuseIncLocal(off);
+      break;
+    case OP_GET_PROPERTY:
+      fused = fusePropertySelf(off);
+      break;
+    default:
+      break;
+    }
+
+    if (fused)
+      remap_[off] = -1; // nunca é alvo (tailFree garante)
+    else
+      emit(off, len);
+  }
+  remap_[count] = (int)out_.size();
+
+  if (out_.size() >= chunk_->count || !patchJumps())
+    return false;
+
+  memcpy(chunk_->code, out_.data(), out_.size());
+  memcpy(chunk_->lines, outLines_.data(), outLines_.size() * sizeof(int));
+  chunk_->count = out_.size();
+  return true;
+}
+
+void Compiler::optimizeChunk(Function *func)
+{
+#ifdef USE_PEEPHOLE
+  if (hadError || !func || !func->chunk)
+    return;
+
+  Peephole peephole(vm_, vm_->functions, func->chunk);
+  peephole.run();
+#else
+  (void)func;
+#endif
+}
@@ -542,7 +542,7 @@ void Compiler::or_(bool canAssign)
 uint16 Compiler::identifierConstant(Token &name)
 {
 
-    return makeConstant(vm_->makeString(name.lexeme.c_str()));
+    return makeConstant(vm_->makeString(vm_->createString(name.lexeme.c_str())));
 }
 
 // Helper para emitir opcode de variável - usa emitShort para globais (índice de constante)
@@ -886,7 +886,7 @@ void Compiler::ifStatement()
     }
 }
 
-void Compiler::beginLoop(int loopStart, bool isForeach)
+void Compiler::beginLoop(int loopStart, int hiddenSlots)
 {
     if (loopDepth_ >= MAX_LOOP_DEPTH)
     {
@@ -897,7 +897,7 @@ void Compiler::beginLoop(int loopStart, bool isForeach)
     loopContexts_[loopDepth_].loopStart = loopStart;
     loopContexts_[loopDepth_].scopeDepth = scopeDepth;
     loopContexts_[loopDepth_].breakCount = 0;
-    loopContexts_[loopDepth_].isForeach = isForeach;
+    loopContexts_[loopDepth_].hiddenSlots = hiddenSlots;
     loopDepth_++;
 }
 
@@ -952,9 +952,9 @@ void Compiler::emitBreak()
 
     discardLocals(ctx.scopeDepth + 1);
 
-    if (ctx.isForeach)
+    if (ctx.hiddenSlots > 0)
     {
-        emitDiscard(2);
+        emitDiscard((uint8)ctx.hiddenSlots);
     }
 
     if (!ctx.addBreak(emitJump(OP_JUMP)))
@@ -1265,6 +1265,16 @@ void Compiler::foreachStatement()
     Token itemName = previous;
     consume(TOKEN_IN, "Expect 'in'");
 
+    // foreach (i in range(...)): contador em locals, sem sequência nenhuma
+    // ('range' só se não houver uma variável com esse nome)
+    Token rangeName = current;
+    if (check(TOKEN_IDENTIFIER) && current.lexeme == "range" && checkNext(TOKEN_LPAREN) &&
+        resolveLocal(rangeName) == -1 && declaredGlobals_.count("range") == 0)
+    {
+        foreachRange(itemName);
+        return;
+    }
+
     expression();
     consume(TOKEN_RPAREN, "Expect ')'");
 
@@ -1279,7 +1289,7 @@ void Compiler::foreachStatement()
     addLocal(tmp);
     markInitialized();
     int loopStart = currentChunk->count;
-    beginLoop(loopStart, true);
+    beginLoop(loopStart, 2);
 
     emitByte(OP_COPY2);
     emitByte(OP_ITER_NEXT);
@@ -1310,6 +1320,116 @@ void Compiler::foreachStatement()
     endLoop();
 }
 
+// foreach (i in range(end)) / range(start, end) / range(start, end, step)
+// Vira um for numérico: start/end/step ficam em locals escondidos e o item
+// é uma cópia do contador em cada volta. Sem step a condição e o incremento
+// têm a forma do for (i < end; i += 1), que o peephole funde.
+void Compiler::foreachRange(Token &itemName)
+{
+    advance(); // range
+    consume(TOKEN_LPAREN, "Expect '(' after 'range'");
+
+    Token tmp;
+    tmp.type = TOKEN_IDENTIFIER;
+    tmp.column = previous.column;
+
+    // 1º argumento: end se for o único, start se houver mais
+    expression();
+    tmp.lexeme = "__range_a__";
+    addLocal(tmp);
+    markInitialized();
+    int first = localCount_ - 1;
+
+    int counter, end, step = -1;
+    if (match(TOKEN_COMMA))
+    {
+        counter = first;
+        expression();
+        tmp.lexeme = "__range_end__";
+        addLocal(tmp);
+        markInitialized();
+        end = localCount_ - 1;
+
+        if (match(TOKEN_COMMA))
+        {
+            expression();
+            tmp.lexeme = "__range_step__";
+            addLocal(tmp);
+            markInitialized();
+            step = localCount_ - 1;
+        }
+    }
+    else
+    {
+        end = first;
+        emitConstant(vm_->makeInt(0));
+        tmp.lexeme = "__range_i__";
+        addLocal(tmp);
+        markInitialized();
+        counter = localCount_ - 1;
+    }
+    consume(TOKEN_RPAREN, "Expect ')' after range arguments");
+    consume(TOKEN_RPAREN, "Expect ')'");
+    if (hadError)
+        return;
+
+    const int hidden = step < 0 ? 2 : 3;
+
+    // CONDITION: i < end, ou (end - i) * step > 0 com step
+    int loopStart = currentChunk->count;
+    if (step < 0)
+    {
+        emitBytes(OP_GET_LOCAL, (uint8)counter);
+        emitBytes(OP_GET_LOCAL, (uint8)end);
+        emitByte(OP_LESS);
+    }
+    else
+    {
+        emitBytes(OP_GET_LOCAL, (uint8)end);
+        emitBytes(OP_GET_LOCAL, (uint8)counter);
+        emitByte(OP_SUBTRACT);
+        emitBytes(OP_GET_LOCAL, (uint8)step);
+        emitByte(OP_MULTIPLY);
+        emitConstant(vm_->makeInt(0));
+        emitByte(OP_GREATER);
+    }
+    int exitJump = emitJump(OP_JUMP_IF_FALSE);
+    emitByte(OP_POP);
+
+    // INCREMENT (saltado na primeira volta)
+    int bodyJump = emitJump(OP_JUMP);
+    int incrementStart = currentChunk->count;
+    emitBytes(OP_GET_LOCAL, (uint8)counter);
+    if (step < 0)
+        emitConstant(vm_->makeInt(1));
+    else
+        emitBytes(OP_GET_LOCAL, (uint8)step);
+    emitByte(OP_ADD);
+    emitBytes(OP_SET_LOCAL, (uint8)counter);
+    emitByte(OP_POP);
+    emitLoop(loopStart);
+    patchJump(bodyJump);
+
+    beginLoop(incrementStart, hidden);
+
+    beginScope();
+    emitBytes(OP_GET_LOCAL, (uint8)counter);
+    addLocal(itemName);
+    markInitialized();
+    statement();
+    endScope();
+
+    emitLoop(incrementStart);
+
+    patchJump(exitJump);
+    emitByte(OP_POP);
+    emitDiscard((uint8)hidden);
+
+    localCount_ -= hidden;
+
+    endLoop();
+}
+
 void Compiler::returnStatement()
 {
 
@@ -1704,6 +1824,8 @@ void Compiler::compileFunction(Function *func, bool isProcess)
     // ========================================
     func->upvalueCount = this->upvalueCount_;
 
+    optimizeChunk(func);
+
     // ========================================
     // RESTAURA ESTADO (POP da stack)
     // ========================================
@@ -1772,10 +1894,12 @@ void Compiler::prefixIncrement(bool canAssign)
         emitByte(OP_DUP);
         emitByte(OP_GET_PROPERTY);
         emitShort(nameIdx);
+        emitCacheSlot();
         emitConstant(vm_->makeInt(1));
         emitByte(OP_ADD);
         emitByte(OP_SET_PROPERTY);
         emitShort(nameIdx);
+        emitCacheSlot();
     }
     // -----------------------------------------------------------
     // CENÁRIO B: É uma VARIÁVEL (++i, ++upvalue, ++private)
@@ -1883,10 +2007,12 @@ void Compiler::prefixDecrement(bool canAssign)
         emitByte(OP_DUP);                        // [obj, obj]
         emitByte(OP_GET_PROPERTY);
         emitShort(nameIdx);                      // [obj, val_antigo]
+        emitCacheSlot();
         emitConstant(vm_->makeInt(1));           // [obj, val_antigo, 1]
         emitByte(OP_SUBTRACT);                   // [obj, val_novo]
         emitByte(OP_SET_PROPERTY);
         emitShort(nameIdx);                      // [val_novo]
+        emitCacheSlot();
     }
     // -----------------------------------------------------------
     // CENÁRIO B: É uma VARIÁVEL (Locais, Upvalues, Globais, Privates)
@@ -2033,6 +2159,7 @@ void Compiler::includeStatement()
 
     // Adiciona ao set
     includedFiles.insert(filename);
+    includes_.push_back({filename, hashBytes64(source, sourceSize)});
 
     // SALVA estado
     Lexer *oldLexer = this->lexer;
@@ -2184,6 +2311,8 @@ void Compiler::parseRequire()
         // Ignorar strings vazias
         if (!pluginName.empty())
         {
+            requiredPlugins_.push_back(pluginName);
+
             // Check if module is already loaded
             if (!vm_->containsModule(pluginName.c_str()))
             {
@@ -2298,6 +2427,7 @@ void Compiler::dot(bool canAssign)
         emitByte(OP_INVOKE);
         emitShort(nameIdx);
         emitByte(argCount);
+        emitCacheSlot();
     }
     // SIMPLE ASSIGNMENT
     else if (canAssign && match(TOKEN_EQUAL))
@@ -2305,6 +2435,7 @@ void Compiler::dot(bool canAssign)
         expression();
         emitByte(OP_SET_PROPERTY);
         emitShort(nameIdx);
+        emitCacheSlot();
     }
     //  COMPOUND ASSIGNMENTS
     else if (canAssign && match(TOKEN_PLUS_EQUAL))
@@ -2314,50 +2445,60 @@ void Compiler::dot(bool canAssign)
         emitByte(OP_DUP);                    // [self, self]
         emitByte(OP_GET_PROPERTY);
         emitShort(nameIdx);                  // [self, old_x]
+        emitCacheSlot();
         expression();                        // [self, old_x, value]
         emitByte(OP_ADD);                    // [self, new_x]
         emitByte(OP_SET_PROPERTY);
         emitShort(nameIdx);                  // []
+        emitCacheSlot();
     }
     else if (canAssign && match(TOKEN_MINUS_EQUAL))
     {
         emitByte(OP_DUP);
         emitByte(OP_GET_PROPERTY);
         emitShort(nameIdx);
+        emitCacheSlot();
         expression();
         emitByte(OP_SUBTRACT);
         emitByte(OP_SET_PROPERTY);
         emitShort(nameIdx);
+        emitCacheSlot();
     }
     else if (canAssign && match(TOKEN_STAR_EQUAL))
     {
         emitByte(OP_DUP);
         emitByte(OP_GET_PROPERTY);
         emitShort(nameIdx);
+        emitCacheSlot();
         expression();
         emitByte(OP_MULTIPLY);
         emitByte(OP_SET_PROPERTY);
         emitShort(nameIdx);
+        emitCacheSlot();
     }
     else if (canAssign && match(TOKEN_SLASH_EQUAL))
     {
         emitByte(OP_DUP);
         emitByte(OP_GET_PROPERTY);
         emitShort(nameIdx);
+        emitCacheSlot();
         expression();
         emitByte(OP_DIVIDE);
         emitByte(OP_SET_PROPERTY);
         emitShort(nameIdx);
+        emitCacheSlot();
     }
     else if (canAssign && match(TOKEN_PERCENT_EQUAL))
     {
         emitByte(OP_DUP);
         emitByte(OP_GET_PROPERTY);
         emitShort(nameIdx);
+        emitCacheSlot();
         expression();
         emitByte(OP_MODULO);
         emitByte(OP_SET_PROPERTY);
         emitShort(nameIdx);
+        emitCacheSlot();
     }
     //  INCREMENT/DECREMENT
     else if (canAssign && match(TOKEN_PLUS_PLUS))
@@ -2367,14 +2508,17 @@ void Compiler::dot(bool canAssign)
         emitByte(OP_DUP);                    // [self, self]
         emitByte(OP_GET_PROPERTY);
         emitShort(nameIdx);                  // [self, old_x]
+        emitCacheSlot();
         emitByte(OP_SWAP);                   // [old_x, self]
         emitByte(OP_DUP);                    // [old_x, self, self]
         emitByte(OP_GET_PROPERTY);
         emitShort(nameIdx);                  // [old_x, self, old_x]
+        emitCacheSlot();
         emitConstant(vm_->makeInt(1));       // [old_x, self, old_x, 1]
         emitByte(OP_ADD);                    // [old_x, self, new_x]
         emitByte(OP_SET_PROPERTY);
         emitShort(nameIdx);                  // [old_x, new_x]
+        emitCacheSlot();
         emitByte(OP_POP);                    // [old_x] ← resultado correto!
     }
     else if (canAssign && match(TOKEN_MINUS_MINUS))
@@ -2384,14 +2528,17 @@ void Compiler::dot(bool canAssign)
         emitByte(OP_DUP);                    // [self, self]
         emitByte(OP_GET_PROPERTY);
         emitShort(nameIdx);                  // [self, old_x]
+        emitCacheSlot();
         emitByte(OP_SWAP);                   // [old_x, self]
         emitByte(OP_DUP);                    // [old_x, self, self]
         emitByte(OP_GET_PROPERTY);
         emitShort(nameIdx);                  // [old_x, self, old_x]
+        emitCacheSlot();
         emitConstant(vm_->makeInt(1));       // [old_x, self, old_x, 1]
         emitByte(OP_SUBTRACT);               // [old_x, self, new_x]
         emitByte(OP_SET_PROPERTY);
         emitShort(nameIdx);                  // [old_x, new_x]
+        emitCacheSlot();
         emitByte(OP_POP);                    // [old_x] ← resultado correto!
     }
     //  GET ONLY
@@ -2399,6 +2546,7 @@ void Compiler::dot(bool canAssign)
     {
         emitByte(OP_GET_PROPERTY);
         emitShort(nameIdx);
+        emitCacheSlot();
     }
 }
 
@@ -2912,6 +3060,8 @@ void Compiler::method(ClassDef *classDef)
 
     endScope();
 
+    optimizeChunk(func);
+
     // ===== RESTAURA ESTADO =====
     this->function = enclosing;
     this->currentChunk = enclosingChunk;
@@ -208,9 +208,9 @@ size_t Debug::disassembleInstruction(const Code &chunk, size_t offset)
 
     // ========== PROPERTIES (46-49) ==========
   case OP_GET_PROPERTY:
-    return constantInstruction("OP_GET_PROPERTY", chunk, offset);
+    return propertyInstruction("OP_GET_PROPERTY", chunk, offset);
   case OP_SET_PROPERTY:
-    return constantInstruction("OP_SET_PROPERTY", chunk, offset);
+    return propertyInstruction("OP_SET_PROPERTY", chunk, offset);
   case OP_GET_INDEX:
     return simpleInstruction("OP_GET_INDEX", offset);
   case OP_SET_INDEX:
@@ -219,7 +219,7 @@ size_t Debug::disassembleInstruction(const Code &chunk, size_t offset)
     // ========== METHODS (50-51) ==========
   case OP_INVOKE:
   {
-    if (!hasBytes(chunk, offset, 3))
+    if (!hasBytes(chunk, offset, 5))
     {
       printf("OP_INVOKE <truncated>\n");
       return chunk.count;
@@ -227,14 +227,15 @@ size_t Debug::disassembleInstruction(const Code &chunk, size_t offset)
 
     uint16_t nameIdx = (uint16_t)(chunk.code[offset + 1] << 8) | chunk.code[offset + 2];
     uint8_t argCount = chunk.code[offset + 3];
+    uint16_t cacheIdx = (uint16_t)(chunk.code[offset + 4] << 8) | chunk.code[offset + 5];
 
     Value c = chunk.constants[nameIdx];
     const char *nm = (c.isString() ? c.asString()->chars() : "<non-string>");
 
-    printf("%-20s %4u '%s' (%u args)\n", "OP_INVOKE", (unsigned)nameIdx, nm,
-           (unsigned)argCount);
+    printf("%-20s %4u '%s' (%u args) ic=%u\n", "OP_INVOKE", (unsigned)nameIdx, nm,
+           (unsigned)argCount, (unsigned)cacheIdx);
 
-    return offset + 4;
+    return offset + 6;
   }
 
   case OP_SUPER_INVOKE:
@@ -348,6 +349,93 @@ size_t Debug::disassembleInstruction(const Code &chunk, size_t offset)
   case OP_FREE:
     return simpleInstruction("OP_FREE", offset);
 
+    // ========== SUPERINSTRUÇÕES (89-93) ==========
+  case OP_GET_LOCAL_GET_LOCAL_ADD:
+  {
+    if (!hasBytes(chunk, offset, 2))
+    {
+      printf("OP_GET_LOCAL_GET_LOCAL_ADD <truncated>\n");
+      return chunk.count;
+    }
+    printf("%-20s %4u %4u\n", "OP_GET_LOCAL_GET_LOCAL_ADD",
+           (unsigned)chunk.code[offset + 1], (unsigned)chunk.code[offset + 2]);
+    return offset + 3;
+  }
+  case OP_LOCAL_LESS_CONST_JUMP:
+  {
+    if (!hasBytes(chunk, offset, 5))
+    {
+      printf("OP_LOCAL_LESS_CONST_JUMP <truncated>\n");
+      return chunk.count;
+    }
+    uint16 constant = (uint16)(chunk.code[offset + 2] << 8) | chunk.code[offset + 3];
+    uint16 jump = (uint16)(chunk.code[offset + 4] << 8) | chunk.code[offset + 5];
+    printf("%-20s %4u < '", "OP_LOCAL_LESS_CONST_JUMP", (unsigned)chunk.code[offset + 1]);
+    printValue(chunk.constants[constant]);
+    printf("' -> %zu\n", offset + 6 + jump);
+    return offset + 6;
+  }
+  case OP_LOCAL_LESS_LOCAL_JUMP:
+  {
+    if (!hasBytes(chunk, offset, 4))
+    {
+      printf("OP_LOCAL_LESS_LOCAL_JUMP <truncated>\n");
+      return chunk.count;
+    }
+    uint16 jump = (uint16)(chunk.code[offset + 3] << 8) | chunk.code[offset + 4];
+    printf("%-20s %4u < %u -> %zu\n", "OP_LOCAL_LESS_LOCAL_JUMP",
+           (unsigned)chunk.code[offset + 1], (unsigned)chunk.code[offset + 2], offset + 5 + jump);
+    return offset + 5;
+  }
+  case OP_INC_LOCAL:
+  {
+    if (!hasBytes(chunk, offset, 3))
+    {
+      printf("OP_INC_LOCAL <truncated>\n");
+      return chunk.count;
+    }
+    uint16 constant = (uint16)(chunk.code[offset + 2] << 8) | chunk.code[offset + 3];
+    printf("%-20s %4u += '", "OP_INC_LOCAL", (unsigned)chunk.code[offset + 1]);
+    printValue(chunk.constants[constant]);
+    printf("'\n");
+    return offset + 4;
+  }
+  case OP_GET_PROPERTY_SELF:
+    return propertyInstruction("OP_GET_PROPERTY_SELF", chunk, offset);
+
+  // Quickening (só aparecem em funções que já correram)
+  case OP_ADD_II:
+    return simpleInstruction("OP_ADD_II", offset);
+  case OP_ADD_DD:
+    return simpleInstruction("OP_ADD_DD", offset);
+  case OP_SUBTRACT_II:
+    return simpleInstruction("OP_SUBTRACT_II", offset);
+  case OP_SUBTRACT_DD:
+    return simpleInstruction("OP_SUBTRACT_DD", offset);
+  case OP_MULTIPLY_II:
+    return simpleInstruction("OP_MULTIPLY_II", offset);
+  case OP_MULTIPLY_DD:
+    return simpleInstruction("OP_MULTIPLY_DD", offset);
+  case OP_LESS_II:
+    return simpleInstruction("OP_LESS_II", offset);
+  case OP_LESS_DD:
+    return simpleInstruction("OP_LESS_DD", offset);
+  case OP_LESS_EQUAL_II:
+    return simpleInstruction("OP_LESS_EQUAL_II", offset);
+  case OP_LESS_EQUAL_DD:
+    return simpleInstruction("OP_LESS_EQUAL_DD", offset);
+  case OP_GREATER_II:
+    return simpleInstruction("OP_GREATER_II", offset);
+  case OP_GREATER_DD:
+    return simpleInstruction("OP_GREATER_DD", offset);
+  case OP_GREATER_EQUAL_II:
+    return simpleInstruction("OP_GREATER_EQUAL_II", offset);
+  case OP_GREATER_EQUAL_DD:
+    return simpleInstruction("OP_GREATER_EQUAL_DD", offset);
+
+  case OP_CONCAT:
+    return byteInstruction("OP_CONCAT", chunk, offset);
+
   default:
     printf("Unknown opcode %u\n", (unsigned)instruction);
     return offset + 1;
@@ -376,6 +464,24 @@ size_t Debug::constantInstruction(const char *name, const Code &chunk,
   return offset + 3;
 }
 
+size_t Debug::propertyInstruction(const char *name, const Code &chunk,
+                                  size_t offset)
+{
+  if (!hasBytes(chunk, offset, 4))
+  {
+    printf("%s <truncated>\n", name);
+    return chunk.count;
+  }
+
+  uint16 constantIdx = (uint16)(chunk.code[offset + 1] << 8) | chunk.code[offset + 2];
+  uint16 cacheIdx = (uint16)(chunk.code[offset + 3] << 8) | chunk.code[offset + 4];
+  Value c = chunk.constants[constantIdx];
+  const char *nm = (c.isString() ? c.asString()->chars() : "<non-string>");
+
+  printf("%-20s %4u '%s' ic=%u\n", name, (unsigned)constantIdx, nm, (unsigned)cacheIdx);
+  return offset + 5;
+}
+
 size_t Debug::constantNameInstruction(const char *name, const Code &chunk,
                                       size_t offset)
 {
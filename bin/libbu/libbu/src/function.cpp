@@ -10,6 +10,22 @@ Function::~Function()
         chunk->clear();
         delete chunk;
     }
+    if (caches)
+    {
+        aFree(caches);
+        caches = nullptr;
+    }
+}
+
+uint16 Function::addInlineCache()
+{
+    if (cacheCount >= cacheCapacity)
+    {
+        cacheCapacity = (int)GROW_CAPACITY(cacheCapacity);
+        caches = (InlineCache *)aRealloc(caches, cacheCapacity * sizeof(InlineCache));
+    }
+    caches[cacheCount].count = 0;
+    return (uint16)cacheCount++;
 }
 
 Function *Interpreter::addFunction(const char *name, int arity)
@@ -13,6 +13,7 @@
  * - Collections: Arrays, Maps, Buffers
  * - Native bindings: Native class and struct instances
  * - Function closures and their captured upvalues
+ * - Runtime strings (StringPool::createRuntime); interned strings are permanent
  * 
  * Key Functions:
  * - markRoots(): Identifies all reachable objects from VM state
@@ -22,9 +23,31 @@
  * - blackenObject(): Exposes references within an object for tracing
  * - sweep(): Reclaims unmarked objects and resets marks for next cycle
  * - runGC(): Orchestrates the complete GC cycle with threshold management
- * - checkGC(): Triggers collection when allocation exceeds threshold
+ * - checkGC(): Safe point, triggers collection when allocation exceeds threshold
+ *   (strings de runtime e backing store dos contentores incluídos)
+ *
+ * Modo incremental (setGCIncremental): o ciclo é partido em fatias.
+ * - gcBegin(): marca as raízes (cinzentos)
+ * - gcWork(): esvazia a grayStack / varre por fatias de trabalho
+ * - gcAtomic(): re-scan das raízes (stacks e globais não têm barrier)
+ *   e passagem para o sweep
+ * - writeBarrier(): nos SET_PROPERTY/SET_INDEX/SET_UPVALUE e métodos de
+ *   array, o valor escrito fica cinzento enquanto se marca
+ * O sweep separa a lista do ciclo (sweepList) das alocações novas, que
+ * ficam em gcObjects e só entram no ciclo seguinte.
  */
 #include "interpreter.hpp"
+#include <chrono>
+
+// Backing store dos contentores dos objetos do GC (TrackedAlloc).
+// Sem nenhum VM vivo conta aqui.
+size_t gcPayloadDetached[GC_PAYLOAD_COUNT] = {};
+thread_local size_t *gcPayloadCounters = gcPayloadDetached;
+
+static FORCE_INLINE double gcElapsedUs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
 
 void Interpreter::markRoots()
 {
@@ -75,6 +98,16 @@ void Interpreter::markRoots()
                             markObject((GCObject *)frame->closure);
                         }
                     }
+
+                    // Erros/returns pendentes nos try/finally
+                    for (int i = 0; i < fiber->tryDepth; i++)
+                    {
+                        TryHandler *handler = &fiber->tryHandlers[i];
+                        if (handler->pendingError.isObject())
+                            markValue(handler->pendingError);
+                        if (handler->pendingReturn.isObject())
+                            markValue(handler->pendingReturn);
+                    }
                    
                 }
             }
@@ -98,39 +131,46 @@ void Interpreter::markObject(GCObject *obj)
 
 void Interpreter::markValue(const Value &v)
 {
-    if (v.isStructInstance())
+    if (v.isString())
+    {
+        // Strings não têm filhos: marca direto, sem passar pela grayStack
+        String *s = v.asString();
+        if (!s->interned)
+            s->marked = 1;
+    }
+    else if (v.isStructInstance())
     {
         // printValueNl(v);
-        markObject(v.as.sInstance);
+        markObject(v.asStructInstance());
     }
     else if (v.isClassInstance())
     {
-        markObject(v.as.sClass);
+        markObject(v.asClassInstance());
     }
     else if (v.isArray())
     {
         // printValueNl(v);
-        markObject(v.as.array);
+        markObject(v.asArray());
     }
     else if (v.isMap())
     {
-        markObject(v.as.map);
+        markObject(v.asMap());
     }
     else if (v.isBuffer())
     {
-        markObject(v.as.buffer);
+        markObject(v.asBuffer());
     }
     else if (v.isNativeClassInstance())
     {
-        markObject(v.as.sClassInstance);
+        markObject(v.asNativeClassInstance());
     }
     else if (v.isNativeStructInstance())
     {
-        markObject(v.as.sNativeStruct);
+        markObject(v.asNativeStructInstance());
     }
     else if (v.isClosure())
     {
-        markObject((GCObject *)v.as.closure);
+        markObject((GCObject *)v.asClosure());
     }
 }
 
@@ -158,6 +198,8 @@ void Interpreter::sweep()
         }
     }
 
+    stringPool.sweep();
+
     //   Info("GC Sweep freed %zu objects", freed);
 }
 
@@ -235,43 +277,35 @@ void Interpreter::freeObject(GCObject *obj)
     }
 }
 
-void Interpreter::checkGC()
-{
-    if (!enbaledGC)
-        return;
-
-    if (totalAllocated > nextGC)
-    {
-        runGC();
-    }
-}
-
-void Interpreter::blackenObject(GCObject *obj)
+// Devolve o trabalho feito (slots visitados) para medir as fatias
+size_t Interpreter::blackenObject(GCObject *obj)
 {
     switch (obj->type)
     {
     case GCObjectType::STRUCT:
     {
         StructInstance *s = static_cast<StructInstance *>(obj);
-        for (size_t i = 0; i < s->values.size(); i++)
+        Value *values = s->values();
+        for (uint32 i = 0; i < s->count; i++)
         {
-            if (!s->values[i].isObject())
+            if (!values[i].isObject())
                 continue;
-            markValue(s->values[i]);
+            markValue(values[i]);
         }
-        break;
+        return 1 + s->count;
     }
 
     case GCObjectType::CLASS:
     {
         ClassInstance *c = static_cast<ClassInstance *>(obj);
-        for (size_t i = 0; i < c->fields.size(); i++)
+        Value *fields = c->fields();
+        for (uint32 i = 0; i < c->fieldCount; i++)
         {
-            if (!c->fields[i].isObject())
+            if (!fields[i].isObject())
                 continue;
-            markValue(c->fields[i]);
+            markValue(fields[i]);
         }
-        break;
+        return 1 + c->fieldCount;
     }
 
     case GCObjectType::ARRAY:
@@ -283,29 +317,31 @@ void Interpreter::blackenObject(GCObject *obj)
                 continue;
             markValue(a->values[i]);
         }
-        break;
+        return 1 + a->values.size();
     }
 
     case GCObjectType::MAP:
     {
         MapInstance *m = static_cast<MapInstance *>(obj);
-        // Marcamos apenas os VALORES. As chaves (Strings) são ignoradas como pediste.
-        m->table.forEach([this](String *key, Value val)
-                         { 
+        m->table.forEach([this](Value key, Value val)
+                         {
+                            if (key.isObject())
+                                markValue(key);
                             if(val.isObject())
                                 markValue(val); });
-        break;
+        return 1 + m->table.count;
     }
 
     case GCObjectType::CLOSURE:
     {
 
         Closure *c = static_cast<Closure *>(obj);
-        for (size_t i = 0; i < c->upvalues.size(); i++)
+        Upvalue **upvalues = c->upvalues();
+        for (int i = 0; i < c->upvalueCount; i++)
         {
-            markObject((GCObject *)c->upvalues[i]);
+            markObject((GCObject *)upvalues[i]);
         }
-        break;
+        return 1 + c->upvalueCount;
     }
     case GCObjectType::UPVALUE:
     {
@@ -318,12 +354,27 @@ void Interpreter::blackenObject(GCObject *obj)
         break;
     }
 
+    case GCObjectType::NATIVE_STRUCT:
+    {
+        // Campos FieldType::STRING guardam String* no buffer nativo
+        NativeStructInstance *n = static_cast<NativeStructInstance *>(obj);
+        char *base = (char *)n->data;
+        n->def->fields.forEach([base](String *, NativeFieldDef field)
+                               {
+                                   if (field.type != FieldType::STRING)
+                                       return;
+                                   String *str = *(String **)(base + field.offset);
+                                   if (str && !str->interned)
+                                       str->marked = 1; });
+        break;
+    }
+
     // Estes objetos não têm filhos (referências internas), ficam logo Black
     case GCObjectType::BUFFER:
     case GCObjectType::NATIVE_CLASS:
-    case GCObjectType::NATIVE_STRUCT:
         break;
     }
+    return 1;
 }
 
 void Interpreter::traceReferences()
@@ -339,29 +390,100 @@ void Interpreter::traceReferences()
     }
 }
 
-void Interpreter::runGC()
+void Interpreter::barrierMark(const Value &v)
 {
-    if (gcInProgress)
-        return;
-    gcInProgress = true;
+    markValue(v);
+}
 
-    size_t bytesBefore = totalAllocated;
-    size_t objectsBefore = totalArrays + totalClasses + totalStructs + totalMaps + totalBuffers + totalNativeClasses + totalNativeStructs + totalClosures + totalUpvalues;
+void Interpreter::gcBegin(bool incremental)
+{
+    gcCycleBytes = getTotalAlocated();
+    gcCycleObjects = totalArrays + totalClasses + totalStructs + totalMaps + totalBuffers + totalNativeClasses + totalNativeStructs + totalClosures + totalUpvalues;
 
     grayStack.clear();
+    gcPhase = GCPhase::MARK;
 
-    markRoots();
+    // Em stop-the-world as raízes só são vistas uma vez, no gcAtomic()
+    if (incremental)
+        markRoots();
+}
 
+void Interpreter::gcAtomic()
+{
+    // Stacks, globais e privates mudaram sem barrier desde o gcBegin()
+    markRoots();
     traceReferences();
 
-    sweep();
+    sweepList = gcObjects;
+    gcObjects = nullptr;
+    sweepCursor = &sweepList;
+    stringPool.beginSweep();
+    gcPhase = GCPhase::SWEEP;
+}
+
+bool Interpreter::gcWork(size_t budget)
+{
+    if (gcPhase == GCPhase::MARK)
+    {
+        while (!grayStack.empty())
+        {
+            if (budget == 0)
+                return false;
+            GCObject *obj = grayStack.back();
+            grayStack.pop();
+            size_t work = blackenObject(obj);
+            budget = work < budget ? budget - work : 0;
+        }
+        gcAtomic();
+    }
+
+    if (gcPhase == GCPhase::SWEEP)
+    {
+        while (*sweepCursor)
+        {
+            if (budget == 0)
+                return false;
+            budget--;
+
+            GCObject *obj = *sweepCursor;
+            if (obj->marked == 0)
+            {
+                *sweepCursor = obj->next;
+                freeObject(obj);
+            }
+            else
+            {
+                //  Desmarca para próximo ciclo
+                obj->marked = 0;
+                sweepCursor = &obj->next;
+            }
+        }
+
+        if (!stringPool.sweepStep(&budget))
+            return false;
+
+        gcEnd();
+    }
+    return true;
+}
+
+void Interpreter::gcEnd()
+{
+    // Sobreviventes + o que foi alocado durante o ciclo
+    *sweepCursor = gcObjects;
+    gcObjects = sweepList;
+    sweepList = nullptr;
+    sweepCursor = nullptr;
+    gcPhase = GCPhase::IDLE;
 
     size_t objectCount = totalArrays + totalClasses + totalStructs + totalMaps + totalBuffers + totalNativeClasses + totalNativeStructs + totalClosures + totalUpvalues;
+    size_t bytes = getTotalAlocated();
 
-    size_t bytesFreed = bytesBefore - totalAllocated;
-    size_t objectsFreed = objectsBefore - objectCount;
+    gcStats.cycles++;
+    gcStats.lastFreedBytes = gcCycleBytes > bytes ? gcCycleBytes - bytes : 0;
+    gcStats.lastFreedObjects = gcCycleObjects > objectCount ? gcCycleObjects - objectCount : 0;
 
-    nextGC = static_cast<size_t>(totalAllocated * GC_GROWTH_FACTOR);
+    nextGC = static_cast<size_t>(bytes * GC_GROWTH_FACTOR);
     if (nextGC < MIN_GC_THRESHOLD)
     {
         nextGC = MIN_GC_THRESHOLD;
@@ -371,14 +493,104 @@ void Interpreter::runGC()
         nextGC = MAX_GC_THRESHOLD;
     }
 
-    // Info("GC: End - Freed %zu objects (%.2f KB). Remaining: %zu objects (%.2f KB). Next GC: %.2f KB",
-    //          objectsFreed, bytesFreed / 1024.0,
-    //          objectCount, totalAllocated / 1024.0,
+    // Info("GC: End - Freed %zu objects (%.2f KB). Remaining: %zu objects, %zu strings (%.2f KB). Next GC: %.2f KB",
+    //          gcStats.lastFreedObjects, gcStats.lastFreedBytes / 1024.0,
+    //          objectCount, stringPool.getRuntimeCount(), bytes / 1024.0,
     //          nextGC / 1024.0);
+}
+
+void Interpreter::gcRecordPause(double us)
+{
+    gcStats.pauses++;
+    gcStats.lastPauseUs = us;
+    gcStats.totalPauseUs += us;
+    if (us > gcStats.maxPauseUs)
+        gcStats.maxPauseUs = us;
+}
+
+void Interpreter::runGC()
+{
+    if (gcInProgress)
+        return;
+    gcInProgress = true;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Acaba o ciclo incremental pendente; o lixo criado entretanto
+    // só é visto pelo ciclo completo a seguir
+    if (gcPhase != GCPhase::IDLE)
+        gcWork((size_t)-1);
+
+    gcBegin(false);
+    gcWork((size_t)-1);
 
+    gcRecordPause(gcElapsedUs(start));
     gcInProgress = false;
+}
+
+// Step disparado pelas alocações (checkGC): trabalho fixo por cada
+// GC_STEP_BYTES alocados para o mutator não fugir ao ciclo
+void Interpreter::gcAllocStep()
+{
+    if (gcInProgress)
+        return;
+    gcInProgress = true;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    if (gcPhase == GCPhase::IDLE)
+        gcBegin(true);
 
-    // gcInProgress = false;
+    size_t bytes = getTotalAlocated();
+    if (bytes > nextGC * 2)
+    {
+        // Alocação muito mais rápida que o ciclo: acaba de uma vez
+        gcWork((size_t)-1);
+    }
+    else
+    {
+        gcWork(GC_STEP_WORK);
+    }
+    gcStepTrigger = getTotalAlocated() + GC_STEP_BYTES;
+
+    gcRecordPause(gcElapsedUs(start));
+    gcInProgress = false;
+}
+
+void Interpreter::gcStep(double budgetUs)
+{
+    if (!enbaledGC || gcInProgress)
+        return;
+
+    // Começa o ciclo antes do limite para o trabalho caber nos frames
+    // antes de os safe points o forçarem
+    if (gcPhase == GCPhase::IDLE && getTotalAlocated() < nextGC - nextGC / 4)
+        return;
+
+    gcInProgress = true;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    if (gcPhase == GCPhase::IDLE)
+        gcBegin(true);
+
+    while (!gcWork(GC_SLICE_WORK))
+    {
+        if (gcElapsedUs(start) >= budgetUs)
+            break;
+    }
+    gcStepTrigger = getTotalAlocated() + GC_STEP_BYTES;
+
+    gcRecordPause(gcElapsedUs(start));
+    gcInProgress = false;
+}
+
+void Interpreter::setGCIncremental(bool enabled)
+{
+    if (!enabled && gcPhase != GCPhase::IDLE)
+    {
+        gcInProgress = true;
+        gcWork((size_t)-1);
+        gcInProgress = false;
+    }
+    gcIncremental = enabled;
 }
 
 size_t Interpreter::countObjects() const
@@ -393,9 +605,47 @@ size_t Interpreter::countObjects() const
     return count;
 }
 
+static void heapType(HeapTypeStats &t, size_t count, size_t objectSize, size_t payload)
+{
+    t.count = count;
+    t.objectBytes = count * objectSize;
+    t.payloadBytes = payload;
+}
+
+void Interpreter::getHeapStats(HeapStats *out) const
+{
+    heapType(out->arrays, totalArrays, sizeof(ArrayInstance), gcPayloadBytes[GC_PAYLOAD_ARRAY]);
+    heapType(out->maps, totalMaps, sizeof(MapInstance), gcPayloadBytes[GC_PAYLOAD_MAP]);
+    heapType(out->structs, totalStructs, sizeof(StructInstance), gcPayloadBytes[GC_PAYLOAD_STRUCT]);
+    heapType(out->classes, totalClasses, sizeof(ClassInstance), gcPayloadBytes[GC_PAYLOAD_CLASS]);
+    heapType(out->closures, totalClosures, sizeof(Closure), gcPayloadBytes[GC_PAYLOAD_CLOSURE]);
+    heapType(out->upvalues, totalUpvalues, sizeof(Upvalue), 0);
+    heapType(out->buffers, totalBuffers, sizeof(BufferInstance), bufferBytes);
+    heapType(out->nativeClasses, totalNativeClasses, sizeof(NativeClassInstance), nativeInlineBytes);
+    heapType(out->nativeStructs, totalNativeStructs, sizeof(NativeStructInstance), nativeStructBytes);
+
+    // Strings: o pool só sabe o total (cabeçalho + chars)
+    out->strings.count = stringPool.getRuntimeCount();
+    out->strings.objectBytes = stringPool.getRuntimeBytes();
+    out->strings.payloadBytes = 0;
+
+    out->totalBytes = getTotalAlocated();
+}
+
 void Interpreter::clearAllGCObjects()
 {
 
+    // Ciclo incremental a meio: junta a lista do sweep e esquece os cinzentos
+    if (gcPhase == GCPhase::SWEEP)
+    {
+        *sweepCursor = gcObjects;
+        gcObjects = sweepList;
+        sweepList = nullptr;
+        sweepCursor = nullptr;
+    }
+    gcPhase = GCPhase::IDLE;
+    grayStack.clear();
+
     if (!gcObjects)
         return;
 
@@ -7,6 +7,8 @@
 
 Interpreter::Interpreter()
 {
+  // O último VM criado conta as alocações feitas fora de run_fiber
+  gcPayloadCounters = gcPayloadBytes;
   compiler = new Compiler(this);
 
   setPrivateTable();
@@ -117,6 +119,17 @@ void Interpreter::freeRunningProcesses()
     ProcessPool::instance().destroy(aliveProcesses[i]);
   }
   aliveProcesses.clear();
+  runProcesses.clear();
+  sleepQueue.clear();
+  sleepingCount_ = 0;
+#ifdef BU_ENABLE_SPATIAL
+  spatialGrid.clear();
+  spatialDirty.clear();
+  spatialMaxRadius_ = 0.0f;
+  spatialActive_ = false;
+  spatialQuery.active = false;
+#endif
+  processTable.clear();
   ProcessPool::instance().clear();
   processesMap.destroy();
 }
@@ -195,6 +208,7 @@ void Interpreter::reset()
   structsMap.destroy();
 
   clearAllGCObjects();
+  stringPool.clearRuntime();
 
   gcObjects = nullptr;
   totalAllocated = 0;
@@ -267,11 +281,13 @@ Interpreter::~Interpreter()
   arena.Clear();
   // Info("String Heap stats:");
   stringPool.clear();
+
+  if (gcPayloadCounters == gcPayloadBytes)
+    gcPayloadCounters = gcPayloadDetached;
 }
 
 BufferInstance *Interpreter::createBuffer(int count, int typeRaw)
 {
-  checkGC();
   size_t size = sizeof(BufferInstance);
   void *mem = (BufferInstance *)arena.Allocate(size);
 
@@ -284,6 +300,7 @@ BufferInstance *Interpreter::createBuffer(int count, int typeRaw)
 
   totalAllocated += size;
   totalAllocated += (count * instance->elementSize); // Conta também os dados raw!
+  bufferBytes += (count * instance->elementSize);
 
   return instance;
 }
@@ -299,10 +316,13 @@ void Interpreter::freeBuffer(BufferInstance *b)
   totalBuffers--;
 
   totalAllocated -= (size + dataSize);
+  bufferBytes -= dataSize;
 }
 
 void Interpreter::setFileLoader(FileLoaderCallback loader, void *userdata)
 {
+  fileLoader = loader;
+  fileLoaderUserdata = userdata;
   compiler->setFileLoader(loader, userdata);
 }
 
@@ -338,6 +358,17 @@ NativeClassDef *Interpreter::registerNativeClass(const char *name,
   return klass;
 }
 
+NativeClassDef *Interpreter::registerNativeValueClass(const char *name,
+                                                      size_t valueSize,
+                                                      NativeStructCtor ctor,
+                                                      int argCount)
+{
+  NativeClassDef *klass = registerNativeClass(name, nullptr, nullptr, argCount, false);
+  klass->valueSize = valueSize;
+  klass->valueConstructor = ctor;
+  return klass;
+}
+
 void Interpreter::addNativeMethod(NativeClassDef *klass, const char *methodName,
                                   NativeMethod method)
 {
@@ -360,8 +391,7 @@ void Interpreter::addNativeProperty(NativeClassDef *klass, const char *propName,
 Value Interpreter::createNativeStruct(int structId, int argc, Value *args)
 {
   NativeStructDef *def = nativeStructs[structId];
-  void *data = arena.Allocate(def->structSize);
-  std::memset(data, 0, def->structSize);
+  void *data = allocNativeStructData(def);
   if (def->constructor)
   {
     def->constructor(this, data, argc, args);
@@ -721,7 +751,7 @@ Function *Interpreter::compile(const char *source)
 
   if (globalsArray.size() < globalIndexToName_.size())
   {
-    globalsArray.resize(globalIndexToName_.size());
+    globalsArray.resize(globalIndexToName_.size(), makeNil());
   }
   
   Function *mainFunc = proc->fibers[0].frames[0].func;
@@ -744,7 +774,7 @@ Function *Interpreter::compileExpression(const char *source)
 
   if (globalsArray.size() < globalIndexToName_.size())
   {
-    globalsArray.resize(globalIndexToName_.size());
+    globalsArray.resize(globalIndexToName_.size(), makeNil());
   }
   
   Function *mainFunc = proc->fibers[0].frames[0].func;
@@ -773,7 +803,7 @@ bool Interpreter::run(const char *source, bool _dump)
 
   if (globalsArray.size() < globalIndexToName_.size())
   {
-    globalsArray.resize(globalIndexToName_.size());
+    globalsArray.resize(globalIndexToName_.size(), makeNil());
   }
 
   if (_dump)
@@ -783,14 +813,25 @@ bool Interpreter::run(const char *source, bool _dump)
     //   Debug::dumpFunction(mainFunc);
   }
 
+  return startMainProcess(proc);
+}
+
+bool Interpreter::startMainProcess(ProcessDef *proc)
+{
   mainProcess = spawnProcess(proc);
+  if (!mainProcess)
+  {
+    return false;
+  }
   currentProcess = mainProcess;
 
   Fiber *fiber = &mainProcess->fibers[0];
 
   //  Debug::disassembleChunk(*fiber->frames[0].func->chunk,"#main");
 
+  inScheduler_ = true;
   run_fiber(fiber, mainProcess);
+  inScheduler_ = false;
 
   return !hasFatalError_;
 }
@@ -816,7 +857,7 @@ bool Interpreter::compile(const char *source, bool dump)
 
   if (globalsArray.size() < globalIndexToName_.size())
   {
-    globalsArray.resize(globalIndexToName_.size());
+    globalsArray.resize(globalIndexToName_.size(), makeNil());
   }
 
   if (dump)
@@ -837,6 +878,15 @@ void Interpreter::initFiber(Fiber *fiber, Function *func)
   fiber->resumeTime = 0.0f;
 
   fiber->stackTop = fiber->stack;
+  fiber->frameCount = 0;
+  fiber->tryDepth = 0;
+
+  if (!ensureFiber(fiber, functionStackSize(func)))
+  {
+    runtimeError("Critical: Out of memory creating fiber!");
+    fiber->state = FiberState::DEAD;
+    return;
+  }
 
   fiber->ip = func->chunk->code;
 
@@ -923,6 +973,16 @@ String *Interpreter::createString(const char *str)
   return stringPool.create(str);
 }
 
+String *Interpreter::newString(const char *str, uint32 len)
+{
+  return stringPool.createRuntime(str, len);
+}
+
+String *Interpreter::newString(const char *str)
+{
+  return stringPool.createRuntime(str);
+}
+
 bool Interpreter::containsClassDefenition(String *name)
 {
   return classesMap.exist(name);
@@ -970,23 +1030,8 @@ Value Interpreter::createClassInstance(ClassDef *klass, int argCount, Value *arg
   }
 
   // Cria a instância
-  Value value = makeClassInstance();
+  Value value = makeClassInstance(klass);
   ClassInstance *instance = value.asClassInstance();
-  instance->klass = klass;
-  instance->fields.reserve(klass->fieldCount);
-
-  // Inicializa fields com valores default ou nil
-  for (int i = 0; i < klass->fieldCount; i++)
-  {
-    if (i < (int)klass->fieldDefaults.size() && !klass->fieldDefaults[i].isNil())
-    {
-      instance->fields.push(klass->fieldDefaults[i]);
-    }
-    else
-    {
-      instance->fields.push(makeNil());
-    }
-  }
 
   // Se herda de NativeClass, cria os dados nativos
   NativeClassDef *nativeDef = nullptr;
@@ -1027,7 +1072,7 @@ Value Interpreter::createClassInstance(ClassDef *klass, int argCount, Value *arg
     Process *proc = mainProcess;
     Fiber *fiber = &proc->fibers[0];
     int savedFrameCount = fiber->frameCount;
-    Value *savedStackTop = fiber->stackTop;
+    int savedTop = (int)(fiber->stackTop - fiber->stack); // offset: a stack pode crescer
 
     // Prepara a stack: primeiro a instância (será slot 0 = self), depois os args
     push(value);
@@ -1037,9 +1082,10 @@ Value Interpreter::createClassInstance(ClassDef *klass, int argCount, Value *arg
     }
 
     // Cria um novo frame para o constructor
-    if (fiber->frameCount >= FRAMES_MAX)
+    if (!ensureFiber(fiber, functionStackSize(klass->constructor)))
     {
       runtimeError("Stack overflow calling constructor");
+      fiber->stackTop = fiber->stack + savedTop;
       return makeNil();
     }
 
@@ -1060,7 +1106,7 @@ Value Interpreter::createClassInstance(ClassDef *klass, int argCount, Value *arg
     }
 
     // Limpa a stack (o constructor já fez pop do self)
-    fiber->stackTop = savedStackTop;
+    fiber->stackTop = fiber->stack + savedTop;
   }
 
   return value;
@@ -1085,22 +1131,8 @@ Value Interpreter::createClassInstanceRaw(ClassDef *klass)
     return makeNil();
   }
 
-  Value value = makeClassInstance();
+  Value value = makeClassInstance(klass);
   ClassInstance *instance = value.asClassInstance();
-  instance->klass = klass;
-  instance->fields.reserve(klass->fieldCount);
-
-  for (int i = 0; i < klass->fieldCount; i++)
-  {
-    if (i < (int)klass->fieldDefaults.size() && !klass->fieldDefaults[i].isNil())
-    {
-      instance->fields.push(klass->fieldDefaults[i]);
-    }
-    else
-    {
-      instance->fields.push(makeNil());
-    }
-  }
 
   // Se herda de NativeClass, cria os dados nativos
   NativeClassDef *nativeDef = nullptr;
@@ -1235,6 +1267,34 @@ BufferInstance::~BufferInstance()
   }
 }
 
+bool BufferInstance::slice(int argCount, Value *args, int first, int *offset, int *length) const
+{
+  int total = byteSize();
+  int off = 0;
+  if (argCount > first)
+  {
+    if (!args[first].isInt())
+      return false;
+    off = args[first].asInt();
+  }
+  if (off < 0 || off > total)
+    return false;
+
+  int len = total - off;
+  if (argCount > first + 1)
+  {
+    if (!args[first + 1].isInt())
+      return false;
+    len = args[first + 1].asInt();
+  }
+  if (len < 0 || len > total - off)
+    return false;
+
+  *offset = off;
+  *length = len;
+  return true;
+}
+
 // bool ClassInstance::getMethod(String *name, Function **out)
 // {
 //   ClassDef *current = klass;
@@ -1366,7 +1426,7 @@ void Interpreter::dumpAllFunctions(FILE *f)
             } else if (v.isNil()) {
                 fprintf(f, "nil");
             } else {
-                fprintf(f, "<value type %d>", (int)v.type);
+                fprintf(f, "<value type %d>", (int)v.getType());
             }
             fprintf(f, "\n");
         }
@@ -1527,17 +1587,11 @@ Closure::Closure() : GCObject(GCObjectType::CLOSURE),
                      functionId(-1),
                      upvalueCount(0) {}
 
-Closure::~Closure()
-{
-
-  upvalues.destroy();
-}
-
 Upvalue::Upvalue(Value *loc) : GCObject(GCObjectType::UPVALUE)
 {
   location = loc;
   nextOpen = nullptr;
-  closed.type = ValueType::NIL;
+  closed = Value();
 }
 
 // ============================================
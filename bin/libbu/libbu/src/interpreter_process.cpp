@@ -1,7 +1,6 @@
 #include "interpreter.hpp"
 #include "pool.hpp"
-
-static uint64_t PROCESS_IDS = 0;
+#include <cfloat>
 
 void ProcessDef::finalize()
 {
@@ -32,11 +31,134 @@ void ProcessDef::release()
 {
     if (fibers)
     {
+        for (int i = 0; i < totalFibers; i++)
+        {
+            fibers[i].release();
+        }
+        free(fibers);
+        fibers = nullptr;
+    }
+}
+
+void Process::release()
+{
+    if (fibers)
+    {
+        for (int i = 0; i < totalFibers; i++)
+        {
+            fibers[i].release();
+        }
         free(fibers);
         fibers = nullptr;
     }
 }
 
+void Fiber::release()
+{
+    if (stack)
+    {
+        aFree(stack);
+    }
+    if (frames)
+    {
+        aFree(frames);
+    }
+    stack = nullptr;
+    stackTop = nullptr;
+    stackCapacity = 0;
+    frames = nullptr;
+    frameCount = 0;
+    frameCapacity = 0;
+}
+
+bool Interpreter::growFiber(Fiber *fiber, int slots, int frames)
+{
+    int used = (int)(fiber->stackTop - fiber->stack);
+
+    // Overflow: a base passou o limite ou demasiadas chamadas
+    if (used > STACK_MAX || fiber->frameCount + frames > FRAMES_MAX)
+    {
+        return false;
+    }
+
+    if (fiber->frameCount + frames > fiber->frameCapacity)
+    {
+        int capacity = (int)GROW_CAPACITY(fiber->frameCapacity);
+        while (capacity < fiber->frameCount + frames)
+            capacity *= 2;
+        if (capacity > FRAMES_MAX)
+            capacity = FRAMES_MAX;
+
+        CallFrame *newFrames = (CallFrame *)aRealloc(fiber->frames, capacity * sizeof(CallFrame));
+        if (!newFrames)
+        {
+            return false;
+        }
+        fiber->frames = newFrames;
+        fiber->frameCapacity = capacity;
+    }
+
+    int required = used + slots;
+    if (required > fiber->stackCapacity)
+    {
+        int capacity = (int)GROW_CAPACITY(fiber->stackCapacity);
+        if (capacity < required)
+            capacity = required;
+
+        // Tudo o que aponta para a stack passa a offset antes do realloc:
+        // depois dele os ponteiros antigos já não se podem ler
+        Value *oldStack = fiber->stack;
+        Value *oldEnd = oldStack + fiber->stackCapacity;
+        Vector<ptrdiff_t> offsets;
+        if (oldStack)
+        {
+            offsets.reserve(fiber->frameCount + fiber->tryDepth);
+            for (int i = 0; i < fiber->frameCount; i++)
+                offsets.push(fiber->frames[i].slots - oldStack);
+            for (int i = 0; i < fiber->tryDepth; i++)
+            {
+                Value *restore = fiber->tryHandlers[i].stackRestore;
+                offsets.push(restore ? restore - oldStack : -1);
+            }
+            for (Upvalue *upvalue = openUpvalues; upvalue != nullptr; upvalue = upvalue->nextOpen)
+            {
+                bool inStack = upvalue->location >= oldStack && upvalue->location < oldEnd;
+                offsets.push(inStack ? upvalue->location - oldStack : -1);
+            }
+        }
+
+        Value *newStack = (Value *)aRealloc(oldStack, capacity * sizeof(Value));
+        if (!newStack)
+        {
+            return false;
+        }
+        fiber->stack = newStack;
+        fiber->stackCapacity = capacity;
+        fiber->stackTop = newStack + used;
+
+        if (oldStack)
+        {
+            size_t k = 0;
+            for (int i = 0; i < fiber->frameCount; i++)
+                fiber->frames[i].slots = newStack + offsets[k++];
+            for (int i = 0; i < fiber->tryDepth; i++)
+            {
+                ptrdiff_t offset = offsets[k++];
+                if (offset >= 0)
+                    fiber->tryHandlers[i].stackRestore = newStack + offset;
+            }
+            for (Upvalue *upvalue = openUpvalues; upvalue != nullptr; upvalue = upvalue->nextOpen)
+            {
+                ptrdiff_t offset = offsets[k++];
+                if (offset >= 0)
+                    upvalue->location = newStack + offset;
+            }
+        }
+    }
+
+    return true;
+}
+
 void Process::reset()
 {
     this->id = 0;
@@ -53,9 +175,10 @@ void Process::reset()
             fibers[i].ip = nullptr;
             fibers[i].resumeTime = 0;
             fibers[i].gosubTop = 0;
+            fibers[i].tryDepth = 0;
         }
     }
-    totalFibers = 0;
+    // totalFibers fica: o spawn seguinte reutiliza as fibers e as stacks
     name = nullptr;
 
     state = FiberState::DEAD; // Estado do PROCESSO (frame)
@@ -63,6 +186,7 @@ void Process::reset()
     nextFiberIndex = 0;
     currentFiberIndex = 0;
     current = nullptr;
+    runIndex = -1;
 }
 
 int Interpreter::getProcessPrivateIndex(const char *name)
@@ -168,7 +292,6 @@ Process *Interpreter::spawnProcess(ProcessDef *blueprint)
     }
 
     instance->name = blueprint->name;
-    instance->id = PROCESS_IDS++;
     instance->state = FiberState::RUNNING;
     instance->resumeTime = 0;
     instance->nextFiberIndex = 1;
@@ -182,6 +305,10 @@ Process *Interpreter::spawnProcess(ProcessDef *blueprint)
     {
         if (instance->fibers) 
         {
+            for (int i = 0; i < instance->totalFibers; i++)
+            {
+                instance->fibers[i].release();
+            }
             free(instance->fibers);
         }
         instance->totalFibers = blueprint->totalFibers;
@@ -221,13 +348,24 @@ Process *Interpreter::spawnProcess(ProcessDef *blueprint)
             continue; // lixo!
         }
 
+        // Reserva stack/frames (reutiliza os da instância reciclada)
+        size_t stackSize = srcFiber->stackTop - srcFiber->stack;
+        dstFiber->stackTop = dstFiber->stack;
+        dstFiber->frameCount = 0;
+        dstFiber->tryDepth = 0;
+        if (!ensureFiber(dstFiber, (int)stackSize + functionStackSize(srcFiber->frames[0].func), srcFiber->frameCount))
+        {
+            runtimeError("Failed to allocate fiber stack!");
+            ProcessPool::instance().recycle(instance);
+            return nullptr;
+        }
+
         // Copia estado
         dstFiber->state = srcFiber->state;
         dstFiber->resumeTime = srcFiber->resumeTime;
         dstFiber->frameCount = srcFiber->frameCount;
 
         // Copia stack
-        size_t stackSize = srcFiber->stackTop - srcFiber->stack;
         if (stackSize > 0)
         {
             memcpy(dstFiber->stack, srcFiber->stack, stackSize * sizeof(Value));
@@ -278,11 +416,118 @@ Process *Interpreter::spawnProcess(ProcessDef *blueprint)
         }
     }
 
+    instance->id = processTable.insert(instance);
+    if (instance->id == ProcessTable::INVALID_ID)
+    {
+        runtimeError("Too many processes (max %u)", ProcessTable::INDEX_MASK + 1);
+        ProcessPool::instance().recycle(instance);
+        return nullptr;
+    }
+
     instance->current = &instance->fibers[0];
+    instance->aliveIndex = (uint32)aliveProcesses.size();
     aliveProcesses.push(instance);
+    instance->runIndex = (int)runProcesses.size();
+    runProcesses.push(instance);
+
+#ifdef BU_ENABLE_SPATIAL
+    instance->inGrid = false;
+    instance->spatialDirty = false;
+    instance->collisionRadius = 0.0f;
+    spatialTouch(instance); // x/y/z dos argumentos entram no próximo flush
+#endif
 
     return instance;
 }
+
+// Mata o processo; o update() tira-o das listas e liberta o id
+void Interpreter::destroyProcess(Process *proc)
+{
+    if (!proc || proc->state == FiberState::DEAD)
+        return;
+    proc->state = FiberState::DEAD;
+    proc->initialized = false;
+    wakeProcess(proc);
+}
+
+// ============================================
+// SCHEDULER
+// runProcesses tem só os processos que podem correr neste frame. Os que
+// dormem mais de dois frames (frame(N), yield longo, fibers à espera de
+// I/O) vão para a sleepQueue e voltam quando a hora chega ou quando alguém
+// os acorda (resumeFiber, destroyProcess). Acordar cedo é sempre seguro:
+// o update() volta a ver os tempos e adormece-os outra vez.
+// ============================================
+
+void Interpreter::parkProcess(Process *proc)
+{
+    int index = proc->runIndex;
+    Process *moved = runProcesses.back();
+    runProcesses[index] = moved;
+    moved->runIndex = index;
+    runProcesses.pop();
+
+    proc->runIndex = -1;
+    proc->sleepSeq++;
+    sleepQueue.push(proc->resumeTime, proc->id, proc->sleepSeq);
+    sleepingCount_++;
+}
+
+void Interpreter::wakeProcess(Process *proc)
+{
+    if (proc->runIndex >= 0)
+        return;
+    proc->runIndex = (int)runProcesses.size();
+    runProcesses.push(proc);
+    sleepingCount_--;
+
+    // Entradas obsoletas (FLT_MAX nunca sai pelo topo): compacta de vez em quando
+    if (sleepQueue.size() > 64 && sleepQueue.size() > sleepingCount_ * 2)
+    {
+        sleepQueue.retain([this](const SleepEntry &entry)
+                          {
+                              Process *p = findProcess(entry.id);
+                              return p && p->runIndex < 0 && p->sleepSeq == entry.seq;
+                          });
+    }
+}
+
+void Interpreter::wakeSleepers()
+{
+    while (!sleepQueue.empty() && sleepQueue.top().time <= currentTime)
+    {
+        SleepEntry entry = sleepQueue.top();
+        sleepQueue.pop();
+        Process *proc = findProcess(entry.id);
+        if (proc && proc->runIndex < 0 && proc->sleepSeq == entry.seq)
+            wakeProcess(proc);
+    }
+}
+
+// Tira um processo morto das listas (swap com o último, O(1))
+void Interpreter::removeProcess(Process *proc)
+{
+    if (proc->runIndex >= 0)
+    {
+        int index = proc->runIndex;
+        Process *moved = runProcesses.back();
+        runProcesses[index] = moved;
+        moved->runIndex = index;
+        runProcesses.pop();
+        proc->runIndex = -1;
+    }
+
+    uint32 index = proc->aliveIndex;
+    Process *moved = aliveProcesses.back();
+    aliveProcesses[index] = moved;
+    moved->aliveIndex = index;
+    aliveProcesses.pop();
+
+#ifdef BU_ENABLE_SPATIAL
+    spatialRemove(proc);
+#endif
+    processTable.remove(proc->id);
+}
 uint32 Interpreter::getTotalProcesses() const
 {
     return static_cast<uint32>(processes.size());
@@ -293,6 +538,21 @@ uint32 Interpreter::getTotalAliveProcesses() const
     return uint32(aliveProcesses.size());
 }
 
+size_t Interpreter::getProcessMemory() const
+{
+    size_t bytes = 0;
+    for (size_t i = 0; i < aliveProcesses.size(); i++)
+    {
+        Process *proc = aliveProcesses[i];
+        bytes += sizeof(Process);
+        for (int f = 0; f < proc->totalFibers; f++)
+        {
+            bytes += proc->fibers[f].memoryUsed();
+        }
+    }
+    return bytes;
+}
+
 void Interpreter::update(float deltaTime)
 {
     // if(    asEnded)
@@ -301,10 +561,22 @@ void Interpreter::update(float deltaTime)
     lastFrameTime = deltaTime;
     frameCount++;
 
+#ifdef BU_ENABLE_SOCKETS
+    // Acorda as fibers cujos sockets ficaram prontos antes de correr o frame
+    pollSockets();
+#endif
+
+    // Adormecidos cuja hora chegou voltam para a lista
+    wakeSleepers();
+
+    // Mais de dois frames até acordar: sai da lista até lá (a margem evita
+    // adormecer e acordar um 'frame;' a cada frame por arredondamentos)
+    const float parkAfter = currentTime + deltaTime * 2.0f;
+
     size_t i = 0;
-    while (i < aliveProcesses.size())
+    while (i < runProcesses.size())
     {
-        Process *proc = aliveProcesses[i];
+        Process *proc = runProcesses[i];
 
         // Suspended?
         if (proc->state == FiberState::SUSPENDED)
@@ -313,6 +585,11 @@ void Interpreter::update(float deltaTime)
                 proc->state = FiberState::RUNNING;
             else
             {
+                if (proc->resumeTime > parkAfter)
+                {
+                    parkProcess(proc);
+                    continue;
+                }
                 i++;
                 continue;
             }
@@ -323,9 +600,8 @@ void Interpreter::update(float deltaTime)
         {
             // remove sem manter ordem
             //   Info(" Process (id=%u) is dead. Cleaning up. ",   proc->id);
-            aliveProcesses[i] = aliveProcesses.back();
+            removeProcess(proc);
             cleanProcesses.push(proc);
-            aliveProcesses.pop();
             continue;
         }
 
@@ -340,6 +616,13 @@ void Interpreter::update(float deltaTime)
         if (hooks.onUpdate)
             hooks.onUpdate(proc, deltaTime);
 
+        // frame(N) longo ou só fibers adormecidas (resumeTime = a mais cedo)
+        if (proc->state != FiberState::DEAD && proc->resumeTime > parkAfter)
+        {
+            parkProcess(proc);
+            continue;
+        }
+
         i++;
     }
 
@@ -364,6 +647,9 @@ void Interpreter::update(float deltaTime)
     }
     cleanProcesses.clear();
 
+    // Fim do frame: nenhuma fiber a correr, safe point do GC
+    checkGC();
+
     if (frameCount % 300 == 0)
     {
         size_t poolSize = ProcessPool::instance().size();
@@ -386,17 +672,40 @@ void Interpreter::run_process_step(Process *proc)
     Fiber *fiber = get_ready_fiber(proc);
     if (!fiber)
     {
+        // Fibers suspensas (yield/I/O) mantêm o processo vivo; o processo
+        // pode dormir até à mais cedo (o update() decide se o tira da lista)
+        bool alive = false;
+        float wake = FLT_MAX;
+        for (int f = 0; f < proc->nextFiberIndex; f++)
+        {
+            const Fiber &other = proc->fibers[f];
+            if (other.state == FiberState::DEAD)
+                continue;
+            alive = true;
+            if (other.resumeTime < wake)
+                wake = other.resumeTime;
+        }
+        if (alive)
+        {
+            proc->resumeTime = wake;
+            return;
+        }
 
         //   Warning("No ready fiber");
         proc->state = FiberState::DEAD;
         return;
     }
 
+    // RUNNING: resumeTime só conta para o update() adormecer o processo
+    proc->resumeTime = currentTime;
+
     currentProcess = proc;
     currentFiber = fiber;
 
     proc->current = fiber;
+    inScheduler_ = true;
     FiberResult result = run_fiber(fiber, proc);
+    inScheduler_ = false;
 
     // printf("  Executing Fiber %d\n", fiber - proc->fibers);
     //  Warning("  [run_process_step] result.reason=%d, instructions=%d",   (int)result.reason, result.instructionsRun);
@@ -436,6 +745,58 @@ void Interpreter::run_process_step(Process *proc)
         // Warning("  [run_process_step] Fiber DONE");
         return;
     }
+
+    // FIBER_WAIT: suspendFiber() já marcou a fiber, fica até resumeFiber()
+}
+
+bool Interpreter::canSuspendFiber() const
+{
+    // Reentrada (callFunction/callMethod a partir de C++) espera pelo
+    // retorno síncrono, aí não há scheduler para retomar a fiber
+    return inScheduler_ && fiberRunDepth_ == 1 && currentFiber && currentProcess &&
+           currentFiber >= currentProcess->fibers &&
+           currentFiber < currentProcess->fibers + currentProcess->nextFiberIndex;
+}
+
+FiberTicket Interpreter::suspendFiber()
+{
+    FiberTicket ticket;
+    if (!canSuspendFiber())
+        return ticket;
+
+    ticket.procId = currentProcess->id;
+    ticket.fiber = (int)(currentFiber - currentProcess->fibers);
+
+    currentFiber->state = FiberState::SUSPENDED;
+    currentFiber->resumeTime = FLT_MAX;
+    fiberSuspended_ = true;
+    return ticket;
+}
+
+Fiber *Interpreter::waitingFiber(const FiberTicket &ticket)
+{
+    // O processo pode ter morrido (e sido reciclado) entretanto
+    Process *proc = findProcess(ticket.procId);
+    if (!proc || proc->state == FiberState::DEAD || ticket.fiber >= proc->nextFiberIndex)
+        return nullptr;
+
+    Fiber *fiber = &proc->fibers[ticket.fiber];
+    if (fiber->state != FiberState::SUSPENDED || fiber->resumeTime != FLT_MAX)
+        return nullptr;
+    return fiber;
+}
+
+bool Interpreter::resumeFiber(const FiberTicket &ticket, Value result)
+{
+    Fiber *fiber = waitingFiber(ticket);
+    if (!fiber)
+        return false;
+
+    // Substitui o placeholder que o native deixou no topo da stack
+    fiber->stackTop[-1] = result;
+    fiber->resumeTime = currentTime;
+    wakeProcess(findProcess(ticket.procId));
+    return true;
 }
 
 void Interpreter::render()
@@ -63,7 +63,7 @@ bool toNumberPair(const Value &a, const Value &b, double &da, double &db)
 
 static const char* getValueTypeName(const Value &v)
 {
-    switch (v.type)
+    switch (v.getType())
     {
         case ValueType::NIL:                 return "nil";
         case ValueType::BOOL:                return "bool";
@@ -102,6 +102,17 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
     currentFiber = fiber;
 
+    // Conta a profundidade para canSuspendFiber() (natives que reentram)
+    struct RunDepth
+    {
+        int &depth;
+        explicit RunDepth(int &d) : depth(d) { depth++; }
+        ~RunDepth() { depth--; }
+    } runDepth(fiberRunDepth_);
+
+    // Contentores criados por este fiber contam neste VM
+    GCPayloadScope payloadScope(gcPayloadBytes);
+
     CallFrame *frame;
     Value *stackStart;
     uint8 *ip;
@@ -125,6 +136,22 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
     Value a = fiber->stackTop[-2]; \
     fiber->stackTop -= 2
 
+// Quickening: o opcode genérico (ip[-1]) especializa-se pelos tipos dos operandos
+#ifdef USE_QUICKENING
+#define QUICKEN_BINARY(opII, opDD)                                      \
+    do                                                                  \
+    {                                                                   \
+        const Value &qb = fiber->stackTop[-1];                          \
+        const Value &qa = fiber->stackTop[-2];                          \
+        if (qa.isInt() && qb.isInt())                                   \
+            ip[-1] = (opII);                                            \
+        else if (qa.isDouble() && qb.isDouble())                        \
+            ip[-1] = (opDD);                                            \
+    } while (0)
+#else
+#define QUICKEN_BINARY(opII, opDD) ((void)0)
+#endif
+
 #define STORE_FRAME() frame->ip = ip
 
 #define THROW_RUNTIME_ERROR(fmt, ...)                                \
@@ -158,6 +185,14 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
         func = frame->func;                            \
     } while (false)
 
+    // Um native pode reentrar na VM e fazer crescer a stack/frames desta fiber
+#define REFRESH_FRAME()                                \
+    do                                                 \
+    {                                                  \
+        frame = &fiber->frames[fiber->frameCount - 1]; \
+        stackStart = frame->slots;                     \
+    } while (false)
+
     static const void *dispatch_table[] = {
         // Literals (0-3)
         &&op_constant,
@@ -281,6 +316,31 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
         // Multi-return (88)
         &&op_return_n,
+
+        // Superinstruções (89-93)
+        &&op_get_local_get_local_add,
+        &&op_local_less_const_jump,
+        &&op_local_less_local_jump,
+        &&op_inc_local,
+        &&op_get_property_self,
+
+        // Quickening (94-107)
+        &&op_add_ii,
+        &&op_add_dd,
+        &&op_subtract_ii,
+        &&op_subtract_dd,
+        &&op_multiply_ii,
+        &&op_multiply_dd,
+        &&op_less_ii,
+        &&op_less_dd,
+        &&op_less_equal_ii,
+        &&op_less_equal_dd,
+        &&op_greater_ii,
+        &&op_greater_dd,
+        &&op_greater_equal_ii,
+        &&op_greater_equal_dd,
+
+        &&op_concat,
     };
 
 #define SAFE_CALL_NATIVE(fiber, argCount, callFunc)                                    \
@@ -315,6 +375,15 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             *_dest = makeNil();                                                        \
             (fiber)->stackTop = _dest + 1;                                             \
         }                                                                              \
+        REFRESH_FRAME();                                                               \
+                                                                                       \
+        /* 6. O native suspendeu a fiber (I/O): volta ao scheduler */                  \
+        if (UNLIKELY(fiberSuspended_))                                                 \
+        {                                                                              \
+            fiberSuspended_ = false;                                                   \
+            STORE_FRAME();                                                             \
+            return {FiberResult::FIBER_WAIT, instructionsRun, 0, 0};                   \
+        }                                                                              \
     } while (0)
 
 #define DISPATCH()                         \
@@ -400,6 +469,10 @@ op_set_private:
 {
     uint8 index = READ_BYTE();
     process->privates[index] = PEEK();
+#ifdef BU_ENABLE_SPATIAL
+    if (index <= (uint8)PrivateIndex::Z)
+        spatialTouch(process);
+#endif
     DISPATCH();
 }
 
@@ -436,6 +509,8 @@ op_define_global:
 // ============================================
 op_add:
 {
+    QUICKEN_BINARY(OP_ADD_II, OP_ADD_DD);
+op_add_generic:
     BINARY_OP_PREP();
 
     // ---------------------------------------------------------
@@ -534,28 +609,36 @@ op_add:
 
     else if (a.isNumber() && b.isNumber())
     {
-        // Caminho rápido: Inteiros
-        if (a.isInt() && b.isInt())
-        {
-            PUSH(makeInt(a.asInt() + b.asInt()));
-        }
-        // Caminho misto: Converte tudo para double
-        else
-        {
-            double da = a.isInt() ? (double)a.asInt() : a.asDouble();
-            double db = b.isInt() ? (double)b.asInt() : b.asDouble();
-            PUSH(makeDouble(da + db));
-        }
+        PUSH(addNumbers(a, b));
         DISPATCH();
     }
 
     THROW_RUNTIME_ERROR("Cannot apply '+' to %s and %s", getValueTypeName(a), getValueTypeName(b));
 }
 // ============================================
+// OP_CONCAT: cadeia de '+' com strings, um só buffer
+// ============================================
+op_concat:
+{
+    uint8 count = READ_BYTE();
+    Value *values = fiber->stackTop - count;
+    Value result, errLeft, errRight;
+    if (!concatValues(values, count, &result, &errLeft, &errRight))
+    {
+        fiber->stackTop = values;
+        THROW_RUNTIME_ERROR("Cannot apply '+' to %s and %s", getValueTypeName(errLeft), getValueTypeName(errRight));
+    }
+    fiber->stackTop = values;
+    PUSH(result);
+    DISPATCH();
+}
+// ============================================
 // OP_SUBTRACT
 // ============================================
 op_subtract:
 {
+    QUICKEN_BINARY(OP_SUBTRACT_II, OP_SUBTRACT_DD);
+op_subtract_generic:
     BINARY_OP_PREP();
 
          if (a.isNumber() && b.isNumber())
@@ -600,6 +683,8 @@ op_subtract:
 // ============================================
 op_multiply:
 {
+    QUICKEN_BINARY(OP_MULTIPLY_II, OP_MULTIPLY_DD);
+op_multiply_generic:
     BINARY_OP_PREP();
 
             if (a.isNumber() && b.isNumber())
@@ -810,6 +895,8 @@ op_not_equal:
 
 op_greater:
 {
+    QUICKEN_BINARY(OP_GREATER_II, OP_GREATER_DD);
+op_greater_generic:
     BINARY_OP_PREP();
 
     double da, db;
@@ -824,6 +911,8 @@ op_greater:
 
 op_greater_equal:
 {
+    QUICKEN_BINARY(OP_GREATER_EQUAL_II, OP_GREATER_EQUAL_DD);
+op_greater_equal_generic:
     BINARY_OP_PREP();
 
     double da, db;
@@ -837,6 +926,8 @@ op_greater_equal:
 
 op_less:
 {
+    QUICKEN_BINARY(OP_LESS_II, OP_LESS_DD);
+op_less_generic:
     BINARY_OP_PREP();
 
     double da, db;
@@ -853,6 +944,8 @@ op_less:
 
 op_less_equal:
 {
+    QUICKEN_BINARY(OP_LESS_EQUAL_II, OP_LESS_EQUAL_DD);
+op_less_equal_generic:
     BINARY_OP_PREP();
     double da, db;
     if (!toNumberPair(a, b, da, db))
@@ -951,9 +1044,11 @@ op_jump_if_false:
 op_loop:
 {
     uint16 offset = READ_SHORT();
-
     ip -= offset;
 
+    // Back-edge: safe point do GC
+    checkGC();
+
     DISPATCH();
 }
 
@@ -965,6 +1060,9 @@ op_call:
 
     STORE_FRAME();
 
+    // Entrada de frame: safe point do GC (callee e args na stack)
+    checkGC();
+
     Value callee = NPEEK(argCount);
 
     // ========================================
@@ -988,7 +1086,7 @@ op_call:
             return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
         }
 
-        if (fiber->frameCount >= FRAMES_MAX)
+        if (!ensureFiber(fiber, functionStackSize(targetFunc)))
         {
             runtimeError("Stack overflow");
             return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
@@ -1030,7 +1128,13 @@ op_call:
     // ========================================
     else if (callee.isProcess())
     {
-        int index = callee.asProcessId();
+        uint32 index = (uint32)callee.asProcessId();
+        // Ids de instâncias (father) também são PROCESS, mas não se chamam
+        if (ProcessTable::isHandle(index) || index >= processes.size())
+        {
+            runtimeError("Invalid process");
+            return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
+        }
         ProcessDef *blueprint = processes[index];
 
         if (!blueprint)
@@ -1050,6 +1154,10 @@ op_call:
 
         // SPAWN - clona blueprint
         Process *instance = spawnProcess(blueprint);
+        if (!instance)
+        {
+            return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
+        }
 
         // Se tem argumentos, inicializa locals da fiber
         if (argCount > 0)
@@ -1095,7 +1203,7 @@ op_call:
     // ========================================
     else if (callee.isStruct())
     {
-        int index = callee.as.integer;
+        int index = callee.rawInt();
         StructDef *def = structs[index];
 
         if (argCount > def->argCount)
@@ -1105,19 +1213,13 @@ op_call:
             return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
         }
 
-        Value value = makeStructInstance();
-        StructInstance *instance = value.as.sInstance;
-        instance->def = def;
-
-        instance->values.reserve(def->argCount);
+        Value value = makeStructInstance(def);
+        StructInstance *instance = value.asStructInstance();
+        Value *values = instance->values();
         Value *args = fiber->stackTop - argCount;
         for (int i = 0; i < argCount; i++)
         {
-            instance->values.push(args[i]);
-        }
-        for (int i = argCount; i < def->argCount; i++)
-        {
-            instance->values.push(makeNil());
+            values[i] = args[i];
         }
         fiber->stackTop -= (argCount + 1);
         PUSH(value);
@@ -1133,23 +1235,8 @@ op_call:
         int classId = callee.asClassId();
         ClassDef *klass = classes[classId];
 
-        Value value = makeClassInstance();
+        Value value = makeClassInstance(klass);
         ClassInstance *instance = value.asClassInstance();
-        instance->klass = klass;
-        instance->fields.reserve(klass->fieldCount);
-
-        // Inicializa fields com valores default ou nil
-        for (int i = 0; i < klass->fieldCount; i++)
-        {
-            if (i < (int)klass->fieldDefaults.size() && !klass->fieldDefaults[i].isNil())
-            {
-                instance->fields.push(klass->fieldDefaults[i]);
-            }
-            else
-            {
-                instance->fields.push(makeNil());
-            }
-        }
 
         // Verifica se há NativeClass na cadeia de herança (direta ou indireta)
         NativeClassDef *nativeKlass = instance->getNativeSuperclass();
@@ -1160,6 +1247,7 @@ op_call:
             {
                 // O constructor nativo cria o userData
                 instance->nativeUserData = nativeKlass->constructor(this, 0, nullptr);
+                REFRESH_FRAME();
             }
             else
             {
@@ -1181,7 +1269,7 @@ op_call:
                 return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
             }
 
-            if (currentFiber->frameCount >= FRAMES_MAX)
+            if (!ensureFiber(currentFiber, functionStackSize(klass->constructor)))
             {
                 runtimeError("Stack overflow");
                 return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
@@ -1223,7 +1311,23 @@ op_call:
         }
 
         Value *args = fiber->stackTop - argCount;
+
+        // Classe valor: dados inline, uma só alocação
+        if (klass->valueSize)
+        {
+            Value literal = makeNativeValue(klass);
+            if (klass->valueConstructor)
+            {
+                klass->valueConstructor(this, literal.asNativeClassInstance()->userData, argCount, args);
+                REFRESH_FRAME();
+            }
+            fiber->stackTop -= (argCount + 1);
+            PUSH(literal);
+            DISPATCH();
+        }
+
         void *userData = klass->constructor(this, argCount, args);
+        REFRESH_FRAME();
 
         if (!userData)
         {
@@ -1233,7 +1337,7 @@ op_call:
         }
 
         Value literal = makeNativeClassInstance(klass->persistent);
-        NativeClassInstance *instance = literal.as.sClassInstance;
+        NativeClassInstance *instance = literal.asNativeClassInstance();
 
         instance->klass = klass;
         instance->userData = userData;
@@ -1254,17 +1358,17 @@ op_call:
         int structId = callee.asNativeStructId();
         NativeStructDef *def = nativeStructs[structId];
 
-        void *data = arena.Allocate(def->structSize);
-        std::memset(data, 0, def->structSize);
+        void *data = allocNativeStructData(def);
 
         if (def->constructor)
         {
             Value *args = fiber->stackTop - argCount;
             def->constructor(this, data, argCount, args);
+            REFRESH_FRAME();
         }
 
         Value literal = makeNativeStructInstance(def->persistent);
-        NativeStructInstance *instance = literal.as.sNativeStruct;
+        NativeStructInstance *instance = literal.asNativeStructInstance();
 
         instance->def = def;
         instance->data = data;
@@ -1282,8 +1386,8 @@ op_call:
     // ========================================
     else if (callee.isModuleRef())
     {
-        uint16 moduleId = (callee.as.unsignedInteger >> 16) & 0xFFFF;
-        uint16 funcId = callee.as.unsignedInteger & 0xFFFF;
+        uint16 moduleId = (callee.rawUInt() >> 16) & 0xFFFF;
+        uint16 funcId = callee.rawUInt() & 0xFFFF;
 
         if (moduleId >= modules.size())
         {
@@ -1336,7 +1440,7 @@ op_call:
             return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
         }
 
-        if (fiber->frameCount >= FRAMES_MAX)
+        if (!ensureFiber(fiber, functionStackSize(targetFunc)))
         {
             runtimeError("Stack overflow");
             return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
@@ -1385,6 +1489,7 @@ op_return:
         {
             Upvalue *upvalue = openUpvalues;
             upvalue->closed = *upvalue->location;
+            writeBarrier(upvalue->closed);
             upvalue->location = &upvalue->closed;
             openUpvalues = upvalue->nextOpen;
         }
@@ -1442,6 +1547,9 @@ op_return:
     *fiber->stackTop++ = result;
 
     LOAD_FRAME();
+
+    // Saída de frame: safe point do GC (o resultado já está na stack)
+    checkGC();
     DISPATCH();
     // printf("end");
 }
@@ -1538,6 +1646,12 @@ op_spawn:
     newFiber->resumeTime = 0;
     newFiber->stackTop = newFiber->stack;
     newFiber->frameCount = 0;
+    if (!ensureFiber(newFiber, functionStackSize(func)))
+    {
+        newFiber->state = FiberState::DEAD;
+        runtimeError("Out of memory creating fiber");
+        return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
+    }
 
     newFiber->stack[0] = callee; // Slot 0 = Função
 
@@ -1612,6 +1726,7 @@ op_get_property:
 {
     Value object = PEEK();
     Value nameValue = READ_CONSTANT();
+    InlineCache *ic = &func->caches[READ_SHORT()];
 
     // printf("\nGet Object: '");
     // printValue(object);
@@ -1653,7 +1768,7 @@ op_get_property:
 
             int processId = object.asProcessId();
 
-            Process *proc = aliveProcesses[processId];
+            Process *proc = findProcess((uint32)processId);
             if (!proc)
             {
                 runtimeError("Process '%i' is dead or invalid", processId);
@@ -1662,6 +1777,7 @@ op_get_property:
             int privateIdx = getProcessPrivateIndex(name);
             if (privateIdx != -1)
             {
+                DROP();
                 PUSH(proc->privates[privateIdx]);
             }
             else
@@ -1683,12 +1799,18 @@ op_get_property:
                 runtimeError("Struct is null");
                 return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
             }
+            if (ICEntry *entry = ic->find(inst->def))
+            {
+                DROP();
+                PUSH(inst->values()[entry->slot]);
+                DISPATCH();
+            }
             uint8 value = 0;
             if (inst->def->names.get(nameValue.asString(), &value))
             {
-
+                ic->addField(inst->def, value);
                 DROP();
-                PUSH(inst->values[value]);
+                PUSH(inst->values()[value]);
             }
             else
             {
@@ -1704,13 +1826,27 @@ op_get_property:
         {
             ClassInstance *instance = object.asClassInstance();
 
-            // bool inherited = instance->klass->inherited;
+            if (ICEntry *entry = ic->find(instance->klass))
+            {
+                DROP();
+                if (entry->kind == ICKind::FIELD)
+                {
+                    PUSH(instance->fields()[entry->slot]);
+                }
+                else
+                {
+                    Value result = entry->property.getter(this, instance->nativeUserData);
+                    PUSH(result);
+                }
+                DISPATCH();
+            }
 
             uint8_t fieldIdx;
             if (instance->klass->fieldNames.get(nameValue.asString(), &fieldIdx))
             {
+                ic->addField(instance->klass, fieldIdx);
                 DROP();
-                PUSH(instance->fields[fieldIdx]);
+                PUSH(instance->fields()[fieldIdx]);
                 DISPATCH();
             }
 
@@ -1718,6 +1854,7 @@ op_get_property:
             NativeProperty nativeProp;
             if (instance->getNativeProperty(nameValue.asString(), &nativeProp))
             {
+                ic->addNativeProperty(instance->klass, nativeProp);
                 DROP(); // Remove object
                 // Chama getter nativo com userData do híbrido
                 Value result = nativeProp.getter(this, instance->nativeUserData);
@@ -1736,9 +1873,19 @@ op_get_property:
 
             NativeClassInstance *instance = object.asNativeClassInstance();
             NativeClassDef *klass = instance->klass;
+
+            if (ICEntry *entry = ic->find(klass))
+            {
+                DROP();
+                Value result = entry->property.getter(this, instance->userData);
+                PUSH(result);
+                DISPATCH();
+            }
+
             NativeProperty prop;
             if (instance->klass->properties.get(nameValue.asString(), &prop))
             {
+                ic->addNativeProperty(klass, prop);
                 DROP(); // Remove object
 
                 //  Chama getter
@@ -1821,7 +1968,7 @@ op_get_property:
             MapInstance *map = object.asMap();
             String *key = nameValue.asString();
             Value result;
-            if (map->table.get(key, &result))
+            if (map->table.get(nameValue, &result))
             {
                 DROP();
                 PUSH(result);
@@ -1854,6 +2001,8 @@ op_set_property:
     Value value = PEEK();
     Value object = PEEK2();
     Value nameValue = READ_CONSTANT();
+    InlineCache *ic = &func->caches[READ_SHORT()];
+    writeBarrier(value);
 
     // printf("Set Value: '");
     // printValue(value);
@@ -1883,7 +2032,7 @@ op_set_property:
     if (object.isProcess())
     {
         int processId = object.asProcessId();
-        Process *proc = aliveProcesses[processId];
+        Process *proc = findProcess((uint32)processId);
 
         if (!proc) // || proc->state == FiberState::DEAD)
         {
@@ -1901,6 +2050,10 @@ op_set_property:
                 return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
             }
             proc->privates[privateIdx] = value;
+#ifdef BU_ENABLE_SPATIAL
+            if (privateIdx <= (int)PrivateIndex::Z)
+                spatialTouch(proc);
+#endif
             DROP();      // Remove value
             DROP();      // Remove process
             PUSH(value); // Assignment retorna valor
@@ -1922,9 +2075,14 @@ op_set_property:
         }
 
         uint8 valueIndex = 0;
-        if (inst->def->names.get(nameValue.asString(), &valueIndex))
+        if (ICEntry *entry = ic->find(inst->def))
+        {
+            inst->values()[entry->slot] = value;
+        }
+        else if (inst->def->names.get(nameValue.asString(), &valueIndex))
         {
-            inst->values[valueIndex] = value;
+            ic->addField(inst->def, valueIndex);
+            inst->values()[valueIndex] = value;
         }
         else
         {
@@ -1944,10 +2102,23 @@ op_set_property:
     {
         ClassInstance *instance = object.asClassInstance();
 
+        if (ICEntry *entry = ic->find(instance->klass))
+        {
+            if (entry->kind == ICKind::FIELD)
+                instance->fields()[entry->slot] = value;
+            else
+                entry->property.setter(this, instance->nativeUserData, value);
+            DROP();      // Remove value
+            DROP();      // Remove object
+            PUSH(value); // Push value back
+            DISPATCH();
+        }
+
         uint8_t fieldIdx;
         if (instance->klass->fieldNames.get(nameValue.asString(), &fieldIdx))
         {
-            instance->fields[fieldIdx] = value;
+            ic->addField(instance->klass, fieldIdx);
+            instance->fields()[fieldIdx] = value;
             // Stack: [obj, value] -> queremos [value]
             DROP();      // Remove value
             DROP();      // Remove object
@@ -1966,6 +2137,7 @@ op_set_property:
                 return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
             }
             // Chama setter nativo
+            ic->addNativeProperty(instance->klass, nativeProp);
             nativeProp.setter(this, instance->nativeUserData, value);
             DROP();      // Remove value
             DROP();      // Remove object
@@ -1983,6 +2155,16 @@ op_set_property:
 
         NativeClassInstance *instance = object.asNativeClassInstance();
         NativeClassDef *klass = instance->klass;
+
+        if (ICEntry *entry = ic->find(klass))
+        {
+            entry->property.setter(this, instance->userData, value);
+            DROP(); // Remove value
+            DROP(); // Remove object
+            PUSH(value);
+            DISPATCH();
+        }
+
         NativeProperty prop;
         if (instance->klass->properties.get(nameValue.asString(), &prop))
         {
@@ -1994,6 +2176,7 @@ op_set_property:
             }
 
             // Chama setter
+            ic->addNativeProperty(klass, prop);
             prop.setter(this, instance->userData, value);
             // Stack: [obj, value] -> queremos [value]
             DROP(); // Remove value
@@ -2135,6 +2318,7 @@ op_invoke:
 {
     Value nameValue = READ_CONSTANT();
     uint8_t argCount = READ_BYTE();
+    InlineCache *ic = &func->caches[READ_SHORT()];
 
     if (!nameValue.isString())
     {
@@ -2417,7 +2601,7 @@ op_invoke:
                     // Cria string de 1 char
                     char buf[2] = {strChars[i], '\0'};
 
-                    ptr->values.push(makeString(createString(buf, 1)));
+                    ptr->values.push(makeString(newString(buf, 1)));
                 }
             }
             else
@@ -2433,7 +2617,7 @@ op_invoke:
                 {
                     int partLen = found - current;
 
-                    ptr->values.push(makeString(createString(current, partLen)));
+                    ptr->values.push(makeString(newString(current, partLen)));
 
                     // Avança ponteiro
                     current = found + sepLen;
@@ -2444,7 +2628,7 @@ op_invoke:
                 int remaining = end - current;
                 if (remaining >= 0)
                 {
-                    ptr->values.push(makeString(createString(current, remaining)));
+                    ptr->values.push(makeString(newString(current, remaining)));
                 }
             }
 
@@ -2473,6 +2657,7 @@ op_invoke:
                 return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
             }
             Value item = PEEK();
+            writeBarrier(item);
             arr->values.push(item);
 
             ARGS_CLEANUP();
@@ -2591,6 +2776,7 @@ op_invoke:
                 return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
             }
             Value item = NPEEK(0);
+            writeBarrier(item);
             arr->values.insert(valueindex, item);
             ARGS_CLEANUP();
             PUSH(receiver);
@@ -2776,6 +2962,7 @@ op_invoke:
             }
 
             Value fillValue = PEEK();
+            writeBarrier(fillValue);
 
             for (uint32 i = 0; i < size; i++)
             {
@@ -2809,15 +2996,7 @@ op_invoke:
 
             Value key = PEEK();
 
-            if (!key.isString())
-            {
-                runtimeError("Map key must be string");
-                ARGS_CLEANUP();
-                PUSH(makeBool(false));
-                DISPATCH();
-            }
-
-            bool exists = map->table.exist(key.asString());
+            bool exists = map->table.exist(key);
             ARGS_CLEANUP();
             PUSH(makeBool(exists));
             DISPATCH();
@@ -2832,16 +3011,9 @@ op_invoke:
 
             Value key = PEEK();
 
-            if (!key.isString())
-            {
-                runtimeError("Map key must be string");
-                ARGS_CLEANUP();
-                PUSH(makeNil());
-                DISPATCH();
-            }
-
             //  HashMap não tem remove, mas podes setar para nil
-            map->table.set(key.asString(), makeNil());
+            writeBarrier(key);
+            map->table.set(key, makeNil());
             ARGS_CLEANUP();
             PUSH(makeNil());
             DISPATCH();
@@ -2882,8 +3054,8 @@ op_invoke:
             Value keys = makeArray();
             ArrayInstance *keysInstance = keys.asArray();
 
-            map->table.forEach([&](String *key, Value value)
-                               { keysInstance->values.push(makeString(key)); });
+            map->table.forEach([&](Value key, Value value)
+                               { keysInstance->values.push(key); });
 
             ARGS_CLEANUP();
             PUSH(keys);
@@ -2901,7 +3073,7 @@ op_invoke:
             Value values = makeArray();
             ArrayInstance *valueInstance = values.asArray();
 
-            map->table.forEach([&](String *key, Value value)
+            map->table.forEach([&](Value key, Value value)
                                { valueInstance->values.push(value); });
 
             ARGS_CLEANUP();
@@ -2917,8 +3089,25 @@ op_invoke:
         // printValueNl(receiver);
         // printValueNl(nameValue);
 
-        Function *method;
-        if (instance->getMethod(nameValue.asString(), &method))
+        Function *method = nullptr;
+        NativeMethod nativeMethod = nullptr;
+        if (ICEntry *entry = ic->find(instance->klass))
+        {
+            if (entry->kind == ICKind::METHOD)
+                method = entry->method;
+            else
+                nativeMethod = entry->native;
+        }
+        else if (instance->getMethod(nameValue.asString(), &method))
+        {
+            ic->addMethod(instance->klass, method);
+        }
+        else if (instance->getNativeMethod(nameValue.asString(), &nativeMethod))
+        {
+            ic->addNativeMethod(instance->klass, nativeMethod);
+        }
+
+        if (method)
         {
             if (argCount != method->arity)
             {
@@ -2930,7 +3119,8 @@ op_invoke:
             fiber->stackTop[-argCount - 1] = receiver;
 
             // Setup call frame
-            if (currentFiber->frameCount >= FRAMES_MAX)
+            STORE_FRAME();
+            if (!ensureFiber(currentFiber, functionStackSize(method)))
             {
                 runtimeError("Stack overflow in method!");
                 return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
@@ -2944,15 +3134,13 @@ op_invoke:
 
             currentFiber->frameCount++;
 
-            STORE_FRAME();
             LOAD_FRAME();
 
             DISPATCH();
         }
 
-        // Verifica métodos herdados da NativeClass
-        NativeMethod nativeMethod;
-        if (instance->getNativeMethod(nameValue.asString(), &nativeMethod))
+        // Método herdado da NativeClass
+        if (nativeMethod)
         {
             // 1. Calcular OFFSET (seguro contra realloc)
             size_t _slot = (fiber->stackTop - fiber->stack) - argCount - 1;
@@ -2981,6 +3169,7 @@ op_invoke:
                 *_dest = makeNil();
                 fiber->stackTop = _dest + 1;
             }
+            REFRESH_FRAME();
             DISPATCH();
         }
 
@@ -2997,7 +3186,15 @@ op_invoke:
         NativeClassDef *klass = instance->klass;
 
         NativeMethod method;
-        if (!instance->klass->methods.get(nameValue.asString(), &method))
+        if (ICEntry *entry = ic->find(klass))
+        {
+            method = entry->native;
+        }
+        else if (instance->klass->methods.get(nameValue.asString(), &method))
+        {
+            ic->addNativeMethod(klass, method);
+        }
+        else
         {
             runtimeError("Native class '%s' has no method '%s'", klass->name->chars(), name);
             return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
@@ -3021,6 +3218,7 @@ op_invoke:
             *dest = makeNil();
             fiber->stackTop = dest + 1;
         }
+        REFRESH_FRAME();
 
         DISPATCH();
     }
@@ -3793,7 +3991,7 @@ op_invoke:
                 memcpy(temp, buf->data + buf->cursor, length);
                 temp[length] = 0;
 
-                String *str = createString(temp);
+                String *str = newString(temp);
                 free(temp);
 
                 buf->cursor += length;
@@ -3994,7 +4192,8 @@ op_super_invoke:
         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
     }
 
-    if (fiber->frameCount >= FRAMES_MAX)
+    STORE_FRAME();
+    if (!ensureFiber(fiber, functionStackSize(method)))
     {
         runtimeError("Stack overflow");
         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
@@ -4007,7 +4206,6 @@ op_super_invoke:
     newFrame->slots = fiber->stackTop - argCount - 1;
     fiber->frameCount++;
 
-    STORE_FRAME();
     LOAD_FRAME();
     DISPATCH();
 }
@@ -4057,14 +4255,14 @@ op_define_map:
         Value value = POP();
         Value key = POP();
 
-        if (!key.isString())
+        if (key.isNil())
         {
-            runtimeError("Map key must be string");
+            runtimeError("Map key cannot be nil");
             PUSH(makeNil());
             DISPATCH();
         }
 
-        inst->table.set(key.asString(), value);
+        inst->table.set(key, value);
     }
 
     PUSH(map);
@@ -4075,6 +4273,8 @@ op_set_index:
     Value value = POP();
     Value index = POP();
     Value container = POP();
+    writeBarrier(value);
+    writeBarrier(index);
 
     // printValue(value);
     // printf(" value \n");
@@ -4117,14 +4317,14 @@ op_set_index:
     // === MAP  ===
     if (container.isMap())
     {
-        if (!index.isString())
+        if (index.isNil())
         {
-            runtimeError("Map key must be string");
+            runtimeError("Map key cannot be nil");
              return {FiberResult::ERROR, instructionsRun, 0, 0};
         }
 
         MapInstance *map = container.asMap();
-        map->table.set(index.asString(), value);
+        map->table.set(index, value);
 
         PUSH(value); // Assignment returns value
         DISPATCH();
@@ -4266,16 +4466,10 @@ op_get_index:
     // === MAP   ===
     if (container.isMap())
     {
-        if (!index.isString())
-        {
-            runtimeError("Map key must be string");
-            return {FiberResult::ERROR, instructionsRun, 0, 0};
-        }
-
         MapInstance *map = container.asMap();
         Value result;
 
-        if (map->table.get(index.asString(), &result))
+        if (map->table.get(index, &result))
         {
             PUSH(result);
         }
@@ -4383,20 +4577,18 @@ op_foreach_start:
 
 op_iter_next:
 {
-
     Value iter = POP();
     Value seq = POP();
 
-    if (!seq.isArray())
+    int index = 0;
+    int more = iterNext(seq, iter, &index);
+    if (more < 0)
     {
-        runtimeError(" Iterator next Type is not iterable");
+        runtimeError("Iterator next Type is not iterable");
         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
     }
 
-    ArrayInstance *array = seq.as.array;
-    int index = iter.isNil() ? 0 : iter.as.integer + 1;
-
-    if (index < (int)array->values.size())
+    if (more)
     {
         PUSH(makeInt(index));
         PUSH(makeBool(true));
@@ -4411,26 +4603,19 @@ op_iter_next:
 
 op_iter_value:
 {
-
     Value iter = POP();
     Value seq = POP();
 
-    if (!seq.isArray())
+    Value item;
+    if (!iterValue(seq, iter.rawInt(), &item))
     {
-        runtimeError("Iterator Type is not iterable");
+        runtimeError(seq.isArray() || seq.isMap() || seq.isBuffer() || seq.isString()
+                         ? "Iterator out of bounds"
+                         : "Iterator Type is not iterable");
         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
     }
 
-    ArrayInstance *array = seq.as.array;
-    int index = iter.as.integer;
-
-    if (index < 0 || index >= (int)array->values.size())
-    {
-        runtimeError("Iterator out of bounds");
-        return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
-    }
-
-    PUSH(array->values[index]);
+    PUSH(item);
 
     DISPATCH();
 }
@@ -5111,12 +5296,10 @@ op_closure:
     Value funcVal = READ_CONSTANT();
     int funcID = funcVal.asFunctionId();
     Function *function = functions[funcID];
-    Value closure = makeClosure();
-    Closure *closurePtr = closure.as.closure;
+    Value closure = makeClosure(function->upvalueCount);
+    Closure *closurePtr = closure.asClosure();
     closurePtr->functionId = funcID;
-    closurePtr->upvalueCount = function->upvalueCount;
-
-    closurePtr->upvalues.clear();
+    Upvalue **upvalues = closurePtr->upvalues();
 
     for (int i = 0; i < function->upvalueCount; i++)
     {
@@ -5139,7 +5322,7 @@ op_closure:
 
             if (upvalue != nullptr && upvalue->location == local)
             {
-                closurePtr->upvalues.push(upvalue);
+                upvalues[i] = upvalue;
             }
             else
             {
@@ -5155,17 +5338,17 @@ op_closure:
                     prev->nextOpen = created;
                 }
 
-                closurePtr->upvalues.push(created);
+                upvalues[i] = created;
             }
         }
         else
         {
-            if (!frame->closure)
+            if (!frame->closure || i >= frame->closure->upvalueCount)
             {
                 runtimeError("Cannot capture upvalue without enclosing closure");
                 return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
             }
-            closurePtr->upvalues.push(frame->closure->upvalues[i]);
+            upvalues[i] = frame->closure->upvalues()[i];
         }
     }
 
@@ -5183,7 +5366,7 @@ op_get_upvalue:
         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
     }
 
-    PUSH(*frame->closure->upvalues[slot]->location);
+    PUSH(*frame->closure->upvalues()[slot]->location);
     DISPATCH();
 }
 
@@ -5197,7 +5380,8 @@ op_set_upvalue:
         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
     }
 
-    *frame->closure->upvalues[slot]->location = PEEK();
+    writeBarrier(PEEK());
+    *frame->closure->upvalues()[slot]->location = PEEK();
     DISPATCH();
 }
 
@@ -5208,6 +5392,7 @@ op_close_upvalue:
     {
         Upvalue *upvalue = openUpvalues;
         upvalue->closed = *upvalue->location;
+        writeBarrier(upvalue->closed);
         upvalue->location = &upvalue->closed;
         openUpvalues = upvalue->nextOpen;
     }
@@ -5241,6 +5426,7 @@ op_return_n:
         {
             Upvalue *upvalue = openUpvalues;
             upvalue->closed = *upvalue->location;
+            writeBarrier(upvalue->closed);
             upvalue->location = &upvalue->closed;
             openUpvalues = upvalue->nextOpen;
         }
@@ -5309,9 +5495,185 @@ op_return_n:
     }
 
     LOAD_FRAME();
+    checkGC();
     DISPATCH();
 }
 
+    // ========== SUPERINSTRUÇÕES (peephole) ==========
+
+op_get_local_get_local_add:
+{
+    Value a = stackStart[READ_BYTE()];
+    Value b = stackStart[READ_BYTE()];
+    if (a.isInt() && b.isInt())
+    {
+        PUSH(makeInt(a.asInt() + b.asInt()));
+        DISPATCH();
+    }
+    if (a.isDouble() && b.isDouble())
+    {
+        PUSH(makeDouble(a.asDouble() + b.asDouble()));
+        DISPATCH();
+    }
+    // Strings, mistos, erros: caminho normal do OP_ADD
+    PUSH(a);
+    PUSH(b);
+    goto op_add_generic;
+}
+
+op_local_less_const_jump:
+{
+    Value a = stackStart[READ_BYTE()];
+    Value b = READ_CONSTANT();
+    uint16 offset = READ_SHORT();
+    bool less;
+    if (a.isInt() && b.isInt())
+    {
+        less = a.asInt() < b.asInt();
+    }
+    else
+    {
+        double da, db;
+        if (!toNumberPair(a, b, da, db))
+        {
+            THROW_RUNTIME_ERROR("Operands '<' must be numbers");
+        }
+        less = da < db;
+    }
+    PUSH(makeBool(less));
+    if (!less)
+        ip += offset;
+    DISPATCH();
+}
+
+op_local_less_local_jump:
+{
+    Value a = stackStart[READ_BYTE()];
+    Value b = stackStart[READ_BYTE()];
+    uint16 offset = READ_SHORT();
+    bool less;
+    if (a.isInt() && b.isInt())
+    {
+        less = a.asInt() < b.asInt();
+    }
+    else
+    {
+        double da, db;
+        if (!toNumberPair(a, b, da, db))
+        {
+            THROW_RUNTIME_ERROR("Operands '<' must be numbers");
+        }
+        less = da < db;
+    }
+    PUSH(makeBool(less));
+    if (!less)
+        ip += offset;
+    DISPATCH();
+}
+
+op_inc_local:
+{
+    Value &local = stackStart[READ_BYTE()];
+    Value k = READ_CONSTANT();
+    if (local.isInt())
+    {
+        local = makeInt(local.asInt() + k.asInt());
+    }
+    else if (local.isDouble())
+    {
+        local = makeDouble(local.asDouble() + (double)k.asInt());
+    }
+    else if (local.isString())
+    {
+        String *right = stringPool.toString(k.asInt());
+        local = makeString(stringPool.concat(local.asString(), right));
+    }
+    else if (local.isNumber())
+    {
+        local = makeDouble(local.asDouble() + (double)k.asInt());
+    }
+    else
+    {
+        THROW_RUNTIME_ERROR("Cannot apply '+' to %s and %s", getValueTypeName(local), getValueTypeName(k));
+    }
+    DISPATCH();
+}
+
+op_get_property_self:
+{
+    Value self = stackStart[0];
+    if (self.isClassInstance())
+    {
+        ClassInstance *instance = self.asClassInstance();
+        InlineCache *ic = &func->caches[(uint16)((ip[2] << 8) | ip[3])];
+        ICEntry *entry = ic->find(instance->klass);
+        if (entry && entry->kind == ICKind::FIELD)
+        {
+            ip += 4;
+            PUSH(instance->fields()[entry->slot]);
+            DISPATCH();
+        }
+    }
+    // Miss: GET_LOCAL 0 + OP_GET_PROPERTY (os operandos são os mesmos)
+    PUSH(self);
+    goto op_get_property;
+}
+
+    // ========== QUICKENING ==========
+    // Guarda falhou: o sítio volta ao opcode genérico, que o executa
+    // e pode voltar a especializar na próxima passagem.
+
+#define QUICK_BINARY(guard, result, genericOp, genericLabel) \
+{                                        \
+    Value b = fiber->stackTop[-1];       \
+    Value a = fiber->stackTop[-2];       \
+    if (LIKELY(guard))                   \
+    {                                    \
+        fiber->stackTop[-2] = (result);  \
+        fiber->stackTop--;               \
+        DISPATCH();                      \
+    }                                    \
+    ip[-1] = (genericOp);                \
+    goto genericLabel;                   \
+}
+
+op_add_ii:
+    QUICK_BINARY(a.isInt() && b.isInt(), makeInt(a.asInt() + b.asInt()), OP_ADD, op_add_generic);
+op_add_dd:
+    QUICK_BINARY(a.isDouble() && b.isDouble(), makeDouble(a.asDouble() + b.asDouble()), OP_ADD, op_add_generic);
+
+op_subtract_ii:
+    QUICK_BINARY(a.isInt() && b.isInt(), makeInt(a.asInt() - b.asInt()), OP_SUBTRACT, op_subtract_generic);
+op_subtract_dd:
+    QUICK_BINARY(a.isDouble() && b.isDouble(), makeDouble(a.asDouble() - b.asDouble()), OP_SUBTRACT, op_subtract_generic);
+
+op_multiply_ii:
+    QUICK_BINARY(a.isInt() && b.isInt(), makeInt(a.asInt() * b.asInt()), OP_MULTIPLY, op_multiply_generic);
+op_multiply_dd:
+    QUICK_BINARY(a.isDouble() && b.isDouble(), makeDouble(a.asDouble() * b.asDouble()), OP_MULTIPLY, op_multiply_generic);
+
+op_less_ii:
+    QUICK_BINARY(a.isInt() && b.isInt(), makeBool(a.asInt() < b.asInt()), OP_LESS, op_less_generic);
+op_less_dd:
+    QUICK_BINARY(a.isDouble() && b.isDouble(), makeBool(a.asDouble() < b.asDouble()), OP_LESS, op_less_generic);
+
+op_less_equal_ii:
+    QUICK_BINARY(a.isInt() && b.isInt(), makeBool(a.asInt() <= b.asInt()), OP_LESS_EQUAL, op_less_equal_generic);
+op_less_equal_dd:
+    QUICK_BINARY(a.isDouble() && b.isDouble(), makeBool(a.asDouble() <= b.asDouble()), OP_LESS_EQUAL, op_less_equal_generic);
+
+op_greater_ii:
+    QUICK_BINARY(a.isInt() && b.isInt(), makeBool(a.asInt() > b.asInt()), OP_GREATER, op_greater_generic);
+op_greater_dd:
+    QUICK_BINARY(a.isDouble() && b.isDouble(), makeBool(a.asDouble() > b.asDouble()), OP_GREATER, op_greater_generic);
+
+op_greater_equal_ii:
+    QUICK_BINARY(a.isInt() && b.isInt(), makeBool(a.asInt() >= b.asInt()), OP_GREATER_EQUAL, op_greater_equal_generic);
+op_greater_equal_dd:
+    QUICK_BINARY(a.isDouble() && b.isDouble(), makeBool(a.asDouble() >= b.asDouble()), OP_GREATER_EQUAL, op_greater_equal_generic);
+
+#undef QUICK_BINARY
+
 // Cleanup macros
 
 #undef READ_BYTE
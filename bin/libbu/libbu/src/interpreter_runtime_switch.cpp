@@ -57,7 +57,7 @@ bool toNumberPair(const Value &a, const Value &b, double &da, double &db)
 
 static const char* getValueTypeName(const Value &v)
 {
-    switch (v.type)
+    switch (v.getType())
     {
         case ValueType::NIL:                 return "nil";
         case ValueType::BOOL:                return "bool";
@@ -96,6 +96,17 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
     currentFiber = fiber;
 
+    // Conta a profundidade para canSuspendFiber() (natives que reentram)
+    struct RunDepth
+    {
+        int &depth;
+        explicit RunDepth(int &d) : depth(d) { depth++; }
+        ~RunDepth() { depth--; }
+    } runDepth(fiberRunDepth_);
+
+    // Contentores criados por este fiber contam neste VM
+    GCPayloadScope payloadScope(gcPayloadBytes);
+
     CallFrame *frame;
     Value *stackStart;
     uint8 *ip;
@@ -119,6 +130,22 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
     Value a = fiber->stackTop[-2]; \
     fiber->stackTop -= 2
 
+// Quickening: o opcode genérico (ip[-1]) especializa-se pelos tipos dos operandos
+#ifdef USE_QUICKENING
+#define QUICKEN_BINARY(opII, opDD)                                      \
+    do                                                                  \
+    {                                                                   \
+        const Value &qb = fiber->stackTop[-1];                          \
+        const Value &qa = fiber->stackTop[-2];                          \
+        if (qa.isInt() && qb.isInt())                                   \
+            ip[-1] = (opII);                                            \
+        else if (qa.isDouble() && qb.isDouble())                        \
+            ip[-1] = (opDD);                                            \
+    } while (0)
+#else
+#define QUICKEN_BINARY(opII, opDD) ((void)0)
+#endif
+
 #define STORE_FRAME() frame->ip = ip
 
 #define LOAD_FRAME()                                   \
@@ -131,6 +158,14 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
         func = frame->func;                            \
     } while (false)
 
+    // Um native pode reentrar na VM e fazer crescer a stack/frames desta fiber
+#define REFRESH_FRAME()                                \
+    do                                                 \
+    {                                                  \
+        frame = &fiber->frames[fiber->frameCount - 1]; \
+        stackStart = frame->slots;                     \
+    } while (false)
+
 #define THROW_RUNTIME_ERROR(fmt, ...)                                \
     do                                                               \
     {                                                                \
@@ -190,6 +225,15 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             *_dest = makeNil();                                                        \
             (fiber)->stackTop = _dest + 1;                                             \
         }                                                                              \
+        REFRESH_FRAME();                                                               \
+                                                                                       \
+        /* 6. O native suspendeu a fiber (I/O): volta ao scheduler */                  \
+        if (UNLIKELY(fiberSuspended_))                                                 \
+        {                                                                              \
+            fiberSuspended_ = false;                                                   \
+            STORE_FRAME();                                                             \
+            return {FiberResult::FIBER_WAIT, instructionsRun, 0, 0};                   \
+        }                                                                              \
     } while (0)
 
     // ===== LOOP PRINCIPAL =====
@@ -311,6 +355,10 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
         {
             uint8 index = READ_BYTE();
             process->privates[index] = PEEK();
+#ifdef BU_ENABLE_SPATIAL
+            if (index <= (uint8)PrivateIndex::Z)
+                spatialTouch(process);
+#endif
             break;
         }
 
@@ -346,6 +394,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
         // ============================================
         case OP_ADD:
         {
+            QUICKEN_BINARY(OP_ADD_II, OP_ADD_DD);
+        op_add_generic:
             BINARY_OP_PREP();
 
             // ---------------------------------------------------------
@@ -444,18 +494,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
             else if (a.isNumber() && b.isNumber())
             {
-                // Caminho rápido: Inteiros
-                if (a.isInt() && b.isInt())
-                {
-                    PUSH(makeInt(a.asInt() + b.asInt()));
-                }
-                // Caminho misto: Converte tudo para double
-                else
-                {
-                    double da = a.isInt() ? (double)a.asInt() : a.asDouble();
-                    double db = b.isInt() ? (double)b.asInt() : b.asDouble();
-                    PUSH(makeDouble(da + db));
-                }
+                PUSH(addNumbers(a, b));
                 break;
             }
 
@@ -463,11 +502,32 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             break;
         }
 
+        // ============================================
+        // OP_CONCAT: cadeia de '+' com strings, um só buffer
+        // ============================================
+        case OP_CONCAT:
+        {
+            uint8 count = READ_BYTE();
+            Value *values = fiber->stackTop - count;
+            Value result, errLeft, errRight;
+            if (!concatValues(values, count, &result, &errLeft, &errRight))
+            {
+                fiber->stackTop = values;
+                THROW_RUNTIME_ERROR("Cannot apply '+' to %s and %s", getValueTypeName(errLeft), getValueTypeName(errRight));
+                break;
+            }
+            fiber->stackTop = values;
+            PUSH(result);
+            break;
+        }
+
         // ============================================
         // OP_SUBTRACT
         // ============================================
         case OP_SUBTRACT:
         {
+            QUICKEN_BINARY(OP_SUBTRACT_II, OP_SUBTRACT_DD);
+        op_subtract_generic:
             BINARY_OP_PREP();
 
             if (a.isNumber() && b.isNumber())
@@ -513,6 +573,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
         // ============================================
         case OP_MULTIPLY:
         {
+            QUICKEN_BINARY(OP_MULTIPLY_II, OP_MULTIPLY_DD);
+        op_multiply_generic:
             BINARY_OP_PREP();
 
             if (a.isNumber() && b.isNumber())
@@ -704,6 +766,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
         case OP_GREATER:
         {
+            QUICKEN_BINARY(OP_GREATER_II, OP_GREATER_DD);
+        op_greater_generic:
             BINARY_OP_PREP();
             double da, db;
             if (!toNumberPair(a, b, da, db))
@@ -716,6 +780,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
         case OP_GREATER_EQUAL:
         {
+            QUICKEN_BINARY(OP_GREATER_EQUAL_II, OP_GREATER_EQUAL_DD);
+        op_greater_equal_generic:
             BINARY_OP_PREP();
             double da, db;
             if (!toNumberPair(a, b, da, db))
@@ -728,6 +794,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
         case OP_LESS:
         {
+            QUICKEN_BINARY(OP_LESS_II, OP_LESS_DD);
+        op_less_generic:
             BINARY_OP_PREP();
             double da, db;
             if (!toNumberPair(a, b, da, db))
@@ -740,6 +808,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
         case OP_LESS_EQUAL:
         {
+            QUICKEN_BINARY(OP_LESS_EQUAL_II, OP_LESS_EQUAL_DD);
+        op_less_equal_generic:
             BINARY_OP_PREP();
             double da, db;
             if (!toNumberPair(a, b, da, db))
@@ -841,6 +911,9 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             uint16 offset = READ_SHORT();
             ip -= offset;
 
+            // Back-edge: safe point do GC
+            checkGC();
+
             break;
         }
 
@@ -852,6 +925,9 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
             STORE_FRAME();
 
+            // Entrada de frame: safe point do GC (callee e args na stack)
+            checkGC();
+
             Value callee = NPEEK(argCount);
 
             // printf("Call : (");
@@ -882,7 +958,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
                 }
 
-                if (fiber->frameCount >= FRAMES_MAX)
+                if (!ensureFiber(fiber, functionStackSize(func)))
                 {
                     runtimeError("Stack overflow");
                     return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
@@ -916,7 +992,13 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             else if (callee.isProcess())
             {
 
-                int index = callee.asProcessId();
+                uint32 index = (uint32)callee.asProcessId();
+                // Ids de instâncias (father) também são PROCESS, mas não se chamam
+                if (ProcessTable::isHandle(index) || index >= processes.size())
+                {
+                    runtimeError("Invalid process");
+                    return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
+                }
                 ProcessDef *blueprint = processes[index];
 
                 if (!blueprint)
@@ -937,6 +1019,10 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
                 // SPAWN - clona blueprint
                 Process *instance = spawnProcess(blueprint);
+                if (!instance)
+                {
+                    return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
+                }
 
                 // Se tem argumentos, inicializa locals da fiber
                 if (argCount > 0)
@@ -981,7 +1067,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             }
             else if (callee.isStruct())
             {
-                int index = callee.as.integer;
+                int index = callee.rawInt();
 
                 StructDef *def = structs[index];
 
@@ -991,20 +1077,13 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
                 }
 
-                Value value = makeStructInstance();
-                StructInstance *instance = value.as.sInstance;
-                instance->marked = 0;
-                instance->def = def;
-
-                instance->values.reserve(def->argCount);
+                Value value = makeStructInstance(def);
+                StructInstance *instance = value.asStructInstance();
+                Value *values = instance->values();
                 Value *args = fiber->stackTop - argCount;
                 for (int i = 0; i < argCount; i++)
                 {
-                    instance->values.push(args[i]);
-                }
-                for (int i = argCount; i < def->argCount; i++)
-                {
-                    instance->values.push(makeNil());
+                    values[i] = args[i];
                 }
                 fiber->stackTop -= (argCount + 1);
                 PUSH(value);
@@ -1015,23 +1094,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 int classId = callee.asClassId();
                 ClassDef *klass = classes[classId];
 
-                Value value = makeClassInstance();
+                Value value = makeClassInstance(klass);
                 ClassInstance *instance = value.asClassInstance();
-                instance->klass = klass;
-                instance->fields.reserve(klass->fieldCount);
-
-                // Inicializa fields com valores default ou nil
-                for (int i = 0; i < klass->fieldCount; i++)
-                {
-                    if (i < (int)klass->fieldDefaults.size() && !klass->fieldDefaults[i].isNil())
-                    {
-                        instance->fields.push(klass->fieldDefaults[i]);
-                    }
-                    else
-                    {
-                        instance->fields.push(makeNil());
-                    }
-                }
 
                 // Verifica se há NativeClass na cadeia de herança (direta ou indireta)
                 NativeClassDef *nativeKlass = instance->getNativeSuperclass();
@@ -1042,6 +1106,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     {
                         // O constructor nativo cria o userData
                         instance->nativeUserData = nativeKlass->constructor(this, 0, nullptr);
+                        REFRESH_FRAME();
                     }
                     else
                     {
@@ -1062,7 +1127,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
                     }
 
-                    if (currentFiber->frameCount >= FRAMES_MAX)
+                    if (!ensureFiber(currentFiber, functionStackSize(klass->constructor)))
                     {
                         runtimeError("Stack overflow");
                         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
@@ -1076,7 +1141,6 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
                     currentFiber->frameCount++;
 
-                    STORE_FRAME();
                     LOAD_FRAME();
                 }
                 else
@@ -1099,7 +1163,23 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 }
 
                 Value *args = fiber->stackTop - argCount;
+
+                // Classe valor: dados inline, uma só alocação
+                if (klass->valueSize)
+                {
+                    Value literal = makeNativeValue(klass);
+                    if (klass->valueConstructor)
+                    {
+                        klass->valueConstructor(this, literal.asNativeClassInstance()->userData, argCount, args);
+                        REFRESH_FRAME();
+                    }
+                    fiber->stackTop -= (argCount + 1);
+                    PUSH(literal);
+                    break;
+                }
+
                 void *userData = klass->constructor(this, argCount, args);
+                REFRESH_FRAME();
 
                 if (!userData)
                 {
@@ -1108,7 +1188,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 }
                 Value literal = makeNativeClassInstance(klass->persistent);
                 // Cria instance wrapper
-                NativeClassInstance *instance = literal.as.sClassInstance;
+                NativeClassInstance *instance = literal.asNativeClassInstance();
 
                 instance->klass = klass;
                 instance->userData = userData;
@@ -1125,17 +1205,17 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 int structId = callee.asNativeStructId();
                 NativeStructDef *def = nativeStructs[structId];
 
-                void *data = arena.Allocate(def->structSize);
-                std::memset(data, 0, def->structSize);
+                void *data = allocNativeStructData(def);
                 if (def->constructor)
                 {
                     Value *args = fiber->stackTop - argCount;
                     def->constructor(this, data, argCount, args);
+                    REFRESH_FRAME();
                 }
 
                 Value literal = makeNativeStructInstance(def->persistent);
                 // Cria instance wrapper
-                NativeStructInstance *instance = literal.as.sNativeStruct;
+                NativeStructInstance *instance = literal.asNativeStructInstance();
 
                 instance->def = def;
                 instance->data = data;
@@ -1148,9 +1228,9 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             }
             else if (callee.isModuleRef())
             {
-                uint32 packed = callee.as.unsignedInteger;
-                uint16 moduleId = (callee.as.unsignedInteger >> 16) & 0xFFFF;
-                uint16 funcId = callee.as.unsignedInteger & 0xFFFF;
+                uint32 packed = callee.rawUInt();
+                uint16 moduleId = (callee.rawUInt() >> 16) & 0xFFFF;
+                uint16 funcId = callee.rawUInt() & 0xFFFF;
 
                 if (moduleId >= modules.size())
                 {
@@ -1201,7 +1281,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
                 }
 
-                if (fiber->frameCount >= FRAMES_MAX)
+                if (!ensureFiber(fiber, functionStackSize(targetFunc)))
                 {
                     runtimeError("Stack overflow");
                     return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
@@ -1249,6 +1329,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 {
                     Upvalue *upvalue = openUpvalues;
                     upvalue->closed = *upvalue->location;
+                    writeBarrier(upvalue->closed);
                     upvalue->location = &upvalue->closed;
                     openUpvalues = upvalue->nextOpen;
                 }
@@ -1308,6 +1389,9 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             *fiber->stackTop++ = result;
             LOAD_FRAME();
 
+            // Saída de frame: safe point do GC (o resultado já está na stack)
+            checkGC();
+
             break;
         }
 
@@ -1337,6 +1421,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 {
                     Upvalue *upvalue = openUpvalues;
                     upvalue->closed = *upvalue->location;
+                    writeBarrier(upvalue->closed);
                     upvalue->location = &upvalue->closed;
                     openUpvalues = upvalue->nextOpen;
                 }
@@ -1405,6 +1490,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             }
 
             LOAD_FRAME();
+            checkGC();
             break;
         }
 
@@ -1498,6 +1584,12 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             newFiber->resumeTime = 0;
             newFiber->stackTop = newFiber->stack;
             newFiber->frameCount = 0;
+            if (!ensureFiber(newFiber, functionStackSize(func)))
+            {
+                newFiber->state = FiberState::DEAD;
+                runtimeError("Out of memory creating fiber");
+                return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
+            }
 
             newFiber->stack[0] = callee; // Slot 0 = Função
 
@@ -1574,8 +1666,10 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
         case OP_GET_PROPERTY:
         {
+        op_get_property_generic:
             Value object = PEEK();
             Value nameValue = READ_CONSTANT();
+            InlineCache *ic = &func->caches[READ_SHORT()];
 
             // printf("\nGet Object: '");
             // printValue(object);
@@ -1617,7 +1711,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
                     int processId = object.asProcessId();
 
-                    Process *proc = aliveProcesses[processId];
+                    Process *proc = findProcess((uint32)processId);
                     if (!proc)
                     {
                         runtimeError("Process '%i' is dead or invalid", processId);
@@ -1626,6 +1720,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     int privateIdx = getProcessPrivateIndex(name);
                     if (privateIdx != -1)
                     {
+                        DROP();
                         PUSH(proc->privates[privateIdx]);
                     }
                     else
@@ -1647,12 +1742,18 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                         runtimeError("Struct is null");
                         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
                     }
+                    if (ICEntry *entry = ic->find(inst->def))
+                    {
+                        DROP();
+                        PUSH(inst->values()[entry->slot]);
+                        break;
+                    }
                     uint8 value = 0;
                     if (inst->def->names.get(nameValue.asString(), &value))
                     {
-
+                        ic->addField(inst->def, value);
                         DROP();
-                        PUSH(inst->values[value]);
+                        PUSH(inst->values()[value]);
                     }
                     else
                     {
@@ -1668,13 +1769,27 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 {
                     ClassInstance *instance = object.asClassInstance();
 
-                    // bool inherited = instance->klass->inherited;
+                    if (ICEntry *entry = ic->find(instance->klass))
+                    {
+                        DROP();
+                        if (entry->kind == ICKind::FIELD)
+                        {
+                            PUSH(instance->fields()[entry->slot]);
+                        }
+                        else
+                        {
+                            Value result = entry->property.getter(this, instance->nativeUserData);
+                            PUSH(result);
+                        }
+                        break;
+                    }
 
                     uint8_t fieldIdx;
                     if (instance->klass->fieldNames.get(nameValue.asString(), &fieldIdx))
                     {
+                        ic->addField(instance->klass, fieldIdx);
                         DROP();
-                        PUSH(instance->fields[fieldIdx]);
+                        PUSH(instance->fields()[fieldIdx]);
                         break;
                     }
 
@@ -1682,6 +1797,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     NativeProperty nativeProp;
                     if (instance->getNativeProperty(nameValue.asString(), &nativeProp))
                     {
+                        ic->addNativeProperty(instance->klass, nativeProp);
                         DROP(); // Remove object
                         // Chama getter nativo com userData do híbrido
                         Value result = nativeProp.getter(this, instance->nativeUserData);
@@ -1700,9 +1816,19 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
                     NativeClassInstance *instance = object.asNativeClassInstance();
                     NativeClassDef *klass = instance->klass;
+
+                    if (ICEntry *entry = ic->find(klass))
+                    {
+                        DROP();
+                        Value result = entry->property.getter(this, instance->userData);
+                        PUSH(result);
+                        break;
+                    }
+
                     NativeProperty prop;
                     if (instance->klass->properties.get(nameValue.asString(), &prop))
                     {
+                        ic->addNativeProperty(klass, prop);
                         DROP(); // Remove object
 
                         //  Chama getter
@@ -1786,7 +1912,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     MapInstance *map = object.asMap();
                     String *key = nameValue.asString();
                     Value result;
-                    if (map->table.get(key, &result))
+                    if (map->table.get(nameValue, &result))
                     {
                         DROP();
                         PUSH(result);
@@ -1819,6 +1945,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             Value value = PEEK();
             Value object = PEEK2();
             Value nameValue = READ_CONSTANT();
+            InlineCache *ic = &func->caches[READ_SHORT()];
+            writeBarrier(value);
 
             // printf("Set Value: '");
             // printValue(value);
@@ -1848,7 +1976,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             if (object.isProcess())
             {
                 int processId = object.asProcessId();
-                Process *proc = aliveProcesses[processId];
+                Process *proc = findProcess((uint32)processId);
 
                 if (!proc) // || proc->state == FiberState::DEAD)
                 {
@@ -1866,6 +1994,10 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
                     }
                     proc->privates[privateIdx] = value;
+#ifdef BU_ENABLE_SPATIAL
+                    if (privateIdx <= (int)PrivateIndex::Z)
+                        spatialTouch(proc);
+#endif
                     DROP();      // Remove value
                     DROP();      // Remove process
                     PUSH(value); // Assignment retorna valor
@@ -1886,9 +2018,14 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 }
 
                 uint8 valueIndex = 0;
-                if (inst->def->names.get(nameValue.asString(), &valueIndex))
+                if (ICEntry *entry = ic->find(inst->def))
                 {
-                    inst->values[valueIndex] = value;
+                    inst->values()[entry->slot] = value;
+                }
+                else if (inst->def->names.get(nameValue.asString(), &valueIndex))
+                {
+                    ic->addField(inst->def, valueIndex);
+                    inst->values()[valueIndex] = value;
                 }
                 else
                 {
@@ -1907,10 +2044,23 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             {
                 ClassInstance *instance = object.asClassInstance();
 
+                if (ICEntry *entry = ic->find(instance->klass))
+                {
+                    if (entry->kind == ICKind::FIELD)
+                        instance->fields()[entry->slot] = value;
+                    else
+                        entry->property.setter(this, instance->nativeUserData, value);
+                    DROP();      // Remove value
+                    DROP();      // Remove object
+                    PUSH(value); // Push value back
+                    break;
+                }
+
                 uint8_t fieldIdx;
                 if (instance->klass->fieldNames.get(nameValue.asString(), &fieldIdx))
                 {
-                    instance->fields[fieldIdx] = value;
+                    ic->addField(instance->klass, fieldIdx);
+                    instance->fields()[fieldIdx] = value;
                     // Stack: [obj, value] -> queremos [value]
                     DROP();      // Remove value
                     DROP();      // Remove object
@@ -1929,6 +2079,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
                     }
                     // Chama setter nativo
+                    ic->addNativeProperty(instance->klass, nativeProp);
                     nativeProp.setter(this, instance->nativeUserData, value);
                     DROP();      // Remove value
                     DROP();      // Remove object
@@ -1946,6 +2097,16 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
                 NativeClassInstance *instance = object.asNativeClassInstance();
                 NativeClassDef *klass = instance->klass;
+
+                if (ICEntry *entry = ic->find(klass))
+                {
+                    entry->property.setter(this, instance->userData, value);
+                    DROP(); // Remove value
+                    DROP(); // Remove object
+                    PUSH(value);
+                    break;
+                }
+
                 NativeProperty prop;
                 if (instance->klass->properties.get(nameValue.asString(), &prop))
                 {
@@ -1957,6 +2118,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     // Chama setter
+                    ic->addNativeProperty(klass, prop);
                     prop.setter(this, instance->userData, value);
                     // Stack: [obj, value] -> queremos [value]
                     DROP(); // Remove value
@@ -2097,6 +2259,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
         {
             Value nameValue = READ_CONSTANT();
             uint8_t argCount = READ_BYTE();
+            InlineCache *ic = &func->caches[READ_SHORT()];
 
             if (!nameValue.isString())
             {
@@ -2379,7 +2542,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                             // Cria string de 1 char
                             char buf[2] = {strChars[i], '\0'};
 
-                            ptr->values.push(makeString(createString(buf, 1)));
+                            ptr->values.push(makeString(newString(buf, 1)));
                         }
                     }
                     else
@@ -2396,7 +2559,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                             int partLen = found - current;
 
                             // create() já trata de alocar e internar a string
-                            ptr->values.push(makeString(createString(current, partLen)));
+                            ptr->values.push(makeString(newString(current, partLen)));
 
                             // Avança ponteiro
                             current = found + sepLen;
@@ -2407,7 +2570,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                         int remaining = end - current;
                         if (remaining >= 0)
                         {
-                            ptr->values.push(makeString(createString(current, remaining)));
+                            ptr->values.push(makeString(newString(current, remaining)));
                         }
                     }
 
@@ -2435,6 +2598,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
                     }
                     Value item = PEEK();
+                    writeBarrier(item);
                     arr->values.push(item);
 
                     ARGS_CLEANUP();
@@ -2553,6 +2717,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
                     }
                     Value item = NPEEK(0);
+                    writeBarrier(item);
                     arr->values.insert(valueindex, item);
                     ARGS_CLEANUP();
                     PUSH(receiver);
@@ -2738,6 +2903,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     }
 
                     Value fillValue = PEEK();
+                    writeBarrier(fillValue);
 
                     for (uint32 i = 0; i < size; i++)
                     {
@@ -2770,15 +2936,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
                     Value key = PEEK();
 
-                    if (!key.isString())
-                    {
-                        runtimeError("Map key must be string");
-                        ARGS_CLEANUP();
-                        PUSH(makeBool(false));
-                        break;
-                    }
-
-                    bool exists = map->table.exist(key.asString());
+                    bool exists = map->table.exist(key);
                     ARGS_CLEANUP();
                     PUSH(makeBool(exists));
                     break;
@@ -2793,16 +2951,9 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
                     Value key = PEEK();
 
-                    if (!key.isString())
-                    {
-                        runtimeError("Map key must be string");
-                        ARGS_CLEANUP();
-                        PUSH(makeNil());
-                        break;
-                    }
-
                     //  HashMap não tem remove, mas podes setar para nil
-                    map->table.set(key.asString(), makeNil());
+                    writeBarrier(key);
+                    map->table.set(key, makeNil());
                     ARGS_CLEANUP();
                     PUSH(makeNil());
                     break;
@@ -2843,8 +2994,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     Value keys = makeArray();
                     ArrayInstance *keysInstance = keys.asArray();
 
-                    map->table.forEach([&](String *key, Value value)
-                                       { keysInstance->values.push(makeString(key)); });
+                    map->table.forEach([&](Value key, Value value)
+                                       { keysInstance->values.push(key); });
 
                     ARGS_CLEANUP();
                     PUSH(keys);
@@ -2862,7 +3013,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     Value values = makeArray();
                     ArrayInstance *valueInstance = values.asArray();
 
-                    map->table.forEach([&](String *key, Value value)
+                    map->table.forEach([&](Value key, Value value)
                                        { valueInstance->values.push(value); });
 
                     ARGS_CLEANUP();
@@ -2878,8 +3029,25 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 // printValueNl(receiver);
                 // printValueNl(nameValue);
 
-                Function *method;
-                if (instance->getMethod(nameValue.asString(), &method))
+                Function *method = nullptr;
+                NativeMethod nativeMethod = nullptr;
+                if (ICEntry *entry = ic->find(instance->klass))
+                {
+                    if (entry->kind == ICKind::METHOD)
+                        method = entry->method;
+                    else
+                        nativeMethod = entry->native;
+                }
+                else if (instance->getMethod(nameValue.asString(), &method))
+                {
+                    ic->addMethod(instance->klass, method);
+                }
+                else if (instance->getNativeMethod(nameValue.asString(), &nativeMethod))
+                {
+                    ic->addNativeMethod(instance->klass, nativeMethod);
+                }
+
+                if (method)
                 {
                     if (argCount != method->arity)
                     {
@@ -2891,7 +3059,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     fiber->stackTop[-argCount - 1] = receiver;
 
                     // Setup call frame
-                    if (currentFiber->frameCount >= FRAMES_MAX)
+                    STORE_FRAME();
+                    if (!ensureFiber(currentFiber, functionStackSize(method)))
                     {
                         runtimeError("Stack overflow in method!");
                         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
@@ -2905,15 +3074,13 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
                     currentFiber->frameCount++;
 
-                    STORE_FRAME();
                     LOAD_FRAME();
 
                     break;
                 }
 
-                // Verifica métodos herdados da NativeClass
-                NativeMethod nativeMethod;
-                if (instance->getNativeMethod(nameValue.asString(), &nativeMethod))
+                // Método herdado da NativeClass
+                if (nativeMethod)
                 {
                     size_t _slot = (fiber->stackTop - fiber->stack) - argCount - 1;
                     Value *_args = &fiber->stack[_slot + 1];
@@ -2933,6 +3100,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                         *_dest = makeNil();
                         fiber->stackTop = _dest + 1;
                     }
+                    REFRESH_FRAME();
                     break;
                 }
 
@@ -2949,7 +3117,15 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 NativeClassDef *klass = instance->klass;
 
                 NativeMethod method;
-                if (!instance->klass->methods.get(nameValue.asString(), &method))
+                if (ICEntry *entry = ic->find(klass))
+                {
+                    method = entry->native;
+                }
+                else if (instance->klass->methods.get(nameValue.asString(), &method))
+                {
+                    ic->addNativeMethod(klass, method);
+                }
+                else
                 {
                     runtimeError("Native class '%s' has no method '%s'", klass->name->chars(), name);
                     return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
@@ -2973,6 +3149,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     *dest = makeNil();
                     fiber->stackTop = dest + 1;
                 }
+                REFRESH_FRAME();
 
                 break;
             }
@@ -3747,7 +3924,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                         memcpy(temp, buf->data + buf->cursor, length);
                         temp[length] = 0;
 
-                        String *str = createString(temp);
+                        String *str = newString(temp);
                         free(temp);
 
                         buf->cursor += length;
@@ -3949,7 +4126,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
             }
 
-            if (fiber->frameCount >= FRAMES_MAX)
+            STORE_FRAME();
+            if (!ensureFiber(fiber, functionStackSize(method)))
             {
                 runtimeError("Stack overflow");
                 return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
@@ -3962,7 +4140,6 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             newFrame->slots = fiber->stackTop - argCount - 1;
             fiber->frameCount++;
 
-            STORE_FRAME();
             LOAD_FRAME();
             break;
         }
@@ -4012,13 +4189,13 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 Value value = POP();
                 Value key = POP();
 
-                if (!key.isString())
+                if (key.isNil())
                 {
-                    runtimeError("Map key must be string");
+                    runtimeError("Map key cannot be nil");
                    return {FiberResult::ERROR, instructionsRun, 0, 0};
                 }
 
-                inst->table.set(key.asString(), value);
+                inst->table.set(key, value);
             }
 
             PUSH(map);
@@ -4029,6 +4206,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             Value value = POP();
             Value index = POP();
             Value container = POP();
+            writeBarrier(value);
+            writeBarrier(index);
 
             // printValue(value);
             // printf(" value \n");
@@ -4072,14 +4251,14 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             // === MAP  ===
             if (container.isMap())
             {
-                if (!index.isString())
+                if (index.isNil())
                 {
-                    runtimeError("Map key must be string");
+                    runtimeError("Map key cannot be nil");
                     return {FiberResult::ERROR, instructionsRun, 0, 0};
                 }
 
                 MapInstance *map = container.asMap();
-                map->table.set(index.asString(), value);
+                map->table.set(index, value);
 
                 PUSH(value); // Assignment returns value
                 break;
@@ -4231,16 +4410,10 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             // === MAP   ===
             if (container.isMap())
             {
-                if (!index.isString())
-                {
-                    runtimeError("Map key must be string");
-                    return {FiberResult::ERROR, instructionsRun, 0, 0};
-                }
-
                 MapInstance *map = container.asMap();
                 Value result;
 
-                if (map->table.get(index.asString(), &result))
+                if (map->table.get(index, &result))
                 {
                     PUSH(result);
                 }
@@ -4249,7 +4422,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                     // Key não existe - retorna nil
                     PUSH(makeNil());
                 }
-                return {FiberResult::ERROR, instructionsRun, 0, 0};
+                break;
             }
 
             // === BUFER ===
@@ -4327,20 +4500,18 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
         }
         case OP_ITER_NEXT:
         {
-
             Value iter = POP();
             Value seq = POP();
 
-            if (!seq.isArray())
+            int index = 0;
+            int more = iterNext(seq, iter, &index);
+            if (more < 0)
             {
-                runtimeError(" Iterator next Type is not iterable");
+                runtimeError("Iterator next Type is not iterable");
                 return {FiberResult::ERROR, instructionsRun, 0, 0};
             }
 
-            ArrayInstance *array = seq.as.array;
-            int index = iter.isNil() ? 0 : iter.as.integer + 1;
-
-            if (index < (int)array->values.size())
+            if (more)
             {
                 PUSH(makeInt(index));
                 PUSH(makeBool(true));
@@ -4350,33 +4521,24 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 PUSH(makeNil());
                 PUSH(makeBool(false));
             }
-
-            //  printStack();
             break;
         }
 
         case OP_ITER_VALUE:
         {
-
             Value iter = POP();
             Value seq = POP();
 
-            if (!seq.isArray())
+            Value item;
+            if (!iterValue(seq, iter.rawInt(), &item))
             {
-                runtimeError("Iterator Type is not iterable");
+                runtimeError(seq.isArray() || seq.isMap() || seq.isBuffer() || seq.isString()
+                                 ? "Iterator out of bounds"
+                                 : "Iterator Type is not iterable");
                 return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
             }
 
-            ArrayInstance *array = seq.as.array;
-            int index = iter.as.integer;
-
-            if (index < 0 || index >= (int)array->values.size())
-            {
-                runtimeError("Iterator out of bounds");
-                return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
-            }
-
-            PUSH(array->values[index]);
+            PUSH(item);
 
             break;
         }
@@ -5047,12 +5209,10 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             Value funcVal = READ_CONSTANT();
             int funcID = funcVal.asFunctionId();
             Function *function = functions[funcID];
-            Value closure = makeClosure();
-            Closure *closurePtr = closure.as.closure;
+            Value closure = makeClosure(function->upvalueCount);
+            Closure *closurePtr = closure.asClosure();
             closurePtr->functionId = funcID;
-            closurePtr->upvalueCount = function->upvalueCount;
-
-            closurePtr->upvalues.clear();
+            Upvalue **upvalues = closurePtr->upvalues();
 
             for (int i = 0; i < function->upvalueCount; i++)
             {
@@ -5075,7 +5235,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
 
                     if (upvalue != nullptr && upvalue->location == local)
                     {
-                        closurePtr->upvalues.push(upvalue);
+                        upvalues[i] = upvalue;
                     }
                     else
                     {
@@ -5091,17 +5251,17 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                             prev->nextOpen = created;
                         }
 
-                        closurePtr->upvalues.push(created);
+                        upvalues[i] = created;
                     }
                 }
                 else
                 {
-                    if (!frame->closure)
+                    if (!frame->closure || i >= frame->closure->upvalueCount)
                     {
                         runtimeError("Cannot capture upvalue without enclosing closure");
                         return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
                     }
-                    closurePtr->upvalues.push(frame->closure->upvalues[i]);
+                    upvalues[i] = frame->closure->upvalues()[i];
                 }
             }
 
@@ -5119,7 +5279,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
             }
 
-            PUSH(*frame->closure->upvalues[slot]->location);
+            PUSH(*frame->closure->upvalues()[slot]->location);
             break;
         }
 
@@ -5133,7 +5293,8 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
                 return {FiberResult::FIBER_DONE, instructionsRun, 0, 0};
             }
 
-            *frame->closure->upvalues[slot]->location = PEEK();
+            writeBarrier(PEEK());
+            *frame->closure->upvalues()[slot]->location = PEEK();
             break;
         }
 
@@ -5144,6 +5305,7 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             {
                 Upvalue *upvalue = openUpvalues;
                 upvalue->closed = *upvalue->location;
+                writeBarrier(upvalue->closed);
                 upvalue->location = &upvalue->closed;
                 openUpvalues = upvalue->nextOpen;
             }
@@ -5151,6 +5313,159 @@ FiberResult Interpreter::run_fiber(Fiber *fiber, Process *process)
             break;
         }
 
+            // ========== SUPERINSTRUÇÕES (peephole) ==========
+
+        case OP_GET_LOCAL_GET_LOCAL_ADD:
+        {
+            Value a = stackStart[READ_BYTE()];
+            Value b = stackStart[READ_BYTE()];
+            if (a.isInt() && b.isInt())
+            {
+                PUSH(makeInt(a.asInt() + b.asInt()));
+                break;
+            }
+            if (a.isDouble() && b.isDouble())
+            {
+                PUSH(makeDouble(a.asDouble() + b.asDouble()));
+                break;
+            }
+            // Strings, mistos, erros: caminho normal do OP_ADD
+            PUSH(a);
+            PUSH(b);
+            goto op_add_generic;
+        }
+
+        case OP_LOCAL_LESS_CONST_JUMP:
+        case OP_LOCAL_LESS_LOCAL_JUMP:
+        {
+            Value a = stackStart[READ_BYTE()];
+            Value b = instruction == OP_LOCAL_LESS_CONST_JUMP ? READ_CONSTANT() : stackStart[READ_BYTE()];
+            uint16 offset = READ_SHORT();
+            bool less;
+            if (a.isInt() && b.isInt())
+            {
+                less = a.asInt() < b.asInt();
+            }
+            else
+            {
+                double da, db;
+                if (!toNumberPair(a, b, da, db))
+                {
+                    THROW_RUNTIME_ERROR("Operands '<' must be numbers");
+                    break;
+                }
+                less = da < db;
+            }
+            PUSH(makeBool(less));
+            if (!less)
+                ip += offset;
+            break;
+        }
+
+        case OP_INC_LOCAL:
+        {
+            Value &local = stackStart[READ_BYTE()];
+            Value k = READ_CONSTANT();
+            if (local.isInt())
+            {
+                local = makeInt(local.asInt() + k.asInt());
+            }
+            else if (local.isDouble())
+            {
+                local = makeDouble(local.asDouble() + (double)k.asInt());
+            }
+            else if (local.isString())
+            {
+                String *right = stringPool.toString(k.asInt());
+                local = makeString(stringPool.concat(local.asString(), right));
+            }
+            else if (local.isNumber())
+            {
+                local = makeDouble(local.asDouble() + (double)k.asInt());
+            }
+            else
+            {
+                THROW_RUNTIME_ERROR("Cannot apply '+' to %s and %s", getValueTypeName(local), getValueTypeName(k));
+                break;
+            }
+            break;
+        }
+
+        case OP_GET_PROPERTY_SELF:
+        {
+            Value self = stackStart[0];
+            if (self.isClassInstance())
+            {
+                ClassInstance *instance = self.asClassInstance();
+                InlineCache *ic = &func->caches[(uint16)((ip[2] << 8) | ip[3])];
+                ICEntry *entry = ic->find(instance->klass);
+                if (entry && entry->kind == ICKind::FIELD)
+                {
+                    ip += 4;
+                    PUSH(instance->fields()[entry->slot]);
+                    break;
+                }
+            }
+            // Miss: GET_LOCAL 0 + OP_GET_PROPERTY (os operandos são os mesmos)
+            PUSH(self);
+            goto op_get_property_generic;
+        }
+
+            // ========== QUICKENING ==========
+            // Guarda falhou: o sítio volta ao opcode genérico, que o executa
+            // e pode voltar a especializar na próxima passagem.
+
+#define QUICK_BINARY(guard, result, genericOp, genericLabel) \
+            {                                        \
+                Value b = fiber->stackTop[-1];       \
+                Value a = fiber->stackTop[-2];       \
+                if (LIKELY(guard))                   \
+                {                                    \
+                    fiber->stackTop[-2] = (result);  \
+                    fiber->stackTop--;               \
+                    break;                           \
+                }                                    \
+                ip[-1] = (genericOp);                \
+                goto genericLabel;                   \
+            }
+
+        case OP_ADD_II:
+            QUICK_BINARY(a.isInt() && b.isInt(), makeInt(a.asInt() + b.asInt()), OP_ADD, op_add_generic);
+        case OP_ADD_DD:
+            QUICK_BINARY(a.isDouble() && b.isDouble(), makeDouble(a.asDouble() + b.asDouble()), OP_ADD, op_add_generic);
+
+        case OP_SUBTRACT_II:
+            QUICK_BINARY(a.isInt() && b.isInt(), makeInt(a.asInt() - b.asInt()), OP_SUBTRACT, op_subtract_generic);
+        case OP_SUBTRACT_DD:
+            QUICK_BINARY(a.isDouble() && b.isDouble(), makeDouble(a.asDouble() - b.asDouble()), OP_SUBTRACT, op_subtract_generic);
+
+        case OP_MULTIPLY_II:
+            QUICK_BINARY(a.isInt() && b.isInt(), makeInt(a.asInt() * b.asInt()), OP_MULTIPLY, op_multiply_generic);
+        case OP_MULTIPLY_DD:
+            QUICK_BINARY(a.isDouble() && b.isDouble(), makeDouble(a.asDouble() * b.asDouble()), OP_MULTIPLY, op_multiply_generic);
+
+        case OP_LESS_II:
+            QUICK_BINARY(a.isInt() && b.isInt(), makeBool(a.asInt() < b.asInt()), OP_LESS, op_less_generic);
+        case OP_LESS_DD:
+            QUICK_BINARY(a.isDouble() && b.isDouble(), makeBool(a.asDouble() < b.asDouble()), OP_LESS, op_less_generic);
+
+        case OP_LESS_EQUAL_II:
+            QUICK_BINARY(a.isInt() && b.isInt(), makeBool(a.asInt() <= b.asInt()), OP_LESS_EQUAL, op_less_equal_generic);
+        case OP_LESS_EQUAL_DD:
+            QUICK_BINARY(a.isDouble() && b.isDouble(), makeBool(a.asDouble() <= b.asDouble()), OP_LESS_EQUAL, op_less_equal_generic);
+
+        case OP_GREATER_II:
+            QUICK_BINARY(a.isInt() && b.isInt(), makeBool(a.asInt() > b.asInt()), OP_GREATER, op_greater_generic);
+        case OP_GREATER_DD:
+            QUICK_BINARY(a.isDouble() && b.isDouble(), makeBool(a.asDouble() > b.asDouble()), OP_GREATER, op_greater_generic);
+
+        case OP_GREATER_EQUAL_II:
+            QUICK_BINARY(a.isInt() && b.isInt(), makeBool(a.asInt() >= b.asInt()), OP_GREATER_EQUAL, op_greater_equal_generic);
+        case OP_GREATER_EQUAL_DD:
+            QUICK_BINARY(a.isDouble() && b.isDouble(), makeBool(a.asDouble() >= b.asDouble()), OP_GREATER_EQUAL, op_greater_equal_generic);
+
+#undef QUICK_BINARY
+
         default:
         {
             Debug::dumpFunction(func);
@@ -0,0 +1,245 @@
+#include "interpreter.hpp"
+
+#ifdef BU_ENABLE_SPATIAL
+
+// ============================================
+// ÍNDICE ESPACIAL
+// Grelha hash sobre x/y/z dos processos. Só liga na primeira query: até lá
+// as escritas em x/y/z não custam nada. Depois disso OP_SET_PRIVATE (e
+// proc.x = ...) só marcam o processo; a grelha acerta-se no início de cada
+// query, por isso mexer várias vezes no mesmo frame custa um único place().
+// ============================================
+
+static FORCE_INLINE double privateNumber(const Value &v)
+{
+    return v.isNumber() ? v.asNumber() : 0.0;
+}
+
+void Interpreter::spatialRemove(Process *proc)
+{
+    spatialGrid.remove(proc);
+    proc->spatialDirty = false;
+    if (spatialQuery.caller == proc->id)
+        spatialQuery.active = false;
+}
+
+void Interpreter::spatialFlush()
+{
+    if (!spatialActive_)
+    {
+        // Primeira query: entra tudo o que está vivo
+        spatialActive_ = true;
+        spatialDirty.clear();
+        for (size_t i = 0; i < aliveProcesses.size(); i++)
+            spatialTouch(aliveProcesses[i]);
+    }
+
+    for (size_t i = 0; i < spatialDirty.size(); i++)
+    {
+        Process *proc = findProcess(spatialDirty[i]);
+        if (!proc || !proc->spatialDirty)
+            continue;
+        proc->spatialDirty = false;
+        if (proc->state == FiberState::DEAD)
+            continue;
+        spatialGrid.place(proc,
+                          privateNumber(proc->privates[(int)PrivateIndex::X]),
+                          privateNumber(proc->privates[(int)PrivateIndex::Y]),
+                          privateNumber(proc->privates[(int)PrivateIndex::Z]));
+    }
+    spatialDirty.clear();
+}
+
+void Interpreter::setSpatialCellSize(float size)
+{
+    if (size <= 0.0f || size == spatialGrid.getCellSize())
+        return;
+
+    spatialQuery.active = false;
+    for (size_t i = 0; i < aliveProcesses.size(); i++)
+        spatialGrid.remove(aliveProcesses[i]);
+    spatialGrid.clear();
+    spatialGrid.setCellSize(size);
+
+    if (spatialActive_)
+    {
+        for (size_t i = 0; i < aliveProcesses.size(); i++)
+            spatialTouch(aliveProcesses[i]);
+    }
+}
+
+Value Interpreter::spatialNext(SpatialKind kind, int type, double radius)
+{
+    Process *self = currentProcess;
+    SpatialQuery &query = spatialQuery;
+
+    bool same = query.active && query.frame == frameCount && query.caller == self->id &&
+                query.kind == (int)kind && query.type == type && query.radius == radius;
+
+    if (!same)
+    {
+        spatialFlush();
+        spatialHits.clear();
+
+        const double x = privateNumber(self->privates[(int)PrivateIndex::X]);
+        const double y = privateNumber(self->privates[(int)PrivateIndex::Y]);
+        const double z = privateNumber(self->privates[(int)PrivateIndex::Z]);
+        String *typeName = type >= 0 ? processes[type]->name : nullptr;
+
+        // collision: círculos (esferas) de collisionRadius encostam-se
+        double reach = radius;
+        if (kind == SPATIAL_COLLISION)
+            reach = self->collisionRadius + spatialMaxRadius_;
+
+        auto test = [&](Process *other)
+        {
+            if (other == self || other->state == FiberState::DEAD)
+                return;
+            if (typeName && other->name != typeName)
+                return;
+
+            double dx = privateNumber(other->privates[(int)PrivateIndex::X]) - x;
+            double dy = privateNumber(other->privates[(int)PrivateIndex::Y]) - y;
+            double dz = privateNumber(other->privates[(int)PrivateIndex::Z]) - z;
+            double limit = kind == SPATIAL_COLLISION
+                               ? (double)self->collisionRadius + other->collisionRadius
+                               : radius;
+            if (dx * dx + dy * dy + dz * dz <= limit * limit)
+                spatialHits.push(other->id);
+        };
+
+        const int cx0 = spatialGrid.coord(x - reach), cx1 = spatialGrid.coord(x + reach);
+        const int cy0 = spatialGrid.coord(y - reach), cy1 = spatialGrid.coord(y + reach);
+        const int cz0 = spatialGrid.coord(z - reach), cz1 = spatialGrid.coord(z + reach);
+        const double cellCount = (double(cx1) - cx0 + 1) * (double(cy1) - cy0 + 1) * (double(cz1) - cz0 + 1);
+
+        if (cellCount > (double)spatialGrid.size())
+        {
+            // Raio enorme: mais barato ver os processos um a um
+            for (size_t i = 0; i < aliveProcesses.size(); i++)
+                test(aliveProcesses[i]);
+        }
+        else
+        {
+            for (int cz = cz0; cz <= cz1; cz++)
+                for (int cy = cy0; cy <= cy1; cy++)
+                    for (int cx = cx0; cx <= cx1; cx++)
+                        for (Process *other = spatialGrid.cell(cx, cy, cz); other; other = other->cellNext)
+                            test(other);
+        }
+
+        query.frame = frameCount;
+        query.caller = self->id;
+        query.kind = (int)kind;
+        query.type = type;
+        query.radius = radius;
+        query.next = 0;
+        query.active = true;
+    }
+
+    // Quem morreu entretanto é saltado
+    while (query.next < spatialHits.size())
+    {
+        uint32 id = spatialHits[query.next++];
+        Process *proc = findProcess(id);
+        if (proc && proc->state != FiberState::DEAD)
+            return makeProcess((int)id);
+    }
+
+    query.active = false;
+    return makeNil();
+}
+
+// ============================================
+// NATIVES
+// ============================================
+
+// Tipo de processo: o nome do process (blueprint) ou nil para qualquer um
+static bool spatialType(Interpreter *vm, const char *fn, const Value &v, int *type)
+{
+    if (v.isNil())
+    {
+        *type = -1;
+        return true;
+    }
+    if (v.isProcess())
+    {
+        uint32 index = (uint32)v.asProcessId();
+        if (!ProcessTable::isHandle(index) && index < vm->getTotalProcesses())
+        {
+            *type = (int)index;
+            return true;
+        }
+    }
+    vm->runtimeError("%s expects a process type (or nil) as first argument", fn);
+    return false;
+}
+
+// get_near(type, radius) -> processo seguinte a menos de radius, nil no fim
+int native_get_near(Interpreter *vm, int argCount, Value *args)
+{
+    int type;
+    if (argCount != 2 || !spatialType(vm, "get_near", args[0], &type))
+        return 0;
+    if (!args[1].isNumber())
+    {
+        vm->runtimeError("get_near expects a number as radius");
+        return 0;
+    }
+    vm->push(vm->spatialNext(Interpreter::SPATIAL_NEAR, type, args[1].asNumber()));
+    return 1;
+}
+
+// collision(type) -> processo seguinte cujo collision_radius toca no nosso
+int native_collision(Interpreter *vm, int argCount, Value *args)
+{
+    int type;
+    if (argCount != 1 || !spatialType(vm, "collision", args[0], &type))
+        return 0;
+    vm->push(vm->spatialNext(Interpreter::SPATIAL_COLLISION, type, 0.0));
+    return 1;
+}
+
+// collision_radius(r) -> raio de colisão do processo corrente
+int native_collision_radius(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount != 1 || !args[0].isNumber())
+    {
+        vm->runtimeError("collision_radius expects a number");
+        return 0;
+    }
+    vm->setCollisionRadius(vm->getCurrentProcess(), (float)args[0].asNumber());
+    return 0;
+}
+
+// spatial_cell(size) -> tamanho da célula da grelha (por omissão 64)
+int native_spatial_cell(Interpreter *vm, int argCount, Value *args)
+{
+    if (argCount != 1 || !args[0].isNumber() || args[0].asNumber() <= 0)
+    {
+        vm->runtimeError("spatial_cell expects a positive number");
+        return 0;
+    }
+    vm->setSpatialCellSize((float)args[0].asNumber());
+    return 0;
+}
+
+void Interpreter::setCollisionRadius(Process *proc, float radius)
+{
+    if (radius < 0.0f)
+        radius = 0.0f;
+    proc->collisionRadius = radius;
+    if (radius > spatialMaxRadius_)
+        spatialMaxRadius_ = radius;
+    spatialQuery.active = false;
+}
+
+void Interpreter::registerSpatial()
+{
+    registerNative("get_near", native_get_near, 2);
+    registerNative("collision", native_collision, 1);
+    registerNative("collision_radius", native_collision_radius, 1);
+    registerNative("spatial_cell", native_spatial_cell, 1);
+}
+
+#endif
@@ -9,13 +9,13 @@
 void Interpreter::checkType(int index, ValueType expected, const char *funcName)
 {
     Value v = peek(index);
-    if (v.type != expected)
+    if (v.getType() != expected)
     {
         runtimeError("%s expects %s at index %d, got %s",
                      funcName,
                      valueTypeToString(expected),
                      index,
-                     valueTypeToString(v.type));
+                     valueTypeToString(v.getType()));
     }
 }
 
@@ -60,7 +60,8 @@ int Interpreter::getTop()
 void Interpreter::setTop(int index)
 {
     WDIV_ASSERT(currentFiber != nullptr, "No current fiber");
-    if (index < 0 || index > STACK_MAX)
+    int top = getTop();
+    if (index < 0 || (index > top && !ensureFiber(currentFiber, index - top, 0)))
     {
         runtimeError("Invalid stack index");
         return;
@@ -71,7 +72,7 @@ void Interpreter::setTop(int index)
 void Interpreter::push(Value value)
 {
 
-    if (currentFiber->stackTop >= currentFiber->stack + STACK_MAX)
+    if (!ensureFiber(currentFiber, 1, 0))
     {
         runtimeError("Stack overflow");
         return;
@@ -109,37 +110,37 @@ Value Interpreter::pop()
 // Type checking
 ValueType Interpreter::getType(int index)
 {
-    return peek(index).type;
+    return peek(index).getType();
 }
 
 bool Interpreter::isInt(int index)
 {
-    return peek(index).type == ValueType::INT;
+    return peek(index).getType() == ValueType::INT;
 }
 
 bool Interpreter::isDouble(int index)
 {
-    return peek(index).type == ValueType::DOUBLE;
+    return peek(index).getType() == ValueType::DOUBLE;
 }
 
 bool Interpreter::isString(int index)
 {
-    return peek(index).type == ValueType::STRING;
+    return peek(index).getType() == ValueType::STRING;
 }
 
 bool Interpreter::isBool(int index)
 {
-    return peek(index).type == ValueType::BOOL;
+    return peek(index).getType() == ValueType::BOOL;
 }
 
 bool Interpreter::isNil(int index)
 {
-    return peek(index).type == ValueType::NIL;
+    return peek(index).getType() == ValueType::NIL;
 }
 
 bool Interpreter::isFunction(int index)
 {
-    return peek(index).type == ValueType::FUNCTION;
+    return peek(index).getType() == ValueType::FUNCTION;
 }
 
 void Interpreter::pushInt(int n)
@@ -377,8 +378,8 @@ bool Interpreter::callFunction(Function *func, int argCount)
         return false;
     }
 
-    // Verifica overflow de frames
-    if (currentFiber->frameCount >= FRAMES_MAX)
+    // Verifica overflow de frames (e reserva stack para a função)
+    if (!ensureFiber(currentFiber, functionStackSize(func)))
     {
         runtimeError("Stack overflow - too many nested calls");
         return false;
@@ -394,12 +395,16 @@ bool Interpreter::callFunction(Function *func, int argCount)
 
     CallFrame *frame = &currentFiber->frames[currentFiber->frameCount];
     frame->func = func;
+    frame->closure = nullptr;
     frame->ip = func->chunk->code;
 
     frame->slots = currentFiber->stackTop - argCount;
 
     currentFiber->frameCount++;
 
+    // Entrada de frame: os args já estão na stack
+    checkGC();
+
     int targetFrames = currentFiber->frameCount - 1;
 
     while (currentFiber->frameCount > targetFrames)
@@ -477,62 +482,198 @@ bool Interpreter::callMethod(Value instance, const char *methodName, int argCoun
         return false;
     }
 
-    ClassInstance *inst = instance.asClassInstance();
+    MethodHandle handle = resolveMethod(instance, methodName);
+    if (!handle.valid())
+    {
+        // Method not found - not necessarily an error (optional methods like start/render)
+        return false;
+    }
+
+    return callMethodOnAll(handle, &instance, 1, argCount, args) == 1;
+}
+
+MethodHandle Interpreter::resolveMethod(ClassDef *klass, const char *methodName)
+{
+    MethodHandle handle;
+    if (!klass)
+        return handle;
+
     String *name = createString(methodName);
-    Function *method = nullptr;
+    for (ClassDef *current = klass; current; current = current->superclass)
+    {
+        if (current->methods.get(name, &handle.func))
+        {
+            handle.klass = klass;
+            handle.arity = handle.func->arity;
+            break;
+        }
+    }
+    return handle;
+}
+
+MethodHandle Interpreter::resolveMethod(Value instance, const char *methodName)
+{
+    if (!instance.isClassInstance())
+        return MethodHandle();
+    return resolveMethod(instance.asClassInstance()->klass, methodName);
+}
+
+FunctionHandle Interpreter::resolveFunction(const char *name)
+{
+    FunctionHandle handle;
+    handle.func = getFunction(name);
+    if (handle.func)
+        handle.arity = handle.func->arity;
+    return handle;
+}
 
-    if (!inst->getMethod(name, &method))
+bool Interpreter::callMethod(const MethodHandle &handle, Value instance, int argCount, Value *args)
+{
+    if (!handle.valid())
+        return false;
+
+    if (!instance.isClassInstance() || instance.asClassInstance()->klass != handle.klass)
     {
-        // Method not found - not necessarily an error (optional methods like start/render)
+        runtimeError("callMethod: instance is not a '%s'", handle.klass->name->chars());
+        return false;
+    }
+
+    return callMethodOnAll(handle, &instance, 1, argCount, args) == 1;
+}
+
+bool Interpreter::callFunction(const FunctionHandle &handle, int argCount, Value *args, Value *result)
+{
+    if (!handle.valid())
+    {
+        runtimeError("Cannot call null function");
         return false;
     }
 
-    if (argCount != method->arity)
+    Function *func = handle.func;
+    if (argCount != handle.arity)
     {
-        runtimeError("Method '%s' expects %d arguments, got %d",
-                     methodName, method->arity, argCount);
+        runtimeError("Function '%s' expects %d arguments but got %d",
+                     func->name->chars(), handle.arity, argCount);
         return false;
     }
 
     Process *proc = mainProcess;
     Fiber *fiber = &proc->fibers[0];
     int savedFrameCount = fiber->frameCount;
-    Value *savedStackTop = fiber->stackTop;
+    int savedTop = (int)(fiber->stackTop - fiber->stack);
 
-    // Push self (slot 0) + args
-    push(instance);
-    for (int i = 0; i < argCount; i++)
+    if (!ensureFiber(fiber, argCount + 1 + functionStackSize(func)))
     {
-        push(args[i]);
+        runtimeError("Stack overflow calling function '%s'", func->name->chars());
+        return false;
     }
 
-    if (fiber->frameCount >= FRAMES_MAX)
+    // Slot 0 é o callee (como no OP_CALL), os args a seguir
+    Value *base = fiber->stackTop;
+    base[0] = makeNil();
+    for (int a = 0; a < argCount; a++)
     {
-        runtimeError("Stack overflow calling method '%s'", methodName);
-        fiber->stackTop = savedStackTop;
-        return false;
+        base[a + 1] = args[a];
     }
+    fiber->stackTop = base + argCount + 1;
 
     CallFrame *frame = &fiber->frames[fiber->frameCount++];
-    frame->func = method;
+    frame->func = func;
     frame->closure = nullptr;
-    frame->ip = method->chunk->code;
-    frame->slots = fiber->stackTop - argCount - 1; // self is before args
+    frame->ip = func->chunk->code;
+    frame->slots = base;
+
+    // Entrada de frame: os args já estão na stack
+    checkGC();
 
-    // Execute the method
     while (fiber->frameCount > savedFrameCount)
     {
-        FiberResult result = run_fiber(fiber, proc);
-        if (result.reason == FiberResult::FIBER_DONE || result.reason == FiberResult::ERROR)
+        FiberResult run = run_fiber(fiber, proc);
+        if (run.reason == FiberResult::FIBER_DONE || run.reason == FiberResult::ERROR)
         {
             break;
         }
     }
 
-    // Restore stack
-    fiber->stackTop = savedStackTop;
+    // O OP_RETURN deixa o resultado no topo
+    bool ok = !hasFatalError_;
+    if (result)
+        *result = ok ? fiber->stackTop[-1] : makeNil();
 
-    return true;
+    fiber->stackTop = fiber->stack + savedTop;
+    return ok;
+}
+
+int Interpreter::callMethodOnAll(const MethodHandle &handle, const Value *instances, int count,
+                                 int argCount, Value *args)
+{
+    if (!handle.valid() || count <= 0)
+        return 0;
+
+    Function *method = handle.func;
+    if (argCount != handle.arity)
+    {
+        runtimeError("Method '%s' expects %d arguments, got %d",
+                     method->name->chars(), handle.arity, argCount);
+        return 0;
+    }
+
+    Process *proc = mainProcess;
+    Fiber *fiber = &proc->fibers[0];
+    int savedFrameCount = fiber->frameCount;
+    int savedTop = (int)(fiber->stackTop - fiber->stack); // offset: a stack pode crescer
+
+    // Reserva uma vez para o lote: self + args + corpo do método
+    if (!ensureFiber(fiber, argCount + 1 + functionStackSize(method)))
+    {
+        runtimeError("Stack overflow calling method '%s'", method->name->chars());
+        return 0;
+    }
+
+    int called = 0;
+    for (int i = 0; i < count; i++)
+    {
+        Value self = instances[i];
+        if (!self.isClassInstance() || self.asClassInstance()->klass != handle.klass)
+            continue;
+
+        // Self (slot 0) + args; a base volta sempre ao mesmo sítio
+        Value *base = fiber->stack + savedTop;
+        base[0] = self;
+        for (int a = 0; a < argCount; a++)
+        {
+            base[a + 1] = args[a];
+        }
+        fiber->stackTop = base + argCount + 1;
+
+        CallFrame *frame = &fiber->frames[fiber->frameCount++];
+        frame->func = method;
+        frame->closure = nullptr;
+        frame->ip = method->chunk->code;
+        frame->slots = base;
+
+        // Entrada de frame: self e args já estão na stack
+        checkGC();
+
+        // Execute the method
+        while (fiber->frameCount > savedFrameCount)
+        {
+            FiberResult result = run_fiber(fiber, proc);
+            if (result.reason == FiberResult::FIBER_DONE || result.reason == FiberResult::ERROR)
+            {
+                break;
+            }
+        }
+
+        // Restore stack
+        fiber->stackTop = fiber->stack + savedTop;
+        called++;
+
+        if (hasFatalError_)
+            break;
+    }
+
+    return called;
 }
 
 Process *Interpreter::callProcess(ProcessDef *proc, int argCount)
@@ -590,9 +731,9 @@ Process *Interpreter::callProcess(ProcessDef *proc, int argCount)
 
     // ID e FATHER
     instance->privates[(int)PrivateIndex::ID] = makeInt(instance->id);
-    if (currentProcess && currentProcess->id > 0)
+    if (currentProcess && currentProcess != mainProcess)
     {
-        instance->privates[(int)PrivateIndex::FATHER] = makeInt(currentProcess->id);
+        instance->privates[(int)PrivateIndex::FATHER] = makeProcess(currentProcess->id);
     }
 
     if (hooks.onStart)
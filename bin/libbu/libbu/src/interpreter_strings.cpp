@@ -0,0 +1,173 @@
+#include "interpreter.hpp"
+
+// ============================================
+// CONCATENAÇÃO SEM INTERMÉDIOS
+// "a" + b + "c" + d compila para um OP_CONCAT (Compiler::addChain): os
+// operandos vão todos para um StringBuffer e só no fim nasce uma String.
+// O StringBuilder é o mesmo buffer exposto ao script, para textos montados
+// ao longo de um loop.
+// ============================================
+
+// O texto que o '+' dá a um operando ao lado de uma string
+static bool appendText(StringBuffer &sb, const Value &v)
+{
+    if (v.isString())
+        sb.append(v.asString());
+    else if (v.isInt())
+        sb.appendInt(v.asInt());
+    else if (v.isUInt())
+        sb.appendUInt(v.asUInt());
+    else if (v.isDouble())
+        sb.appendDouble(v.asDouble());
+    else if (v.isBool())
+        sb.appendInt(v.asBool());
+    else if (v.isNil())
+        sb.append("nil", 3);
+    else if (v.isByte())
+        sb.appendInt(v.asByte());
+    else
+        return false;
+    return true;
+}
+
+bool Interpreter::concatValues(Value *values, int count, Value *result, Value *errLeft, Value *errRight)
+{
+    Value acc = values[0];
+    int i = 1;
+
+    // Prefixo numérico: 1 + 2 + "x" é "3x"
+    while (i < count && !acc.isString() && !values[i].isString())
+    {
+        const Value &b = values[i];
+        if (!acc.isNumber() || !b.isNumber())
+        {
+            *errLeft = acc;
+            *errRight = b;
+            return false;
+        }
+        acc = addNumbers(acc, b);
+        i++;
+    }
+
+    if (i == count)
+    {
+        *result = acc;
+        return true;
+    }
+
+    StringBuffer &sb = concatBuffer;
+    sb.clear();
+
+    // Daqui em diante o acumulado é sempre uma string
+    Value text = acc.isString() ? acc : values[i];
+    if (!appendText(sb, acc))
+    {
+        *errLeft = acc;
+        *errRight = values[i];
+        return false;
+    }
+    for (; i < count; i++)
+    {
+        if (!appendText(sb, values[i]))
+        {
+            *errLeft = text;
+            *errRight = values[i];
+            return false;
+        }
+    }
+
+    *result = makeString(sb);
+    return true;
+}
+
+// ============================================
+// STRINGBUILDER
+// var sb = StringBuilder();
+// sb.append("pos ", x, " ", y); sb.appendChar(10);
+// var s = sb.toString();
+// ============================================
+
+static void *sb_ctor(Interpreter *vm, int argCount, Value *args)
+{
+    (void)vm;
+    (void)argCount;
+    (void)args;
+    return new StringBuffer();
+}
+
+static void sb_dtor(Interpreter *vm, void *data)
+{
+    (void)vm;
+    delete static_cast<StringBuffer *>(data);
+}
+
+// append(v, ...) -> strings, números, bools e nil, como no '+'
+static int sb_append(Interpreter *vm, void *data, int argCount, Value *args)
+{
+    StringBuffer *sb = static_cast<StringBuffer *>(data);
+    for (int i = 0; i < argCount; i++)
+    {
+        if (args[i].isFloat())
+        {
+            sb->appendDouble(args[i].asFloat());
+            continue;
+        }
+        if (!appendText(*sb, args[i]))
+        {
+            vm->runtimeError("StringBuilder.append expects strings, numbers, bools or nil");
+            return 0;
+        }
+    }
+    return 0;
+}
+
+// appendChar(code) -> um byte (0..255)
+static int sb_appendChar(Interpreter *vm, void *data, int argCount, Value *args)
+{
+    if (argCount != 1 || !args[0].isNumber())
+    {
+        vm->runtimeError("StringBuilder.appendChar expects a character code");
+        return 0;
+    }
+    int code = args[0].asInt();
+    if (code < 0 || code > 255)
+    {
+        vm->runtimeError("StringBuilder.appendChar code %d out of range (0..255)", code);
+        return 0;
+    }
+    static_cast<StringBuffer *>(data)->appendChar((char)code);
+    return 0;
+}
+
+static int sb_clear(Interpreter *vm, void *data, int argCount, Value *args)
+{
+    (void)vm;
+    (void)argCount;
+    (void)args;
+    static_cast<StringBuffer *>(data)->clear();
+    return 0;
+}
+
+// toString() -> uma String nova com o conteúdo; o buffer fica como está
+static int sb_toString(Interpreter *vm, void *data, int argCount, Value *args)
+{
+    (void)argCount;
+    (void)args;
+    vm->push(vm->makeString(*static_cast<StringBuffer *>(data)));
+    return 1;
+}
+
+static Value sb_getLength(Interpreter *vm, void *data)
+{
+    return vm->makeInt((int)static_cast<StringBuffer *>(data)->length);
+}
+
+void Interpreter::registerStringBuilder()
+{
+    NativeClassDef *sb = registerNativeClass("StringBuilder", sb_ctor, sb_dtor, 0, false);
+    addNativeProperty(sb, "length", sb_getLength, nullptr);
+    addNativeMethod(sb, "append", sb_append);
+    addNativeMethod(sb, "appendChar", sb_appendChar);
+    addNativeMethod(sb, "clear", sb_clear);
+    addNativeMethod(sb, "toString", sb_toString);
+}
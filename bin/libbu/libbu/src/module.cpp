@@ -211,7 +211,7 @@ ModuleBuilder &ModuleBuilder::addBool(const char *name, bool value)
 
 ModuleBuilder &ModuleBuilder::addString(const char *name, const char *value)
 {
-    module->addConstant(name,vm->makeString(value));
+    module->addConstant(name,vm->makeString(vm->createString(value)));
     return *this;
 }
 
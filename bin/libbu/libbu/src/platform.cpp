@@ -1,10 +1,15 @@
 #include "platform.hpp"
 
 #include <cstdarg>
+#include <cstdlib>
 
 // Dynamic library loading headers
 #if defined(__linux__) || defined(__APPLE__)
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #elif defined(_WIN32)
 #include <windows.h>
 #endif
@@ -201,6 +206,28 @@ int OsFileRead(const char *filename, void *buffer, size_t maxSize)
     return (int)read;
 }
 
+// Lê size bytes a partir de position (streaming de assets)
+int OsFileReadAt(const char *filename, void *buffer, size_t size, long position)
+{
+    FILE *file = fopen(filename, "rb");
+    if (!file)
+    {
+        OsEPrintf("Failed to open file '%s' for reading", filename);
+        return -1;
+    }
+
+    if (fseek(file, position, SEEK_SET) != 0)
+    {
+        fclose(file);
+        return -1;
+    }
+
+    size_t read = fread(buffer, 1, size, file);
+    fclose(file);
+
+    return (int)read;
+}
+
 bool OsFileExists(const char *filename)
 {
     FILE *file = fopen(filename, "rb");
@@ -237,6 +264,40 @@ bool OsFileDelete(const char *filename)
     return result;
 }
 
+// Sem mmap no filesystem virtual: lê para memória
+const void *OsMapFile(const char *filename, size_t *outSize)
+{
+    FILE *file = fopen(filename, "rb");
+    if (!file)
+        return nullptr;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size <= 0)
+    {
+        fclose(file);
+        return nullptr;
+    }
+
+    void *data = malloc((size_t)size);
+    if (data && fread(data, 1, (size_t)size, file) != (size_t)size)
+    {
+        free(data);
+        data = nullptr;
+    }
+    fclose(file);
+
+    *outSize = (size_t)size;
+    return data;
+}
+
+void OsUnmapFile(const void *data, size_t size)
+{
+    (void)size;
+    free((void *)data);
+}
+
 #endif // __EMSCRIPTEN__
 
 // ============================================
@@ -289,6 +350,28 @@ int OsFileRead(const char *filename, void *buffer, size_t maxSize)
     return (int)read;
 }
 
+// Lê size bytes a partir de position (streaming de assets)
+int OsFileReadAt(const char *filename, void *buffer, size_t size, long position)
+{
+    FILE *file = fopen(filename, "rb");
+    if (!file)
+    {
+        OsEPrintf("Failed to open file '%s' for reading", filename);
+        return -1;
+    }
+
+    if (fseek(file, position, SEEK_SET) != 0)
+    {
+        fclose(file);
+        return -1;
+    }
+
+    size_t read = fread(buffer, 1, size, file);
+    fclose(file);
+
+    return (int)read;
+}
+
 bool OsFileExists(const char *filename)
 {
     FILE *file = fopen(filename, "rb");
@@ -318,6 +401,75 @@ bool OsFileDelete(const char *filename)
     return remove(filename) == 0;
 }
 
+#if defined(_WIN32)
+
+const void *OsMapFile(const char *filename, size_t *outSize)
+{
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return nullptr;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return nullptr;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+        return nullptr;
+
+    void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping); // a view mantém o mapping vivo
+    if (!data)
+        return nullptr;
+
+    *outSize = (size_t)size.QuadPart;
+    return data;
+}
+
+void OsUnmapFile(const void *data, size_t size)
+{
+    (void)size;
+    if (data)
+        UnmapViewOfFile(data);
+}
+
+#else
+
+const void *OsMapFile(const char *filename, size_t *outSize)
+{
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    void *data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // o mapping sobrevive ao fd
+    if (data == MAP_FAILED)
+        return nullptr;
+
+    *outSize = (size_t)st.st_size;
+    return data;
+}
+
+void OsUnmapFile(const void *data, size_t size)
+{
+    if (data)
+        munmap((void *)data, size);
+}
+
+#endif
+
 #endif
 
 // ============================================
@@ -34,9 +34,115 @@ String *StringPool::allocString()
 {
     void *mem = allocator.Allocate(sizeof(String));
     String *s = new (mem) String();
+    s->marked = 0;
+    s->interned = false;
     return s;
 }
 
+static FORCE_INLINE size_t runtimeSize(String *s)
+{
+    return sizeof(String) + (s->isLong() ? s->length() + 1 : 0);
+}
+
+void StringPool::copyChars(String *s, const char *str, uint32 len)
+{
+    if (len <= String::SMALL_THRESHOLD)
+    {
+        s->length_and_flag = len;
+        std::memcpy(s->data, str, len);
+        s->data[len] = '\0';
+    }
+    else
+    {
+        s->length_and_flag = len | String::IS_LONG_FLAG;
+        s->ptr = (char *)allocator.Allocate(len + 1);
+        std::memcpy(s->ptr, str, len);
+        s->ptr[len] = '\0';
+    }
+
+    s->hash = hashString(s->chars(), len);
+}
+
+// ============= RUNTIME STRINGS (GC) =============
+
+String *StringPool::createRuntime(const char *str, uint32 len)
+{
+    String *s = allocString();
+    copyChars(s, str, len);
+    s->index = -1;
+    s->marked = allocMark;
+
+    runtimeBytes += runtimeSize(s);
+    runtime.push(s);
+    return s;
+}
+
+String *StringPool::createRuntime(const char *str)
+{
+    return createRuntime(str, std::strlen(str));
+}
+
+void StringPool::freeRuntime(String *s)
+{
+    runtimeBytes -= runtimeSize(s);
+
+    if (s->isLong() && s->ptr)
+        allocator.Free(s->ptr, s->length() + 1);
+
+    s->~String();
+    allocator.Free(s, sizeof(String));
+}
+
+void StringPool::sweep()
+{
+    size_t budget = (size_t)-1;
+    beginSweep();
+    sweepStep(&budget);
+}
+
+void StringPool::beginSweep()
+{
+    sweepIndex = 0;
+    allocMark = 1;
+}
+
+bool StringPool::sweepStep(size_t *budget)
+{
+    // Strings criadas a meio do sweep nascem marcadas: o swap com o back()
+    // trá-las para o cursor e não estavam vivas na marcação
+    while (sweepIndex < runtime.size())
+    {
+        if (*budget == 0)
+            return false;
+        (*budget)--;
+
+        String *s = runtime[sweepIndex];
+        if (s->marked)
+        {
+            s->marked = 0;
+            sweepIndex++;
+            continue;
+        }
+        freeRuntime(s);
+        runtime[sweepIndex] = runtime.back();
+        runtime.pop();
+    }
+    allocMark = 0;
+    return true;
+}
+
+void StringPool::clearRuntime()
+{
+    for (size_t i = 0; i < runtime.size(); i++)
+    {
+        freeRuntime(runtime[i]);
+    }
+    runtime.clear();
+    runtimeBytes = 0;
+    sweepIndex = 0;
+    allocMark = 0;
+}
+
 void StringPool::deallocString(String *s)
 {
     if (!s)
@@ -64,6 +170,8 @@ void StringPool::clear()
         deallocString(s);
     }
 
+    clearRuntime();
+
     dummyString->~String();
     allocator.Free(dummyString, sizeof(String));
 
@@ -72,6 +180,7 @@ void StringPool::clear()
 
     map.clear();
     pool.destroy();
+    std::memset(charStrings, 0, sizeof(charStrings));
 }
 
 String *StringPool::create(const char *str, uint32 len)
@@ -88,25 +197,11 @@ String *StringPool::create(const char *str, uint32 len)
 
     // New string
     String *s = allocString();
+    copyChars(s, str, len);
 
-    // Copy data
-    if (len <= String::SMALL_THRESHOLD)
-    {
-        s->length_and_flag = len;
-        std::memcpy(s->data, str, len);
-        s->data[len] = '\0';
-    }
-    else
-    {
-        s->length_and_flag = len | String::IS_LONG_FLAG;
-        s->ptr = (char *)allocator.Allocate(len + 1);
-        std::memcpy(s->ptr, str, len);
-        s->ptr[len] = '\0';
-    }
-
-    s->hash = hashString(s->chars(), len);
     bytesAllocated += sizeof(String) + len;
     s->index = map.size();
+    s->interned = true;
 
     // Info("Create string %s hash %d len %d", s->chars(), s->hash, s->length());
     map.push(s);
@@ -144,8 +239,52 @@ String *StringPool::concat(String *a, String *b)
     std::memcpy(temp + lenA, b->chars(), lenB);
     temp[totalLen] = '\0';
 
-    //  Cria string (com interning!)
-    return create(temp, totalLen);
+    //  Cria string de runtime (GC)
+    return createRuntime(temp, totalLen);
+}
+
+// ========================================
+// STRINGBUFFER / BUILD
+// ========================================
+
+void StringBuffer::reserve(uint32 needed)
+{
+    if (needed <= capacity)
+        return;
+    uint32 newCap = (uint32)CalculateCapacityGrow((size_t)capacity * 2, needed);
+    data = (char *)aRealloc(data, newCap);
+    capacity = newCap;
+}
+
+void StringBuffer::appendInt(int value)
+{
+    char buf[32];
+    int len = snprintf(buf, sizeof(buf), "%d", value);
+    append(buf, (uint32)len);
+}
+
+void StringBuffer::appendUInt(uint32 value)
+{
+    char buf[32];
+    int len = snprintf(buf, sizeof(buf), "%u", value);
+    append(buf, (uint32)len);
+}
+
+// Mesmo formato de StringPool::toString(double)
+void StringBuffer::appendDouble(double value)
+{
+    char buf[32];
+    int len = snprintf(buf, sizeof(buf), "%.6f", value);
+    if (len >= (int)sizeof(buf))
+        len = (int)sizeof(buf) - 1;
+    append(buf, (uint32)len);
+}
+
+String *StringPool::build(const StringBuffer &buffer)
+{
+    if (buffer.length == 0)
+        return create("", 0);
+    return createRuntime(buffer.data, buffer.length);
 }
 
 // ========================================
@@ -169,7 +308,7 @@ String *StringPool::upper(String *src)
     }
     temp[len] = '\0';
 
-    return create(temp, len);
+    return createRuntime(temp, len);
 }
 
 String *StringPool::lower(String *src)
@@ -188,7 +327,7 @@ String *StringPool::lower(String *src)
     }
     temp[len] = '\0';
 
-    return create(temp, len);
+    return createRuntime(temp, len);
 }
 
 // ========================================
@@ -217,7 +356,7 @@ String *StringPool::substring(String *src, uint32 start, uint32 end)
     std::memcpy(temp, src->chars() + start, newLen);
     temp[newLen] = '\0';
 
-    return create(temp, newLen);
+    return createRuntime(temp, newLen);
 }
 
 // ========================================
@@ -276,7 +415,7 @@ String *StringPool::replace(String *src, const char *oldStr, const char *newStr)
     std::memcpy(temp + destIdx, current, remainLen);
     temp[finalLen] = '\0';
 
-    return create(temp, finalLen);
+    return createRuntime(temp, finalLen);
 }
 
 // ========================================
@@ -298,7 +437,19 @@ String *StringPool::at(String *str, int index)
         return create("", 0);
 
     char buf[2] = {str->chars()[index], '\0'};
-    return create(buf, 1);
+    return createRuntime(buf, 1);
+}
+
+String *StringPool::charString(uint8 c)
+{
+    String *s = charStrings[c];
+    if (!s)
+    {
+        char buf[2] = {(char)c, '\0'};
+        s = create(buf, c ? 1 : 0);
+        charStrings[c] = s;
+    }
+    return s;
 }
 
 // ========================================
@@ -368,7 +519,7 @@ String *StringPool::trim(String *str)
     std::memcpy(temp, start, len);
     temp[len] = '\0';
 
-    return create(temp, len);
+    return createRuntime(temp, len);
 }
 
 // ========================================
@@ -447,7 +598,7 @@ String *StringPool::repeat(String *str, int count)
     }
     temp[totalLen] = '\0';
 
-    String *result = create(temp, totalLen);
+    String *result = createRuntime(temp, totalLen);
 
     if (!useAlloca)
     {
@@ -466,21 +617,21 @@ String *StringPool::toString(int value)
     char buf[32];
 
     snprintf(buf, sizeof(buf), "%d", value);
-    return create(buf);
+    return createRuntime(buf);
 }
 
 String *StringPool::toString(uint32 value)
 {
     char buf[32];
     snprintf(buf, sizeof(buf), "%u", value);
-    return create(buf);
+    return createRuntime(buf);
 }
 
 String *StringPool::toString(double value)
 {
     char buf[32];
     snprintf(buf, sizeof(buf), "%.6f", value);
-    return create(buf);
+    return createRuntime(buf);
 }
 
 // ========================================
@@ -513,13 +664,13 @@ String *StringPool::format(const char *fmt, ...)
         vsnprintf(heap, needed + 1, fmt, args);
         va_end(args);
 
-        String *result = create(heap, needed);
+        String *result = createRuntime(heap, needed);
         aFree(heap);
 
         return result;
     }
 
-    return create(buffer, len);
+    return createRuntime(buffer, len);
 }
 
 String *StringPool::getString(int index)
@@ -625,11 +776,7 @@ void ProcessPool::recycle(Process *proc)
 
 void ProcessPool::destroy(Process *proc)
 {
-    if (proc->fibers)
-    {
-        free(proc->fibers);
-        proc->fibers = nullptr;
-    }
+    proc->release();
     delete proc;
 }
 
@@ -640,16 +787,126 @@ void ProcessPool::clear()
     for (size_t j = 0; j < pool.size(); j++)
     {
         Process *proc = pool[j];
-        if (proc->fibers)
-        {
-            free(proc->fibers);
-            proc->fibers = nullptr;
-        }
+        proc->release();
         delete proc;
     }
     pool.clear();
 }
 
+ProcessTable::ProcessTable() : freeHead(INDEX_MASK + 1), freeTail(INDEX_MASK + 1) {}
+
+void ProcessTable::pushFree(uint32 index)
+{
+    Slot &slot = slots[index];
+    slot.proc = nullptr;
+    slot.nextFree = INDEX_MASK + 1;
+
+    // Última geração: o slot fica reformado, fora da lista
+    if (slot.generation == GENERATION_MASK)
+        return;
+
+    if (freeTail <= INDEX_MASK)
+        slots[freeTail].nextFree = index;
+    else
+        freeHead = index;
+    freeTail = index;
+}
+
+uint32 ProcessTable::insert(Process *proc)
+{
+    uint32 index;
+    if (freeHead <= INDEX_MASK)
+    {
+        index = freeHead;
+        freeHead = slots[index].nextFree;
+        if (freeHead > INDEX_MASK)
+            freeTail = INDEX_MASK + 1;
+    }
+    else
+    {
+        if (slots.size() > INDEX_MASK)
+            return INVALID_ID;
+        index = (uint32)slots.size();
+        Slot slot;
+        slot.proc = nullptr;
+        slot.generation = 0;
+        slot.nextFree = INDEX_MASK + 1;
+        slots.push(slot);
+    }
+
+    Slot &slot = slots[index];
+    slot.generation++; // < GENERATION_MASK: os reformados não voltam à lista
+    slot.proc = proc;
+    return index | (slot.generation << INDEX_BITS);
+}
+
+void ProcessTable::remove(uint32 id)
+{
+    if (!find(id))
+        return;
+    pushFree(id & INDEX_MASK);
+}
+
+void ProcessTable::clear()
+{
+    // As gerações ficam: ids antigos continuam inválidos depois de um reset
+    freeHead = INDEX_MASK + 1;
+    freeTail = INDEX_MASK + 1;
+    for (size_t i = 0; i < slots.size(); i++)
+        pushFree((uint32)i);
+}
+
+void SleepQueue::siftUp(size_t i)
+{
+    SleepEntry entry = heap[i];
+    while (i > 0)
+    {
+        size_t parent = (i - 1) / 2;
+        if (heap[parent].time <= entry.time)
+            break;
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = entry;
+}
+
+void SleepQueue::siftDown(size_t i)
+{
+    SleepEntry entry = heap[i];
+    size_t count = heap.size();
+    for (;;)
+    {
+        size_t child = 2 * i + 1;
+        if (child >= count)
+            break;
+        if (child + 1 < count && heap[child + 1].time < heap[child].time)
+            child++;
+        if (entry.time <= heap[child].time)
+            break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = entry;
+}
+
+void SleepQueue::push(float time, uint32 id, uint32 seq)
+{
+    SleepEntry entry;
+    entry.time = time;
+    entry.id = id;
+    entry.seq = seq;
+    heap.push(entry);
+    siftUp(heap.size() - 1);
+}
+
+void SleepQueue::pop()
+{
+    heap[0] = heap.back();
+    heap.pop();
+    if (!heap.empty())
+        siftDown(0);
+}
+
 void ProcessPool::shrink()
 {
     if (pool.size() <= MIN_POOL_SIZE)
@@ -665,11 +922,7 @@ void ProcessPool::shrink()
         Process *proc = pool.back();
         pool.pop();
 
-        if (proc->fibers)
-        {
-            free(proc->fibers);
-            proc->fibers = nullptr;
-        }
+        proc->release();
         delete proc;
     }
 }
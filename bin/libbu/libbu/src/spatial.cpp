@@ -0,0 +1,82 @@
+#include "spatial.hpp"
+#include "interpreter.hpp"
+
+void SpatialGrid::setCellSize(float size)
+{
+    if (size <= 0.0f)
+        return;
+    cellSize = size;
+    invCellSize = 1.0f / size;
+}
+
+void SpatialGrid::link(Process *proc, uint64 cellKey)
+{
+    Process **head = cells.getPtr(cellKey);
+    if (head)
+    {
+        proc->cellNext = *head;
+        (*head)->cellPrev = proc;
+        *head = proc;
+    }
+    else
+    {
+        proc->cellNext = nullptr;
+        cells.set(cellKey, proc);
+    }
+    proc->cellPrev = nullptr;
+    proc->cellKey = cellKey;
+    proc->inGrid = true;
+}
+
+void SpatialGrid::unlink(Process *proc)
+{
+    if (proc->cellPrev)
+    {
+        proc->cellPrev->cellNext = proc->cellNext;
+    }
+    else if (proc->cellNext)
+    {
+        cells.set(proc->cellKey, proc->cellNext);
+    }
+    else
+    {
+        // Célula vazia sai da tabela
+        cells.erase(proc->cellKey);
+    }
+
+    if (proc->cellNext)
+        proc->cellNext->cellPrev = proc->cellPrev;
+
+    proc->cellNext = nullptr;
+    proc->cellPrev = nullptr;
+    proc->inGrid = false;
+}
+
+void SpatialGrid::place(Process *proc, double x, double y, double z)
+{
+    uint64 cellKey = key(coord(x), coord(y), coord(z));
+    if (proc->inGrid)
+    {
+        if (proc->cellKey == cellKey)
+            return;
+        unlink(proc);
+        count--;
+    }
+    link(proc, cellKey);
+    count++;
+}
+
+void SpatialGrid::remove(Process *proc)
+{
+    if (!proc->inGrid)
+        return;
+    unlink(proc);
+    count--;
+}
+
+void SpatialGrid::clear()
+{
+    // Os processos são limpos por quem os tem (freeRunningProcesses/spawn)
+    cells.clear();
+    count = 0;
+}
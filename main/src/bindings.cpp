@@ -4,12 +4,35 @@
 
 // ============== OGRE VECTOR3 BINDINGS ==============
 
+// Vector3/Quaternion são classes valor: os floats vivem inline na instância
+// (uma alocação da arena, sem new/delete) e as defs ficam em cache, para
+// os getters por frame não procurarem a classe pelo nome.
+
 namespace OgreVector3Bindings
 {
+    NativeClassDef *vector3Class = nullptr;
+
+    Value make(Interpreter *vm, const Ogre::Vector3 &v)
+    {
+        Value value = vm->makeNativeValue(vector3Class);
+        new (value.asNativeClassInstance()->userData) Ogre::Vector3(v);
+        return value;
+    }
+
+    Ogre::Vector3 *get(const Value &value)
+    {
+        if (!value.isNativeClassInstance())
+            return nullptr;
+        NativeClassInstance *instance = value.asNativeClassInstance();
+        if (instance->klass != vector3Class)
+            return nullptr;
+        return static_cast<Ogre::Vector3 *>(instance->userData);
+    }
+
     // Constructor: Vector3(x, y, z)
-    void *vector3_ctor(Interpreter *vm, int argCount, Value *args)
+    void vector3_ctor(Interpreter *vm, void *buffer, int argCount, Value *args)
     {
-        Ogre::Vector3 *vec = new Ogre::Vector3();
+        Ogre::Vector3 *vec = new (buffer) Ogre::Vector3(Ogre::Vector3::ZERO);
 
         if (argCount >= 3)
         {
@@ -24,22 +47,6 @@ namespace OgreVector3Bindings
             vec->y = val;
             vec->z = val;
         }
-        else
-        {
-            vec->x = 0.0f;
-            vec->y = 0.0f;
-            vec->z = 0.0f;
-        }
-
-        Info("Vector3 constructed: (%f, %f, %f)", vec->x, vec->y, vec->z);
-        return vec;
-    }
-
-    // Destructor
-    void vector3_dtor(Interpreter *vm, void *data)
-    {
-       // Info("Vector3 destructed");
-        delete static_cast<Ogre::Vector3 *>(data);
     }
 
     // Property getters
@@ -96,7 +103,7 @@ namespace OgreVector3Bindings
             return 0;
 
         Ogre::Vector3 *self = static_cast<Ogre::Vector3 *>(data);
-        Ogre::Vector3 *other = static_cast<Ogre::Vector3 *>(args[0].asPointer());
+        Ogre::Vector3 *other = get(args[0]);
 
         if (other == nullptr)
             return 0;
@@ -112,14 +119,12 @@ namespace OgreVector3Bindings
             return 0;
 
         Ogre::Vector3 *self = static_cast<Ogre::Vector3 *>(data);
-        Ogre::Vector3 *other = static_cast<Ogre::Vector3 *>(args[0].asPointer());
+        Ogre::Vector3 *other = get(args[0]);
 
         if (other == nullptr)
             return 0;
 
-        Ogre::Vector3 result = self->crossProduct(*other);
-        Ogre::Vector3 *newVec = new Ogre::Vector3(result);
-        vm->pushPointer((void *)newVec);
+        vm->push(make(vm, self->crossProduct(*other)));
         return 1;
     }
 
@@ -129,7 +134,7 @@ namespace OgreVector3Bindings
             return 0;
 
         Ogre::Vector3 *self = static_cast<Ogre::Vector3 *>(data);
-        Ogre::Vector3 *other = static_cast<Ogre::Vector3 *>(args[0].asPointer());
+        Ogre::Vector3 *other = get(args[0]);
 
         if (other == nullptr)
             return 0;
@@ -138,6 +143,21 @@ namespace OgreVector3Bindings
         return 0;
     }
 
+    int vector3_sub(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 1)
+            return 0;
+
+        Ogre::Vector3 *self = static_cast<Ogre::Vector3 *>(data);
+        Ogre::Vector3 *other = get(args[0]);
+
+        if (other == nullptr)
+            return 0;
+
+        *self = *self - *other;
+        return 0;
+    }
+
     int vector3_scale(Interpreter *vm, void *data, int argCount, Value *args)
     {
         if (argCount < 1)
@@ -150,28 +170,72 @@ namespace OgreVector3Bindings
         return 0;
     }
 
+    // set(x, y, z) - reutiliza o vetor em vez de criar outro
+    int vector3_set(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 3)
+            return 0;
+
+        Ogre::Vector3 *self = static_cast<Ogre::Vector3 *>(data);
+        self->x = (float)args[0].asNumber();
+        self->y = (float)args[1].asNumber();
+        self->z = (float)args[2].asNumber();
+        return 0;
+    }
+
+    int vector3_copy(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 1)
+            return 0;
+
+        Ogre::Vector3 *other = get(args[0]);
+        if (other == nullptr)
+            return 0;
+
+        *static_cast<Ogre::Vector3 *>(data) = *other;
+        return 0;
+    }
+
+    int vector3_distance(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 1)
+            return 0;
+
+        Ogre::Vector3 *self = static_cast<Ogre::Vector3 *>(data);
+        Ogre::Vector3 *other = get(args[0]);
+
+        if (other == nullptr)
+            return 0;
+
+        vm->pushFloat(self->distance(*other));
+        return 1;
+    }
+
     void registerAll(Interpreter &vm)
     {
-        NativeClassDef *vec3 = vm.registerNativeClass(
+        vector3Class = vm.registerNativeValueClass(
             "Vector3",
+            sizeof(Ogre::Vector3),
             vector3_ctor,
-            vector3_dtor,
-            3,      // number of properties
-            false   // GC collects
+            3       // number of properties
         );
 
         // Add properties
-        vm.addNativeProperty(vec3, "x", vector3_getX, vector3_setX);
-        vm.addNativeProperty(vec3, "y", vector3_getY, vector3_setY);
-        vm.addNativeProperty(vec3, "z", vector3_getZ, vector3_setZ);
+        vm.addNativeProperty(vector3Class, "x", vector3_getX, vector3_setX);
+        vm.addNativeProperty(vector3Class, "y", vector3_getY, vector3_setY);
+        vm.addNativeProperty(vector3Class, "z", vector3_getZ, vector3_setZ);
 
         // Add methods
-        vm.addNativeMethod(vec3, "length", vector3_length);
-        vm.addNativeMethod(vec3, "normalise", vector3_normalise);
-        vm.addNativeMethod(vec3, "dot", vector3_dot);
-        vm.addNativeMethod(vec3, "cross", vector3_cross);
-        vm.addNativeMethod(vec3, "add", vector3_add);
-        vm.addNativeMethod(vec3, "scale", vector3_scale);
+        vm.addNativeMethod(vector3Class, "length", vector3_length);
+        vm.addNativeMethod(vector3Class, "normalise", vector3_normalise);
+        vm.addNativeMethod(vector3Class, "dot", vector3_dot);
+        vm.addNativeMethod(vector3Class, "cross", vector3_cross);
+        vm.addNativeMethod(vector3Class, "add", vector3_add);
+        vm.addNativeMethod(vector3Class, "sub", vector3_sub);
+        vm.addNativeMethod(vector3Class, "scale", vector3_scale);
+        vm.addNativeMethod(vector3Class, "set", vector3_set);
+        vm.addNativeMethod(vector3Class, "copy", vector3_copy);
+        vm.addNativeMethod(vector3Class, "distance", vector3_distance);
 
         Info("Vector3 bindings registered");
     }
@@ -182,10 +246,29 @@ namespace OgreVector3Bindings
 
 namespace OgreQuaternionBindings
 {
+    NativeClassDef *quaternionClass = nullptr;
+
+    Value make(Interpreter *vm, const Ogre::Quaternion &q)
+    {
+        Value value = vm->makeNativeValue(quaternionClass);
+        new (value.asNativeClassInstance()->userData) Ogre::Quaternion(q);
+        return value;
+    }
+
+    Ogre::Quaternion *get(const Value &value)
+    {
+        if (!value.isNativeClassInstance())
+            return nullptr;
+        NativeClassInstance *instance = value.asNativeClassInstance();
+        if (instance->klass != quaternionClass)
+            return nullptr;
+        return static_cast<Ogre::Quaternion *>(instance->userData);
+    }
+
     // Constructor: Quaternion(w, x, y, z)
-    void *quat_ctor(Interpreter *vm, int argCount, Value *args)
+    void quat_ctor(Interpreter *vm, void *buffer, int argCount, Value *args)
     {
-        Ogre::Quaternion *quat = new Ogre::Quaternion();
+        Ogre::Quaternion *quat = new (buffer) Ogre::Quaternion(Ogre::Quaternion::IDENTITY);
 
         if (argCount >= 4)
         {
@@ -194,20 +277,6 @@ namespace OgreQuaternionBindings
             quat->y = (float)args[2].asNumber();
             quat->z = (float)args[3].asNumber();
         }
-        else if (argCount == 0)
-        {
-            *quat = Ogre::Quaternion::IDENTITY;
-        }
-
-        Info("Quaternion constructed: (%f, %f, %f, %f)", quat->w, quat->x, quat->y, quat->z);
-        return quat;
-    }
-
-    // Destructor
-    void quat_dtor(Interpreter *vm, void *data)
-    {
-        Info("Quaternion destructed");
-        delete static_cast<Ogre::Quaternion *>(data);
     }
 
     // Property getters
@@ -266,7 +335,7 @@ namespace OgreQuaternionBindings
             return 0;
 
         Ogre::Quaternion *quat = static_cast<Ogre::Quaternion *>(data);
-        Ogre::Vector3 *axis = static_cast<Ogre::Vector3 *>(args[0].asPointer());
+        Ogre::Vector3 *axis = OgreVector3Bindings::get(args[0]);
         float angle = (float)args[1].asNumber();
 
         if (axis == nullptr)
@@ -282,7 +351,7 @@ namespace OgreQuaternionBindings
             return 0;
 
         Ogre::Quaternion *self = static_cast<Ogre::Quaternion *>(data);
-        Ogre::Quaternion *other = static_cast<Ogre::Quaternion *>(args[0].asPointer());
+        Ogre::Quaternion *other = get(args[0]);
 
         if (other == nullptr)
             return 0;
@@ -294,33 +363,76 @@ namespace OgreQuaternionBindings
     int quat_inverse(Interpreter *vm, void *data, int argCount, Value *args)
     {
         Ogre::Quaternion *quat = static_cast<Ogre::Quaternion *>(data);
-        Ogre::Quaternion invQuat = quat->Inverse();
-        Ogre::Quaternion *result = new Ogre::Quaternion(invQuat);
-        vm->pushPointer((void *)result);
+        vm->push(make(vm, quat->Inverse()));
         return 1;
     }
 
+    // set(w, x, y, z) - reutiliza o quaternion em vez de criar outro
+    int quat_set(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 4)
+            return 0;
+
+        Ogre::Quaternion *quat = static_cast<Ogre::Quaternion *>(data);
+        quat->w = (float)args[0].asNumber();
+        quat->x = (float)args[1].asNumber();
+        quat->y = (float)args[2].asNumber();
+        quat->z = (float)args[3].asNumber();
+        return 0;
+    }
+
+    int quat_copy(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 1)
+            return 0;
+
+        Ogre::Quaternion *other = get(args[0]);
+        if (other == nullptr)
+            return 0;
+
+        *static_cast<Ogre::Quaternion *>(data) = *other;
+        return 0;
+    }
+
+    // rotate(v) - roda o Vector3 no sítio (v = q * v)
+    int quat_rotate(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 1)
+            return 0;
+
+        Ogre::Quaternion *quat = static_cast<Ogre::Quaternion *>(data);
+        Ogre::Vector3 *vec = OgreVector3Bindings::get(args[0]);
+
+        if (vec == nullptr)
+            return 0;
+
+        *vec = *quat * *vec;
+        return 0;
+    }
+
     void registerAll(Interpreter &vm)
     {
-        NativeClassDef *quat = vm.registerNativeClass(
+        quaternionClass = vm.registerNativeValueClass(
             "Quaternion",
+            sizeof(Ogre::Quaternion),
             quat_ctor,
-            quat_dtor,
-            4,      // number of properties (w, x, y, z)
-            false   // GC collects
+            4       // number of properties (w, x, y, z)
         );
 
         // Add properties
-        vm.addNativeProperty(quat, "w", quat_getW, quat_setW);
-        vm.addNativeProperty(quat, "x", quat_getX, quat_setX);
-        vm.addNativeProperty(quat, "y", quat_getY, quat_setY);
-        vm.addNativeProperty(quat, "z", quat_getZ, quat_setZ);
+        vm.addNativeProperty(quaternionClass, "w", quat_getW, quat_setW);
+        vm.addNativeProperty(quaternionClass, "x", quat_getX, quat_setX);
+        vm.addNativeProperty(quaternionClass, "y", quat_getY, quat_setY);
+        vm.addNativeProperty(quaternionClass, "z", quat_getZ, quat_setZ);
 
         // Add methods
-        vm.addNativeMethod(quat, "normalise", quat_normalise);
-        vm.addNativeMethod(quat, "fromAxisAngle", quat_fromAxisAngle);
-        vm.addNativeMethod(quat, "multiply", quat_multiply);
-        vm.addNativeMethod(quat, "inverse", quat_inverse);
+        vm.addNativeMethod(quaternionClass, "normalise", quat_normalise);
+        vm.addNativeMethod(quaternionClass, "fromAxisAngle", quat_fromAxisAngle);
+        vm.addNativeMethod(quaternionClass, "multiply", quat_multiply);
+        vm.addNativeMethod(quaternionClass, "inverse", quat_inverse);
+        vm.addNativeMethod(quaternionClass, "set", quat_set);
+        vm.addNativeMethod(quaternionClass, "copy", quat_copy);
+        vm.addNativeMethod(quaternionClass, "rotate", quat_rotate);
 
         Info("Quaternion bindings registered");
     }
@@ -338,6 +450,7 @@ namespace OgreBindings
         OgreVector3Bindings::registerAll(vm);
         OgreQuaternionBindings::registerAll(vm);
         OgreSceneNodeBindings::registerAll(vm);
+        OgreNodeBatchBindings::registerAll(vm);
         OgreEntityBindings::registerAll(vm);
         OgrePlaneBindings::registerAll(vm);
         OgreSceneBindings::registerAll(vm);
@@ -364,6 +477,7 @@ namespace OgreBindings
  
         OgreSkeletonBindings::registerAll(vm);
         OgreLensFlareBindings::registerAll(vm);
+        OgreRaycastBindings::registerAll(vm);
 
      
     }
@@ -24,12 +24,18 @@ inline Ogre::Node::TransformSpace IntToSpace(int value)
 
 namespace OgreVector3Bindings
 {
+    extern NativeClassDef *vector3Class;
     void registerAll(Interpreter &vm);
+    Value make(Interpreter *vm, const Ogre::Vector3 &v);
+    Ogre::Vector3 *get(const Value &value); // nullptr se não for Vector3
 }
 
 namespace OgreQuaternionBindings
 {
+    extern NativeClassDef *quaternionClass;
     void registerAll(Interpreter &vm);
+    Value make(Interpreter *vm, const Ogre::Quaternion &q);
+    Ogre::Quaternion *get(const Value &value); // nullptr se não for Quaternion
 }
 
 namespace OgreSceneNodeBindings
@@ -37,6 +43,11 @@ namespace OgreSceneNodeBindings
     void registerAll(Interpreter &vm);
 }
 
+namespace OgreNodeBatchBindings
+{
+    void registerAll(Interpreter &vm);
+}
+
 namespace OgreBindings
 {
     void registerAll(Interpreter &vm);
@@ -88,6 +99,7 @@ namespace TimerBindings
 {
     void registerAll(Interpreter &vm);
     void updateTimer();
+    void setFixedDelta(double seconds); // 0 = relógio real
 }
 
 namespace CameraControllerBindings
@@ -125,7 +137,28 @@ namespace ProceduralMesh
     int createQuad(Ogre::ManualObject *manual, const char *material, float width, float height, const char *group);
     int createPlane(Ogre::ManualObject *manual, const char *material, float width, float depth, int widthSegments, int depthSegments, const char *group);
     int createCapsule(Ogre::ManualObject *manual, const char* material, float radius, float height, int segments, int rings, const char* group);
-   
+
+    // Meshes partilhados por (forma, parâmetros, material, grupo)
+    struct MeshCacheStats
+    {
+        int meshes; // meshes vivos no cache
+        int hits;
+        int misses; // = meshes gerados
+    };
+
+    Ogre::MeshPtr cubeMesh(const char *material, float size, const char *group);
+    Ogre::MeshPtr sphereMesh(const char *material, float radius, int rings, int segments, const char *group);
+    Ogre::MeshPtr cylinderMesh(const char *material, float radius, float height, int segments, const char *group);
+    Ogre::MeshPtr coneMesh(const char *material, float radius, float height, int segments, const char *group);
+    Ogre::MeshPtr torusMesh(const char *material, float majorRadius, float minorRadius, int majorSegments, int minorSegments, const char *group);
+    Ogre::MeshPtr quadMesh(const char *material, float width, float height, const char *group);
+    Ogre::MeshPtr planeMesh(const char *material, float width, float depth, int widthSegments, int depthSegments, const char *group);
+    Ogre::MeshPtr capsuleMesh(const char *material, float radius, float height, int segments, int rings, const char *group);
+
+    // Lookup sem gerar; params no formato "%g,%d,..." pela ordem dos argumentos
+    Ogre::MeshPtr findMesh(const char *shape, const char *params, const char *material, const char *group);
+    MeshCacheStats getMeshCacheStats();
+    void clearMeshCache();
 }
 
 namespace OgreManualObjectBindings
@@ -167,3 +200,8 @@ namespace OgreLensFlareBindings
 {
     void registerAll(Interpreter &vm);
 }
+
+namespace OgreRaycastBindings
+{
+    void registerAll(Interpreter &vm);
+}
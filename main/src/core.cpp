@@ -244,7 +244,8 @@ namespace OgreCoreBindings
     {
         if (!mWindow)
         {
-            Error("CreateViewPort: window not created yet");
+            // headless: não há render target; scripts testam IsHeadless()
+            Error("CreateViewPort: no window (engine not created yet or headless)");
             vm->pushNil();
             return 1;
         }
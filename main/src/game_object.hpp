@@ -92,6 +92,18 @@ class GameObject
     bool valid;
     bool started;
 
+    // Resolvidos uma vez na criação, chamados todos os frames
+    MethodHandle startMethod;
+    MethodHandle updateMethod;
+    MethodHandle renderMethod;
+
+    void resolveMethods()
+    {
+        startMethod = vm->resolveMethod(scriptInstance, "start");
+        updateMethod = vm->resolveMethod(scriptInstance, "update");
+        renderMethod = vm->resolveMethod(scriptInstance, "render");
+    }
+
 public:
     GameObject(Interpreter *vm)
         : vm(vm), valid(false), started(false)
@@ -112,6 +124,7 @@ public:
             fprintf(stderr, "GameObject: class '%s' not found\n", className);
             return false;
         }
+        resolveMethods();
         valid = true;
         return true;
     }
@@ -125,6 +138,7 @@ public:
             fprintf(stderr, "GameObject: class '%s' not found\n", className);
             return false;
         }
+        resolveMethods();
         valid = true;
         return true;
     }
@@ -132,7 +146,7 @@ public:
     void start()
     {
         if (!valid || started) return;
-        vm->callMethod(scriptInstance, "start", 0, nullptr);
+        vm->callMethod(startMethod, scriptInstance, 0, nullptr);
         started = true;
     }
 
@@ -141,13 +155,13 @@ public:
         if (!valid) return;
         Value args[1];
         args[0] = vm->makeFloat(dt);
-        vm->callMethod(scriptInstance, "update", 1, args);
+        vm->callMethod(updateMethod, scriptInstance, 1, args);
     }
 
     void render()
     {
         if (!valid) return;
-        vm->callMethod(scriptInstance, "render", 0, nullptr);
+        vm->callMethod(renderMethod, scriptInstance, 0, nullptr);
     }
 
     ScriptComponentData *getNativeData()
@@ -158,6 +172,8 @@ public:
     }
 
     Value getInstance() const { return scriptInstance; }
+    const MethodHandle &getUpdateMethod() const { return updateMethod; }
+    const MethodHandle &getRenderMethod() const { return renderMethod; }
     bool isValid() const { return valid; }
 };
 
@@ -170,6 +186,7 @@ class ScriptManager
 
     static constexpr int MAX_OBJECTS = 1024;
     GameObject *objects[MAX_OBJECTS];
+    Value batch[MAX_OBJECTS];
     int objectCount;
 
     // Static pointer so the native function can access us
@@ -229,20 +246,10 @@ public:
         // ScriptComponentBindings::registerAll(*vm);
     }
 
-    // Load and run the main script
+    // Load and run the main script (reutiliza <script>.buc se estiver válido)
     bool load(const char *mainScript)
     {
-        std::ifstream file(mainScript);
-        if (!file.is_open())
-        {
-            fprintf(stderr, "ScriptManager: cannot open '%s'\n", mainScript);
-            return false;
-        }
-
-        std::string source((std::istreambuf_iterator<char>(file)),
-                            std::istreambuf_iterator<char>());
-
-        if (!vm->run(source.c_str(), false))
+        if (!vm->runFile(mainScript, false))
         {
             fprintf(stderr, "ScriptManager: failed to compile '%s'\n", mainScript);
             return false;
@@ -262,15 +269,35 @@ public:
     // Call update(dt) on all objects
     void updateAll(float dt)
     {
-        for (int i = 0; i < objectCount; i++)
-            objects[i]->update(dt);
+        Value args[1];
+        args[0] = vm->makeFloat(dt);
+        callOnAll(&GameObject::getUpdateMethod, 1, args);
     }
 
     // Call render() on all objects
     void renderAll()
     {
-        for (int i = 0; i < objectCount; i++)
-            objects[i]->render();
+        callOnAll(&GameObject::getRenderMethod, 0, nullptr);
+    }
+
+    // Objetos seguidos da mesma classe vão num só lote (callMethodOnAll)
+    void callOnAll(const MethodHandle &(GameObject::*method)() const, int argCount, Value *args)
+    {
+        int i = 0;
+        while (i < objectCount)
+        {
+            const MethodHandle &handle = (objects[i]->*method)();
+            int count = 0;
+            while (i < objectCount && (objects[i]->*method)().func == handle.func &&
+                   (objects[i]->*method)().klass == handle.klass)
+            {
+                if (objects[i]->isValid())
+                    batch[count++] = objects[i]->getInstance();
+                i++;
+            }
+            if (handle.valid() && count > 0)
+                vm->callMethodOnAll(handle, batch, count, argCount, args);
+        }
     }
 
     // One frame: start new objects + update + render
@@ -29,6 +29,11 @@
 #include <OgreMovablePlane.h>
 #include <OgreFrameListener.h>
 #include <OgreOverlaySystem.h>
+#include <OgreDefaultHardwareBufferManager.h>
+#include <OgreControllerManager.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
 
 using namespace Ogre;
 
@@ -118,6 +123,95 @@ Ogre::RenderWindow *mWindow = nullptr;
 
 SDL_Window *sdlWindow = nullptr;
 
+// ============================================================
+// Headless / benchmark (linha de comando)
+// ============================================================
+// --headless      sem SDL video, render system nem janela: só script e cena
+// --fixed-dt=S    passo fixo de S segundos (getDeltaTime, animações); 0 = relógio real
+// --frames=N      EngineCanUpdate devolve false ao fim de N frames
+// --timing=F.csv  grava o tempo de cada frame (ms)
+
+bool HEADLESS = false;
+double FIXED_DT = 0.0;
+int MAX_FRAMES = 0;
+std::string TIMING_FILE;
+
+Ogre::DefaultHardwareBufferManager *headlessBuffers = nullptr;
+Ogre::DefaultTextureManager *headlessTextures = nullptr;
+
+// Tempo entre UpdateEngine consecutivos (script + cena + render)
+struct FrameTiming
+{
+    std::vector<float> frameMs;
+    std::chrono::steady_clock::time_point last;
+    bool started = false;
+    int frames = 0;
+
+    void record()
+    {
+        auto now = std::chrono::steady_clock::now();
+        if (started)
+            frameMs.push_back((float)std::chrono::duration<double, std::milli>(now - last).count());
+        last = now;
+        started = true;
+        frames++;
+    }
+
+    struct Summary
+    {
+        int count;
+        double totalMs, avgMs, minMs, maxMs, p50Ms, p95Ms, p99Ms;
+    };
+
+    Summary summary() const
+    {
+        Summary sum = {};
+        sum.count = (int)frameMs.size();
+        if (frameMs.empty())
+            return sum;
+
+        std::vector<float> sorted(frameMs);
+        std::sort(sorted.begin(), sorted.end());
+        for (float ms : sorted)
+            sum.totalMs += ms;
+
+        sum.avgMs = sum.totalMs / sorted.size();
+        sum.minMs = sorted.front();
+        sum.maxMs = sorted.back();
+        sum.p50Ms = sorted[sorted.size() * 50 / 100];
+        sum.p95Ms = sorted[sorted.size() * 95 / 100];
+        sum.p99Ms = sorted[sorted.size() * 99 / 100];
+        return sum;
+    }
+
+    void report() const
+    {
+        Summary sum = summary();
+        if (sum.count == 0)
+            return;
+
+        Info("Frames: %d  total %.1f ms  avg %.3f ms  min %.3f  p50 %.3f  p95 %.3f  p99 %.3f  max %.3f",
+             sum.count, sum.totalMs, sum.avgMs, sum.minMs, sum.p50Ms, sum.p95Ms, sum.p99Ms, sum.maxMs);
+
+        if (TIMING_FILE.empty())
+            return;
+
+        FILE *f = fopen(TIMING_FILE.c_str(), "w");
+        if (!f)
+        {
+            Error("Could not write timing file: %s", TIMING_FILE.c_str());
+            return;
+        }
+        fprintf(f, "frame,ms\n");
+        for (size_t i = 0; i < frameMs.size(); i++)
+            fprintf(f, "%zu,%.4f\n", i, frameMs[i]);
+        fclose(f);
+        Info("Frame timings written to %s", TIMING_FILE.c_str());
+    }
+};
+
+static FrameTiming frameTiming;
+
 // ============================================================
 // Native Functions for Script Configuration
 // ============================================================
@@ -129,16 +223,90 @@ void FreeResources()
         delete overlaySystem;
 
     if (mRoot)
+    {
+        // Sem render system o TextureManager é nosso: sai antes do ResourceGroupManager
+        if (headlessTextures)
+        {
+            mRoot->shutdown();
+            delete headlessTextures;
+        }
         delete mRoot;
+    }
+    // Meshes são libertados pelo Root: o buffer manager sai depois
+    if (headlessBuffers)
+        delete headlessBuffers;
     if (sdlWindow)
         SDL_DestroyWindow(sdlWindow);
     SDL_Quit();
 
     overlaySystem = nullptr;
     mRoot = nullptr;
+    headlessTextures = nullptr;
+    headlessBuffers = nullptr;
     sdlWindow = nullptr;
 }
 
+// Root sem render system (como nos testes do Ogre): buffers em memória,
+// materiais e meshes carregam, nada é desenhado
+static int create_headless_engine(Interpreter *vm)
+{
+    try
+    {
+        mRoot = new Root("", "", "ogre.log");
+        auto *lm = Ogre::LogManager::getSingletonPtr();
+        if (lm)
+        {
+            lm->setMinLogLevel(Ogre::LML_CRITICAL);
+        }
+
+        headlessBuffers = new Ogre::DefaultHardwareBufferManager();
+        if (!Ogre::TextureManager::getSingletonPtr())
+        {
+            headlessTextures = new Ogre::DefaultTextureManager();
+        }
+        Ogre::MaterialManager::getSingleton().initialise();
+
+        overlaySystem = new Ogre::OverlaySystem();
+
+        Info("✓ Headless engine created (fixed dt %.4f, max frames %d)", FIXED_DT, MAX_FRAMES);
+        vm->pushBool(true);
+    }
+    catch (const std::exception &e)
+    {
+        Error("Exception during headless engine creation: %s", e.what());
+        vm->pushBool(false);
+        FreeResources();
+    }
+
+    return 1;
+}
+
+// Um frame sem render: listeners, controllers (animações, partículas) e grafo de cena
+static bool headless_step_frame()
+{
+    static auto last = std::chrono::steady_clock::now();
+    auto now = std::chrono::steady_clock::now();
+    double dt = FIXED_DT > 0.0 ? FIXED_DT : std::chrono::duration<double>(now - last).count();
+    last = now;
+
+    Ogre::FrameEvent evt;
+    evt.timeSinceLastEvent = (Ogre::Real)dt;
+    evt.timeSinceLastFrame = (Ogre::Real)dt;
+
+    if (!mRoot->_fireFrameStarted(evt))
+        return false;
+
+    Ogre::ControllerManager::getSingleton().updateAllControllers();
+    for (const auto &entry : mRoot->getSceneManagers())
+    {
+        entry.second->getRootSceneNode()->_update(true, false);
+    }
+
+    if (!mRoot->_fireFrameRenderingQueued(evt))
+        return false;
+    return mRoot->_fireFrameEnded(evt);
+}
+
 // Configure window properties
 // Usage: createEngine(width, height, "title", monitor, fullscreen, canResize)
 int native_create_engine(Interpreter *vm, int argCount, Value *args)
@@ -158,6 +326,11 @@ int native_create_engine(Interpreter *vm, int argCount, Value *args)
     FULLSCREEN = args[4].asBool();
     CAN_RESIZE = args[5].asBool();
 
+    if (HEADLESS)
+    {
+        return create_headless_engine(vm);
+    }
+
     // monitor
 
     try
@@ -302,6 +475,8 @@ int native_create_engine(Interpreter *vm, int argCount, Value *args)
 
 int native_relase_engine(Interpreter *vm, int argCount, Value *args)
 {
+    if (HEADLESS || !TIMING_FILE.empty())
+        frameTiming.report();
     FreeResources();
     Info("✓ Engine resources freed");
     return 0;
@@ -316,6 +491,20 @@ int native_engine_can_update(Interpreter *vm, int argCount, Value *args)
         return 1;
     }
 
+    if (MAX_FRAMES > 0 && frameTiming.frames >= MAX_FRAMES)
+    {
+        vm->pushBool(false);
+        return 1;
+    }
+
+    if (HEADLESS)
+    {
+        InputBindings::updateInputState();
+        TimerBindings::updateTimer();
+        vm->pushBool(true);
+        return 1;
+    }
+
     SDL_Event event;
     while (SDL_PollEvent(&event))
     {
@@ -352,6 +541,8 @@ int native_engine_can_update(Interpreter *vm, int argCount, Value *args)
     return 1;
 }
 
+static const double GC_FRAME_BUDGET_US = 1000.0;
+
 int native_engine_update(Interpreter *vm, int argCount, Value *args)
 {
     if (!mRoot)
@@ -370,21 +561,48 @@ int native_engine_update(Interpreter *vm, int argCount, Value *args)
     double time = args[0].asNumber();
     (void)time;
 
-    if (!mRoot->renderOneFrame())
+    bool running = HEADLESS ? headless_step_frame() : mRoot->renderOneFrame();
+    if (!running)
     {
         vm->pushBool(false);
         return 1;
     }
 
+    if (HEADLESS || MAX_FRAMES > 0 || !TIMING_FILE.empty())
+        frameTiming.record();
+
     InputBindings::updateInputState();
 
+    // GC incremental: o frame já foi submetido, usa o resto para marcar/varrer
+    vm->gcStep(GC_FRAME_BUDGET_US);
+
     vm->pushBool(true);
     return 1;
 }
 
+// Sem janela (headless) as estatísticas vêm do FrameTiming; sem triângulos nem batches
+static Ogre::RenderTarget::FrameStats engine_stats()
+{
+    if (mWindow)
+        return mWindow->getStatistics();
+
+    Ogre::RenderTarget::FrameStats stats = {};
+    FrameTiming::Summary sum = frameTiming.summary();
+    if (sum.count > 0)
+    {
+        float lastMs = frameTiming.frameMs.back();
+        stats.lastFPS = lastMs > 0.0f ? 1000.0f / lastMs : 0.0f;
+        stats.avgFPS = sum.avgMs > 0.0 ? (float)(1000.0 / sum.avgMs) : 0.0f;
+        stats.bestFPS = sum.minMs > 0.0 ? (float)(1000.0 / sum.minMs) : 0.0f;
+        stats.bestFrameTime = (unsigned long)sum.minMs;
+        stats.worstFrameTime = (unsigned long)sum.maxMs;
+    }
+    return stats;
+}
+
 int native_get_stats(Interpreter *vm, int argCount, Value *args)
 {
-    auto stats = mWindow->getStatistics();
+    auto stats = engine_stats();
 
     vm->pushFloat(stats.lastFPS);
     vm->pushFloat(stats.avgFPS);
@@ -400,7 +618,7 @@ int native_get_stats(Interpreter *vm, int argCount, Value *args)
 
 int native_get_stats_fps(Interpreter *vm, int argCount, Value *args)
 {
-    auto stats = mWindow->getStatistics();
+    auto stats = engine_stats();
 
     vm->pushFloat(stats.lastFPS);
     vm->pushFloat(stats.avgFPS);
@@ -411,7 +629,7 @@ int native_get_stats_fps(Interpreter *vm, int argCount, Value *args)
 
 int native_get_stats_tris(Interpreter *vm, int argCount, Value *args)
 {
-    auto stats = mWindow->getStatistics();
+    auto stats = engine_stats();
 
     vm->pushDouble(stats.triangleCount);
     vm->pushDouble(stats.batchCount);
@@ -421,7 +639,7 @@ int native_get_stats_tris(Interpreter *vm, int argCount, Value *args)
 
 int native_get_stats_time(Interpreter *vm, int argCount, Value *args)
 {
-    auto stats = mWindow->getStatistics();
+    auto stats = engine_stats();
 
     vm->pushDouble(stats.bestFrameTime);
     vm->pushDouble(stats.worstFrameTime);
@@ -442,6 +660,33 @@ void TakeScreenshot(const char *fileName)
     Info(0, "Save [%s] Screenshot ", fileName);
 }
 
+// IsHeadless() -> bool
+int native_is_headless(Interpreter *vm, int argCount, Value *args)
+{
+    vm->pushBool(HEADLESS);
+    return 1;
+}
+
+// GetFrameTimings() -> {frames, total_ms, avg_ms, min_ms, p50_ms, p95_ms, p99_ms, max_ms}
+int native_get_frame_timings(Interpreter *vm, int argCount, Value *args)
+{
+    FrameTiming::Summary sum = frameTiming.summary();
+
+    Value result = vm->makeMap();
+    MapInstance *map = result.asMap();
+    map->table.set(vm->makeString("frames"), vm->makeInt(sum.count));
+    map->table.set(vm->makeString("total_ms"), vm->makeDouble(sum.totalMs));
+    map->table.set(vm->makeString("avg_ms"), vm->makeDouble(sum.avgMs));
+    map->table.set(vm->makeString("min_ms"), vm->makeDouble(sum.minMs));
+    map->table.set(vm->makeString("p50_ms"), vm->makeDouble(sum.p50Ms));
+    map->table.set(vm->makeString("p95_ms"), vm->makeDouble(sum.p95Ms));
+    map->table.set(vm->makeString("p99_ms"), vm->makeDouble(sum.p99Ms));
+    map->table.set(vm->makeString("max_ms"), vm->makeDouble(sum.maxMs));
+
+    vm->push(result);
+    return 1;
+}
+
 int native_save_screen(Interpreter *vm, int argCount, Value *args)
 {
     if (argCount < 1)
@@ -459,6 +704,7 @@ int main(int argc, char *argv[])
     Interpreter vm;
 
     vm.registerAll();
+    vm.setGCIncremental(true);
     ScriptManager engine(&vm);
     engine.registerNatives(); // exposes createGameObject() to script
 
@@ -471,6 +717,8 @@ int main(int argc, char *argv[])
     vm.registerNative("GetEngineStatsTris", native_get_stats_tris, 0);
     vm.registerNative("GetEngineStatsFps", native_get_stats_fps, 0);
     vm.registerNative("GetScreenToImage", native_save_screen, 1);
+    vm.registerNative("IsHeadless", native_is_headless, 0);
+    vm.registerNative("GetFrameTimings", native_get_frame_timings, 0);
 
     OgreBindings::registerAll(vm);
 
@@ -482,32 +730,57 @@ int main(int argc, char *argv[])
     ctx.pathCount = 4;
     vm.setFileLoader(multiPathFileLoader, &ctx);
 
-    // try
-    // {
-    // Initialize SDL
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS) < 0)
-    {
-        fprintf(stderr, "Failed to initialize SDL: %s\n", SDL_GetError());
-        return 1;
-    }
-    Info("SDL initialized");
-
+    // main [--headless] [--fixed-dt=S] [--frames=N] [--timing=file.csv] [script.bu]
     const char *scriptFile = nullptr;
 
-    if (argc > 1)
+    for (int i = 1; i < argc; i++)
     {
-        if (OsFileExists(argv[1]))
+        const char *arg = argv[i];
+        if (strcmp(arg, "--headless") == 0)
         {
-            scriptFile = argv[1];
+            HEADLESS = true;
         }
-        else
+        else if (strncmp(arg, "--fixed-dt=", 11) == 0)
         {
-            fprintf(stderr, "Specified script file does not exist: %s\n", argv[1]);
-            SDL_Quit();
+            FIXED_DT = atof(arg + 11);
+        }
+        else if (strncmp(arg, "--frames=", 9) == 0)
+        {
+            MAX_FRAMES = atoi(arg + 9);
+        }
+        else if (strncmp(arg, "--timing=", 9) == 0)
+        {
+            TIMING_FILE = arg + 9;
+        }
+        else if (strncmp(arg, "--", 2) == 0)
+        {
+            fprintf(stderr, "Unknown option: %s\n", arg);
             return 1;
         }
+        else if (!scriptFile)
+        {
+            if (!OsFileExists(arg))
+            {
+                fprintf(stderr, "Specified script file does not exist: %s\n", arg);
+                return 1;
+            }
+            scriptFile = arg;
+        }
     }
 
+    TimerBindings::setFixedDelta(FIXED_DT);
+
+    // try
+    // {
+    // Initialize SDL (headless: só eventos, não precisa de display)
+    Uint32 sdlFlags = HEADLESS ? SDL_INIT_EVENTS : (SDL_INIT_VIDEO | SDL_INIT_EVENTS);
+    if (SDL_Init(sdlFlags) < 0)
+    {
+        fprintf(stderr, "Failed to initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+    Info("SDL initialized");
+
     if (!scriptFile)
     {
         if (OsFileExists("scripts/main.bu"))
@@ -533,6 +806,10 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    // Script terminou sem ReleaseEngine: o relatório sai na mesma
+    if (mRoot && (HEADLESS || !TIMING_FILE.empty()))
+        frameTiming.report();
+
     Info("Engine shutdown complete");
     return 0;
 }
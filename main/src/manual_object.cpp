@@ -294,6 +294,259 @@ namespace OgreManualObjectBindings
         return 0;
     }
 
+    // ========== BULK (BUFFERS) ==========
+    // layout: uma letra por atributo, pela ordem em que estão no buffer
+    //   p = posição (3 floats), n = normal (3), t = UV (2), c = cor RGBA (4)
+    // Ex.: "pnt" -> 8 floats por vértice
+
+    struct VertexLayout
+    {
+        int stride;
+        int position, normal, uv, colour; // offset em floats, -1 se ausente
+    };
+
+    static bool parseLayout(const char *name, const char *layout, VertexLayout *out)
+    {
+        out->stride = 0;
+        out->position = out->normal = out->uv = out->colour = -1;
+
+        for (const char *c = layout; *c; ++c)
+        {
+            int *slot = nullptr;
+            int size = 0;
+            switch (*c)
+            {
+                case 'p': slot = &out->position; size = 3; break;
+                case 'n': slot = &out->normal; size = 3; break;
+                case 't': slot = &out->uv; size = 2; break;
+                case 'c': slot = &out->colour; size = 4; break;
+                default:
+                    Error("%s: unknown layout attribute '%c' (use p, n, t, c)", name, *c);
+                    return false;
+            }
+            if (*slot >= 0)
+            {
+                Error("%s: attribute '%c' repeated in layout", name, *c);
+                return false;
+            }
+            *slot = out->stride;
+            out->stride += size;
+        }
+
+        if (out->position < 0)
+        {
+            Error("%s: layout needs a position ('p')", name);
+            return false;
+        }
+        return true;
+    }
+
+    static BufferInstance *floatBuffer(const char *name, const Value &value, const VertexLayout &layout)
+    {
+        if (!value.isBuffer() || value.asBuffer()->type != BufferType::FLOAT)
+        {
+            Error("%s: expects a float buffer", name);
+            return nullptr;
+        }
+        BufferInstance *buf = value.asBuffer();
+        if (buf->count % layout.stride != 0)
+        {
+            Error("%s: buffer size %d is not a multiple of the layout stride %d", name, buf->count, layout.stride);
+            return nullptr;
+        }
+        return buf;
+    }
+
+    // setVertices(buffer, layout) - entre begin()/beginUpdate() e end()
+    int manual_setVertices(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 2 || !args[1].isString())
+        {
+            Error("setVertices: requires buffer, layout");
+            return 0;
+        }
+
+        Ogre::ManualObject *manual = static_cast<Ogre::ManualObject *>(data);
+        if (!manual) return 0;
+
+        VertexLayout layout;
+        if (!parseLayout("setVertices", args[1].asStringChars(), &layout))
+            return 0;
+        BufferInstance *buf = floatBuffer("setVertices", args[0], layout);
+        if (!buf)
+            return 0;
+
+        const float *src = (const float *)buf->data;
+        int vertexCount = buf->count / layout.stride;
+        manual->estimateVertexCount(vertexCount);
+
+        // position() abre cada vértice; os restantes atributos vêm a seguir
+        for (int v = 0; v < vertexCount; ++v, src += layout.stride)
+        {
+            const float *p = src + layout.position;
+            manual->position(p[0], p[1], p[2]);
+            if (layout.normal >= 0)
+            {
+                const float *n = src + layout.normal;
+                manual->normal(n[0], n[1], n[2]);
+            }
+            if (layout.uv >= 0)
+            {
+                const float *t = src + layout.uv;
+                manual->textureCoord(t[0], t[1]);
+            }
+            if (layout.colour >= 0)
+            {
+                const float *c = src + layout.colour;
+                manual->colour(c[0], c[1], c[2], c[3]);
+            }
+        }
+        return 0;
+    }
+
+    // setIndices(buffer) - buffer de inteiros (byte/short/ushort/int/uint)
+    int manual_setIndices(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 1 || !args[0].isBuffer())
+        {
+            Error("setIndices: requires an integer buffer");
+            return 0;
+        }
+
+        Ogre::ManualObject *manual = static_cast<Ogre::ManualObject *>(data);
+        if (!manual) return 0;
+
+        BufferInstance *buf = args[0].asBuffer();
+        manual->estimateIndexCount(buf->count);
+
+        switch (buf->type)
+        {
+            case BufferType::UINT8:
+                for (int i = 0; i < buf->count; ++i)
+                    manual->index(buf->data[i]);
+                break;
+            case BufferType::INT16:
+            case BufferType::UINT16:
+                for (int i = 0; i < buf->count; ++i)
+                    manual->index(((const uint16_t *)buf->data)[i]);
+                break;
+            case BufferType::INT32:
+            case BufferType::UINT32:
+                for (int i = 0; i < buf->count; ++i)
+                    manual->index(((const uint32_t *)buf->data)[i]);
+                break;
+            default:
+                Error("setIndices: expects an integer buffer");
+                break;
+        }
+        return 0;
+    }
+
+    // updateVertices(sectionIndex, buffer, layout)
+    // Escreve direto no vertex buffer de uma secção já criada com setDynamic(true),
+    // sem begin/end. O número de vértices tem de ser o mesmo da secção.
+    int manual_updateVertices(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 3 || !args[2].isString())
+        {
+            Error("updateVertices: requires sectionIndex, buffer, layout");
+            return 0;
+        }
+
+        Ogre::ManualObject *manual = static_cast<Ogre::ManualObject *>(data);
+        if (!manual) return 0;
+
+        size_t sectionIndex = (size_t)args[0].asNumber();
+        if (sectionIndex >= manual->getNumSections())
+        {
+            Error("updateVertices: section %d out of range", (int)sectionIndex);
+            return 0;
+        }
+        if (!manual->getDynamic())
+        {
+            Error("updateVertices: manual object is not dynamic (call setDynamic(true) before begin)");
+            return 0;
+        }
+
+        VertexLayout layout;
+        if (!parseLayout("updateVertices", args[2].asStringChars(), &layout))
+            return 0;
+        BufferInstance *buf = floatBuffer("updateVertices", args[1], layout);
+        if (!buf)
+            return 0;
+
+        Ogre::VertexData *vertexData = manual->getSection(sectionIndex)->getRenderOperation()->vertexData;
+        size_t vertexCount = (size_t)(buf->count / layout.stride);
+        if (vertexCount != vertexData->vertexCount)
+        {
+            Error("updateVertices: buffer has %d vertices, section has %d",
+                  (int)vertexCount, (int)vertexData->vertexCount);
+            return 0;
+        }
+
+        const Ogre::VertexDeclaration *decl = vertexData->vertexDeclaration;
+        const Ogre::VertexElement *position = decl->findElementBySemantic(Ogre::VES_POSITION);
+        const Ogre::VertexElement *normal = layout.normal >= 0 ? decl->findElementBySemantic(Ogre::VES_NORMAL) : nullptr;
+        const Ogre::VertexElement *uv = layout.uv >= 0 ? decl->findElementBySemantic(Ogre::VES_TEXTURE_COORDINATES, 0) : nullptr;
+        const Ogre::VertexElement *colour = layout.colour >= 0 ? decl->findElementBySemantic(Ogre::VES_DIFFUSE) : nullptr;
+
+        if ((layout.normal >= 0 && !normal) || (layout.uv >= 0 && !uv) || (layout.colour >= 0 && !colour) ||
+            (uv && uv->getType() != Ogre::VET_FLOAT2))
+        {
+            Error("updateVertices: layout '%s' does not match the section's vertex format", args[2].asStringChars());
+            return 0;
+        }
+
+        // Todos os atributos vêm do buffer -> podemos descartar o conteúdo antigo
+        size_t covered = 1 + (normal ? 1 : 0) + (uv ? 1 : 0) + (colour ? 1 : 0);
+        Ogre::HardwareBuffer::LockOptions lockMode = covered == decl->getElementCount()
+                                                         ? Ogre::HardwareBuffer::HBL_DISCARD
+                                                         : Ogre::HardwareBuffer::HBL_NORMAL;
+
+        Ogre::HardwareVertexBufferSharedPtr vbuf = vertexData->vertexBufferBinding->getBuffer(position->getSource());
+        size_t vertexSize = vbuf->getVertexSize();
+        Ogre::AxisAlignedBox bounds;
+
+        {
+            Ogre::HardwareBufferLockGuard lock(vbuf, lockMode);
+            uint8_t *dst = static_cast<uint8_t *>(lock.pData) + vertexData->vertexStart * vertexSize;
+            const float *src = (const float *)buf->data;
+
+            for (size_t v = 0; v < vertexCount; ++v, src += layout.stride, dst += vertexSize)
+            {
+                memcpy(dst + position->getOffset(), src + layout.position, 3 * sizeof(float));
+                bounds.merge(Ogre::Vector3(src + layout.position));
+
+                if (normal)
+                    memcpy(dst + normal->getOffset(), src + layout.normal, 3 * sizeof(float));
+                if (uv)
+                    memcpy(dst + uv->getOffset(), src + layout.uv, 2 * sizeof(float));
+                if (colour)
+                {
+                    const float *c = src + layout.colour;
+                    if (colour->getType() == Ogre::VET_FLOAT4)
+                    {
+                        memcpy(dst + colour->getOffset(), c, 4 * sizeof(float));
+                    }
+                    else
+                    {
+                        Ogre::ColourValue cv(c[0], c[1], c[2], c[3]);
+                        uint32_t packed = colour->getType() == Ogre::VET_COLOUR_ARGB ? cv.getAsARGB() : cv.getAsBYTE();
+                        memcpy(dst + colour->getOffset(), &packed, sizeof(packed));
+                    }
+                }
+            }
+        }
+
+        // Só uma secção: a caixa é exatamente a nova; com várias, só cresce
+        if (manual->getNumSections() > 1)
+        {
+            bounds.merge(manual->getBoundingBox());
+        }
+        manual->setBoundingBox(bounds);
+        return 0;
+    }
+
     // ========== PROPERTIES ==========
 
     Value manual_getDynamic(Interpreter *vm, void *data)
@@ -434,6 +687,11 @@ namespace OgreManualObjectBindings
         vm.addNativeMethod(manual, "index", manual_index);
         vm.addNativeMethod(manual, "end", manual_end);
 
+        // Bulk methods (buffers)
+        vm.addNativeMethod(manual, "setVertices", manual_setVertices);
+        vm.addNativeMethod(manual, "setIndices", manual_setIndices);
+        vm.addNativeMethod(manual, "updateVertices", manual_updateVertices);
+
         // Utility methods
         vm.addNativeMethod(manual, "clear", manual_clear);
         vm.addNativeMethod(manual, "convertToMesh", manual_convertToMesh);
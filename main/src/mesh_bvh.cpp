@@ -0,0 +1,302 @@
+#include "mesh_bvh.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// ============== MESH BVH ==============
+
+namespace
+{
+    const uint32_t kLeafSize = 4;
+    const int kMidpointDepth = 48; // a partir daqui corta sempre pela mediana
+    const int kStackSize = 128;
+
+    inline void sub(const float *a, const float *b, float *out)
+    {
+        out[0] = a[0] - b[0];
+        out[1] = a[1] - b[1];
+        out[2] = a[2] - b[2];
+    }
+
+    inline void cross(const float *a, const float *b, float *out)
+    {
+        out[0] = a[1] * b[2] - a[2] * b[1];
+        out[1] = a[2] * b[0] - a[0] * b[2];
+        out[2] = a[0] * b[1] - a[1] * b[0];
+    }
+
+    inline float dot(const float *a, const float *b)
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    // Slab test; devolve o t de entrada ou FLT_MAX se falhar
+    inline float hitBox(const float *bmin, const float *bmax, const float *origin, const float *invDir, float maxT)
+    {
+        float tmin = 0.0f;
+        float tmax = maxT;
+        for (int a = 0; a < 3; ++a)
+        {
+            float t0 = (bmin[a] - origin[a]) * invDir[a];
+            float t1 = (bmax[a] - origin[a]) * invDir[a];
+            if (t0 > t1)
+                std::swap(t0, t1);
+            // NaN (0 * inf) cai fora dos dois lados e não estreita o intervalo
+            if (t0 > tmin)
+                tmin = t0;
+            if (t1 < tmax)
+                tmax = t1;
+        }
+        return tmin <= tmax ? tmin : FLT_MAX;
+    }
+}
+
+struct MeshBVH::BuildContext
+{
+    std::vector<float> bounds;    // min xyz, max xyz por triângulo
+    std::vector<float> centroids; // xyz por triângulo
+    std::vector<uint32_t> order;  // triângulos pela ordem das folhas
+};
+
+void MeshBVH::build(const float *positions, size_t vertexCount, const uint32_t *indices, size_t indexCount)
+{
+    mNodes.clear();
+    mTriangles.clear();
+    mTriangleIds.clear();
+
+    // Triângulos com índices fora do buffer são ignorados
+    BuildContext ctx;
+    std::vector<uint32_t> source;
+    size_t triCount = indexCount / 3;
+    source.reserve(triCount);
+    ctx.bounds.reserve(triCount * 6);
+    ctx.centroids.reserve(triCount * 3);
+
+    for (size_t t = 0; t < triCount; ++t)
+    {
+        const uint32_t *tri = indices + t * 3;
+        if (tri[0] >= vertexCount || tri[1] >= vertexCount || tri[2] >= vertexCount)
+            continue;
+
+        float bmin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+        float bmax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+        for (int k = 0; k < 3; ++k)
+        {
+            const float *p = positions + tri[k] * 3;
+            for (int a = 0; a < 3; ++a)
+            {
+                bmin[a] = std::min(bmin[a], p[a]);
+                bmax[a] = std::max(bmax[a], p[a]);
+            }
+        }
+
+        source.push_back((uint32_t)t);
+        ctx.bounds.insert(ctx.bounds.end(), bmin, bmin + 3);
+        ctx.bounds.insert(ctx.bounds.end(), bmax, bmax + 3);
+        for (int a = 0; a < 3; ++a)
+            ctx.centroids.push_back((bmin[a] + bmax[a]) * 0.5f);
+    }
+
+    if (source.empty())
+        return;
+
+    // order guarda posições em 'source'; no fim traduz para ids originais
+    uint32_t count = (uint32_t)source.size();
+    ctx.order.resize(count);
+    for (uint32_t i = 0; i < count; ++i)
+        ctx.order[i] = i;
+
+    mNodes.reserve(count * 2 / kLeafSize + 1);
+    mNodes.push_back(Node());
+    buildNode(ctx, 0, 0, count, 0);
+
+    mTriangles.resize((size_t)count * 9);
+    mTriangleIds.resize(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t t = source[ctx.order[i]];
+        const uint32_t *tri = indices + (size_t)t * 3;
+        const float *v0 = positions + tri[0] * 3;
+        const float *v1 = positions + tri[1] * 3;
+        const float *v2 = positions + tri[2] * 3;
+
+        float *dst = &mTriangles[(size_t)i * 9];
+        dst[0] = v0[0];
+        dst[1] = v0[1];
+        dst[2] = v0[2];
+        sub(v1, v0, dst + 3);
+        sub(v2, v0, dst + 6);
+        mTriangleIds[i] = t;
+    }
+}
+
+void MeshBVH::buildNode(BuildContext &ctx, uint32_t nodeIndex, uint32_t first, uint32_t count, int depth)
+{
+    float bmin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float bmax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    float cmin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float cmax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+    for (uint32_t i = first; i < first + count; ++i)
+    {
+        const float *b = &ctx.bounds[(size_t)ctx.order[i] * 6];
+        const float *c = &ctx.centroids[(size_t)ctx.order[i] * 3];
+        for (int a = 0; a < 3; ++a)
+        {
+            bmin[a] = std::min(bmin[a], b[a]);
+            bmax[a] = std::max(bmax[a], b[a + 3]);
+            cmin[a] = std::min(cmin[a], c[a]);
+            cmax[a] = std::max(cmax[a], c[a]);
+        }
+    }
+
+    // mNodes pode realocar nas chamadas recursivas: não guardar referências
+    for (int a = 0; a < 3; ++a)
+    {
+        mNodes[nodeIndex].bmin[a] = bmin[a];
+        mNodes[nodeIndex].bmax[a] = bmax[a];
+    }
+
+    if (count <= kLeafSize)
+    {
+        mNodes[nodeIndex].first = first;
+        mNodes[nodeIndex].count = count;
+        return;
+    }
+
+    // Eixo mais comprido dos centróides, corte no meio; se não separar
+    // (ou a árvore já estiver funda), mediana
+    int axis = 0;
+    float extent = cmax[0] - cmin[0];
+    for (int a = 1; a < 3; ++a)
+    {
+        if (cmax[a] - cmin[a] > extent)
+        {
+            axis = a;
+            extent = cmax[a] - cmin[a];
+        }
+    }
+
+    uint32_t *begin = ctx.order.data() + first;
+    uint32_t *end = begin + count;
+    const float *centroids = ctx.centroids.data();
+    uint32_t *mid = begin;
+
+    if (extent > 0.0f && depth < kMidpointDepth)
+    {
+        float split = (cmin[axis] + cmax[axis]) * 0.5f;
+        mid = std::partition(begin, end, [&](uint32_t t)
+                             { return centroids[(size_t)t * 3 + axis] < split; });
+    }
+    if (mid == begin || mid == end)
+    {
+        mid = begin + count / 2;
+        std::nth_element(begin, mid, end, [&](uint32_t a, uint32_t b)
+                         { return centroids[(size_t)a * 3 + axis] < centroids[(size_t)b * 3 + axis]; });
+    }
+
+    uint32_t leftCount = (uint32_t)(mid - begin);
+
+    uint32_t left = (uint32_t)mNodes.size();
+    mNodes.push_back(Node());
+    buildNode(ctx, left, first, leftCount, depth + 1);
+
+    uint32_t right = (uint32_t)mNodes.size();
+    mNodes.push_back(Node());
+    buildNode(ctx, right, first + leftCount, count - leftCount, depth + 1);
+
+    mNodes[nodeIndex].first = right;
+    mNodes[nodeIndex].count = 0;
+}
+
+bool MeshBVH::intersect(const float origin[3], const float dir[3], float maxDistance, BVHHit *hit) const
+{
+    if (mNodes.empty())
+        return false;
+
+    float invDir[3];
+    for (int a = 0; a < 3; ++a)
+        invDir[a] = 1.0f / dir[a];
+
+    float best = maxDistance;
+    bool found = false;
+
+    uint32_t stack[kStackSize];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const Node &node = mNodes[stack[--top]];
+        if (hitBox(node.bmin, node.bmax, origin, invDir, best) == FLT_MAX)
+            continue;
+
+        if (node.count > 0)
+        {
+            // Möller–Trumbore
+            for (uint32_t i = node.first; i < node.first + node.count; ++i)
+            {
+                const float *tri = &mTriangles[(size_t)i * 9];
+                const float *e1 = tri + 3;
+                const float *e2 = tri + 6;
+
+                float p[3];
+                cross(dir, e2, p);
+                float det = dot(e1, p);
+                if (std::fabs(det) < 1e-12f)
+                    continue;
+                float invDet = 1.0f / det;
+
+                float s[3];
+                sub(origin, tri, s);
+                float u = dot(s, p) * invDet;
+                if (u < 0.0f || u > 1.0f)
+                    continue;
+
+                float q[3];
+                cross(s, e1, q);
+                float v = dot(dir, q) * invDet;
+                if (v < 0.0f || u + v > 1.0f)
+                    continue;
+
+                float t = dot(e2, q) * invDet;
+                if (t >= 0.0f && t < best)
+                {
+                    best = t;
+                    found = true;
+                    hit->distance = t;
+                    hit->triangle = mTriangleIds[i];
+                    hit->u = u;
+                    hit->v = v;
+                }
+            }
+            continue;
+        }
+
+        // Filho mais próximo por cima da pilha
+        uint32_t left = (uint32_t)(&node - mNodes.data()) + 1;
+        uint32_t right = node.first;
+        float tl = hitBox(mNodes[left].bmin, mNodes[left].bmax, origin, invDir, best);
+        float tr = hitBox(mNodes[right].bmin, mNodes[right].bmax, origin, invDir, best);
+
+        if (top + 2 > kStackSize)
+            return found; // não acontece: a profundidade é limitada no build
+
+        if (tl <= tr)
+        {
+            if (tr != FLT_MAX)
+                stack[top++] = right;
+            if (tl != FLT_MAX)
+                stack[top++] = left;
+        }
+        else
+        {
+            if (tl != FLT_MAX)
+                stack[top++] = left;
+            stack[top++] = right;
+        }
+    }
+
+    return found;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ============== MESH BVH ==============
+// BVH de triângulos para raycasts exatos. Não depende do Ogre: recebe
+// posições (x y z por vértice) e índices de uma lista de triângulos.
+// intersect() só lê a árvore, pode ser chamado de várias threads.
+
+struct BVHHit
+{
+    float distance;    // em unidades de 'dir' (t do raio)
+    uint32_t triangle; // índice do triângulo na lista original
+    float u, v;        // baricêntricas
+};
+
+class MeshBVH
+{
+public:
+    void build(const float *positions, size_t vertexCount, const uint32_t *indices, size_t indexCount);
+
+    // Triângulo mais próximo com 0 <= t < maxDistance
+    bool intersect(const float origin[3], const float dir[3], float maxDistance, BVHHit *hit) const;
+
+    size_t triangleCount() const { return mTriangles.size() / 9; }
+    size_t nodeCount() const { return mNodes.size(); }
+
+private:
+    struct Node
+    {
+        float bmin[3];
+        float bmax[3];
+        uint32_t first; // folha: primeiro triângulo; interno: filho direito (esquerdo = this + 1)
+        uint32_t count; // 0 = nó interno
+    };
+
+    struct BuildContext;
+    void buildNode(BuildContext &ctx, uint32_t nodeIndex, uint32_t first, uint32_t count, int depth);
+
+    std::vector<Node> mNodes;
+    std::vector<float> mTriangles; // v0, e1 = v1 - v0, e2 = v2 - v0 (9 floats), pela ordem das folhas
+    std::vector<uint32_t> mTriangleIds;
+};
@@ -85,77 +85,39 @@ namespace OgreSceneNodeBindings
         node->setScale(s);
     }
 
-    // Position property getter - returns Vector3 (as NativeClass)
+    // Position property getter - returns Vector3 (classe valor, sem new)
     Value node_getPosition(Interpreter *vm, void *data)
     {
         Ogre::SceneNode *node = static_cast<Ogre::SceneNode *>(data);
-        Ogre::Vector3 pos = node->getPosition();
-
-        // Get the Vector3 NativeClassDef
-        NativeClassDef *vec3Class = nullptr;
-        if (!vm->tryGetNativeClassDef("Vector3", &vec3Class))
-        {
-            Error("Vector3 class not found in VM");
-            return vm->makeNil();
-        }
-
-        // Create Vector3 natively using VM (GC will manage it)
-        Ogre::Vector3 *vec = new Ogre::Vector3(pos.x, pos.y, pos.z);
-
-        Value vecValue = vm->makeNativeClassInstance(false);
-        NativeClassInstance *instance = vecValue.asNativeClassInstance();
-        instance->klass = vec3Class;
-        instance->userData = (void *)vec;
-
-        return vecValue;
+        return OgreVector3Bindings::make(vm, node->getPosition());
     }
 
     // Position property setter - accepts Vector3
     void node_setPosition(Interpreter *vm, void *data, Value value)
     {
         Ogre::SceneNode *node = static_cast<Ogre::SceneNode *>(data);
-        NativeClassInstance *vecInstance = value.asNativeClassInstance();
-        Ogre::Vector3 *vec = static_cast<Ogre::Vector3 *>(vecInstance->userData);
-        node->setPosition(*vec);
+        Ogre::Vector3 *vec = OgreVector3Bindings::get(value);
+        if (vec)
+        {
+            node->setPosition(*vec);
+        }
     }
 
-    // Scale property getter - returns Vector3 (as NativeClass)
+    // Scale property getter - returns Vector3
     Value node_getScale(Interpreter *vm, void *data)
     {
         Ogre::SceneNode *node = static_cast<Ogre::SceneNode *>(data);
-        Ogre::Vector3 scale = node->getScale();
-
-        // Get the Vector3 NativeClassDef
-        NativeClassDef *vec3Class = nullptr;
-        if (!vm->tryGetNativeClassDef("Vector3", &vec3Class))
-        {
-            Error("Vector3 class not found in VM");
-            return vm->makeNil();
-        }
-
-        // Create Vector3 natively using VM (GC will manage it)
-        Ogre::Vector3 *vec = new Ogre::Vector3(scale.x, scale.y, scale.z);
-
-        Value vecValue = vm->makeNativeClassInstance(false);
-        NativeClassInstance *instance = vecValue.asNativeClassInstance();
-        instance->klass = vec3Class;
-        instance->userData = (void *)vec;
-
-        return vecValue;
+        return OgreVector3Bindings::make(vm, node->getScale());
     }
 
     // Scale property setter - accepts Vector3
     void node_setScale(Interpreter *vm, void *data, Value value)
     {
         Ogre::SceneNode *node = static_cast<Ogre::SceneNode *>(data);
-
-        if (value.isPointer())
+        Ogre::Vector3 *vec = OgreVector3Bindings::get(value);
+        if (vec)
         {
-            Ogre::Vector3 *vec = static_cast<Ogre::Vector3 *>(value.asPointer());
-            if (vec)
-            {
-                node->setScale(*vec);
-            }
+            node->setScale(*vec);
         }
     }
 
@@ -358,24 +320,7 @@ namespace OgreSceneNodeBindings
     int node_getWorldPosition(Interpreter *vm, void *data, int argCount, Value *args)
     {
         Ogre::SceneNode *node = static_cast<Ogre::SceneNode *>(data);
-        Ogre::Vector3 worldPos = node->_getDerivedPosition();
-
-        // Get the Vector3 NativeClassDef
-        NativeClassDef *vec3Class = nullptr;
-        if (!vm->tryGetNativeClassDef("Vector3", &vec3Class))
-        {
-            Error("Vector3 class not found in VM");
-            return 0;
-        }
-
-        Ogre::Vector3 *vec = new Ogre::Vector3(worldPos.x, worldPos.y, worldPos.z);
-
-        Value vecValue = vm->makeNativeClassInstance(false);
-        NativeClassInstance *instance = vecValue.asNativeClassInstance();
-        instance->klass = vec3Class;
-        instance->userData = (void *)vec;
-
-        vm->push(vecValue);
+        vm->push(OgreVector3Bindings::make(vm, node->_getDerivedPosition()));
         return 1;
     }
 
@@ -383,23 +328,7 @@ namespace OgreSceneNodeBindings
     int node_getWorldScale(Interpreter *vm, void *data, int argCount, Value *args)
     {
         Ogre::SceneNode *node = static_cast<Ogre::SceneNode *>(data);
-        Ogre::Vector3 worldScale = node->_getDerivedScale();
-
-        NativeClassDef *vec3Class = nullptr;
-        if (!vm->tryGetNativeClassDef("Vector3", &vec3Class))
-        {
-            Error("Vector3 class not found in VM");
-            return 0;
-        }
-
-        Ogre::Vector3 *vec = new Ogre::Vector3(worldScale.x, worldScale.y, worldScale.z);
-
-        Value vecValue = vm->makeNativeClassInstance(false);
-        NativeClassInstance *instance = vecValue.asNativeClassInstance();
-        instance->klass = vec3Class;
-        instance->userData = (void *)vec;
-
-        vm->push(vecValue);
+        vm->push(OgreVector3Bindings::make(vm, node->_getDerivedScale()));
         return 1;
     }
 
@@ -502,25 +431,7 @@ namespace OgreSceneNodeBindings
     int node_getOrientation(Interpreter *vm, void *data, int argCount, Value *args)
     {
         Ogre::SceneNode *node = static_cast<Ogre::SceneNode *>(data);
-        Ogre::Quaternion orientation = node->getOrientation();
-
-        // Get the Quaternion NativeClassDef
-        NativeClassDef *quatClass = nullptr;
-        if (!vm->tryGetNativeClassDef("Quaternion", &quatClass))
-        {
-            Error("Quaternion class not found in VM");
-            return 0;
-        }
-
-        // Create Quaternion natively using VM (GC will manage it)
-        Ogre::Quaternion *quat = new Ogre::Quaternion(orientation.w, orientation.x, orientation.y, orientation.z);
-
-        Value quatValue = vm->makeNativeClassInstance(false);
-        NativeClassInstance *instance = quatValue.asNativeClassInstance();
-        instance->klass = quatClass;
-        instance->userData = (void *)quat;
-
-        vm->push(quatValue);
+        vm->push(OgreQuaternionBindings::make(vm, node->getOrientation()));
         return 1;
     }
 
@@ -585,46 +496,78 @@ namespace OgreSceneNodeBindings
         // Por padrão, a direção é -Z no sistema local
         Ogre::Vector3 direction = node->getOrientation() * Ogre::Vector3::NEGATIVE_UNIT_Z;
 
-        NativeClassDef *vec3Class = nullptr;
-        if (!vm->tryGetNativeClassDef("Vector3", &vec3Class))
-        {
-            Error("Vector3 class not found in VM");
-            return 0;
-        }
-
-        Ogre::Vector3 *vec = new Ogre::Vector3(direction.x, direction.y, direction.z);
-
-        Value vecValue = vm->makeNativeClassInstance(false);
-        NativeClassInstance *instance = vecValue.asNativeClassInstance();
-        instance->klass = vec3Class;
-        instance->userData = (void *)vec;
-
-        vm->push(vecValue);
+        vm->push(OgreVector3Bindings::make(vm, direction));
         return 1;
     }
 
     int node_getPosition(Interpreter *vm, void *data, int argCount, Value *args)
     {
         Ogre::SceneNode *node = static_cast<Ogre::SceneNode *>(data);
-        Ogre::Vector3 pos = node->getPosition();
+        vm->push(OgreVector3Bindings::make(vm, node->getPosition()));
+        return 1;
+    }
 
-        // Get the Vector3 NativeClassDef
-        NativeClassDef *vec3Class = nullptr;
-        if (!vm->tryGetNativeClassDef("Vector3", &vec3Class))
+    // Variantes *To(out): escrevem num Vector3/Quaternion existente, para
+    // loops por frame não alocarem nada
+    int node_getPositionTo(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        Ogre::Vector3 *out = argCount > 0 ? OgreVector3Bindings::get(args[0]) : nullptr;
+        if (!out)
         {
-            Error("Vector3 class not found in VM");
+            Error("getPositionTo: Expected Vector3 argument");
             return 0;
         }
+        *out = static_cast<Ogre::SceneNode *>(data)->getPosition();
+        return 0;
+    }
 
-        Ogre::Vector3 *vec = new Ogre::Vector3(pos.x, pos.y, pos.z);
+    int node_getScaleTo(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        Ogre::Vector3 *out = argCount > 0 ? OgreVector3Bindings::get(args[0]) : nullptr;
+        if (!out)
+        {
+            Error("getScaleTo: Expected Vector3 argument");
+            return 0;
+        }
+        *out = static_cast<Ogre::SceneNode *>(data)->getScale();
+        return 0;
+    }
 
-        Value vecValue = vm->makeNativeClassInstance(false);
-        NativeClassInstance *instance = vecValue.asNativeClassInstance();
-        instance->klass = vec3Class;
-        instance->userData = (void *)vec;
+    int node_getWorldPositionTo(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        Ogre::Vector3 *out = argCount > 0 ? OgreVector3Bindings::get(args[0]) : nullptr;
+        if (!out)
+        {
+            Error("getWorldPositionTo: Expected Vector3 argument");
+            return 0;
+        }
+        *out = static_cast<Ogre::SceneNode *>(data)->_getDerivedPosition();
+        return 0;
+    }
 
-        vm->push(vecValue);
-        return 1;
+    int node_getOrientationTo(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        Ogre::Quaternion *out = argCount > 0 ? OgreQuaternionBindings::get(args[0]) : nullptr;
+        if (!out)
+        {
+            Error("getOrientationTo: Expected Quaternion argument");
+            return 0;
+        }
+        *out = static_cast<Ogre::SceneNode *>(data)->getOrientation();
+        return 0;
+    }
+
+    // setOrientationQ(q) - define orientação a partir de um Quaternion
+    int node_setOrientationQ(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        Ogre::Quaternion *quat = argCount > 0 ? OgreQuaternionBindings::get(args[0]) : nullptr;
+        if (!quat)
+        {
+            Error("setOrientationQ: Expected Quaternion argument");
+            return 0;
+        }
+        static_cast<Ogre::SceneNode *>(data)->setOrientation(*quat);
+        return 0;
     }
 
     int node_getPositionV(Interpreter *vm, void *data, int argCount, Value *args)
@@ -793,6 +736,9 @@ namespace OgreSceneNodeBindings
         vm.addNativeMethod(node, "setPosition", node_method_setPosition);
         vm.addNativeMethod(node, "getPosition", node_getPosition);
         vm.addNativeMethod(node, "getPositionV", node_getPositionV);
+        vm.addNativeMethod(node, "getPositionTo", node_getPositionTo);
+        vm.addNativeMethod(node, "getScaleTo", node_getScaleTo);
+        vm.addNativeMethod(node, "getWorldPositionTo", node_getWorldPositionTo);
  
 
         vm.addNativeMethod(node, "translate", node_moveRelative);
@@ -815,6 +761,8 @@ namespace OgreSceneNodeBindings
         // Orientação com Quaternion
         vm.addNativeMethod(node, "getOrientation", node_getOrientation);
         vm.addNativeMethod(node, "setOrientation", node_setOrientation);
+        vm.addNativeMethod(node, "getOrientationTo", node_getOrientationTo);
+        vm.addNativeMethod(node, "setOrientationQ", node_setOrientationQ);
 
         // Direção
         vm.addNativeMethod(node, "setDirection", node_setDirection);
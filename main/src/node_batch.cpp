@@ -0,0 +1,274 @@
+#include "bindings.hpp"
+
+// ============== NODE BATCH ==============
+// Lista de SceneNodes atualizada de uma vez a partir de um buffer de floats.
+// Layout por omissão AoS: [x y z  x y z ...]; com soa = true: [x x ... y y ... z z ...]
+// Os nós continuam a ser do Ogre: destruir um nó sem o tirar do batch deixa-o pendurado.
+// Antes de destruir um nó, tira-o com remove(index); os seguintes descem uma posição.
+
+namespace OgreNodeBatchBindings
+{
+    // Resolvida no registerAll (o SceneNode regista-se antes)
+    NativeClassDef *sceneNodeClass = nullptr;
+
+    struct NodeBatch
+    {
+        std::vector<Ogre::SceneNode *> nodes;
+    };
+
+    static inline float component(const float *src, size_t count, size_t i, int c, int width, bool soa)
+    {
+        return soa ? src[c * count + i] : src[i * width + c];
+    }
+
+    static inline void store(float *dst, size_t count, size_t i, int c, int width, bool soa, float value)
+    {
+        if (soa)
+            dst[c * count + i] = value;
+        else
+            dst[i * width + c] = value;
+    }
+
+    // Buffer float com pelo menos count * width elementos
+    static float *floatBuffer(const char *name, const Value &value, size_t count, int width)
+    {
+        if (!value.isBuffer() || value.asBuffer()->type != BufferType::FLOAT)
+        {
+            Error("%s: expects a float buffer", name);
+            return nullptr;
+        }
+        BufferInstance *buf = value.asBuffer();
+        if ((size_t)buf->count < count * width)
+        {
+            Error("%s: buffer has %d floats, needs %d", name, buf->count, (int)(count * width));
+            return nullptr;
+        }
+        return (float *)buf->data;
+    }
+
+    static bool soaArg(int argCount, Value *args, int index)
+    {
+        return argCount > index && args[index].asBool();
+    }
+
+    // Constructor: NodeBatch()
+    void *batch_ctor(Interpreter *vm, int argCount, Value *args)
+    {
+        return new NodeBatch();
+    }
+
+    void batch_dtor(Interpreter *vm, void *data)
+    {
+        delete static_cast<NodeBatch *>(data);
+    }
+
+    // add(node) -> índice no batch
+    int batch_add(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        NodeBatch *batch = static_cast<NodeBatch *>(data);
+
+        if (argCount < 1 || !args[0].isNativeClassInstance() ||
+            args[0].asNativeClassInstance()->klass != sceneNodeClass)
+        {
+            Error("NodeBatch.add: expects a SceneNode");
+            vm->pushInt(-1);
+            return 1;
+        }
+
+        batch->nodes.push_back(static_cast<Ogre::SceneNode *>(args[0].asNativeClassInstance()->userData));
+        vm->pushInt((int)batch->nodes.size() - 1);
+        return 1;
+    }
+
+    // remove(index) -> true se existia; os índices seguintes descem um
+    int batch_remove(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        NodeBatch *batch = static_cast<NodeBatch *>(data);
+        if (argCount < 1 || !args[0].isNumber())
+        {
+            Error("NodeBatch.remove: expects an index");
+            vm->pushBool(false);
+            return 1;
+        }
+
+        int index = (int)args[0].asNumber();
+        if (index < 0 || index >= (int)batch->nodes.size())
+        {
+            vm->pushBool(false);
+            return 1;
+        }
+
+        batch->nodes.erase(batch->nodes.begin() + index);
+        vm->pushBool(true);
+        return 1;
+    }
+
+    // clear()
+    int batch_clear(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        static_cast<NodeBatch *>(data)->nodes.clear();
+        return 0;
+    }
+
+    // setPositions(buffer, [soa]) - 3 floats por nó
+    int batch_setPositions(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 1) return 0;
+        NodeBatch *batch = static_cast<NodeBatch *>(data);
+        size_t count = batch->nodes.size();
+
+        const float *src = floatBuffer("setPositions", args[0], count, 3);
+        if (!src) return 0;
+        bool soa = soaArg(argCount, args, 1);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            batch->nodes[i]->setPosition(component(src, count, i, 0, 3, soa),
+                                         component(src, count, i, 1, 3, soa),
+                                         component(src, count, i, 2, 3, soa));
+        }
+        return 0;
+    }
+
+    // setOrientations(buffer, [soa]) - quaternion w, x, y, z por nó
+    int batch_setOrientations(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 1) return 0;
+        NodeBatch *batch = static_cast<NodeBatch *>(data);
+        size_t count = batch->nodes.size();
+
+        const float *src = floatBuffer("setOrientations", args[0], count, 4);
+        if (!src) return 0;
+        bool soa = soaArg(argCount, args, 1);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            batch->nodes[i]->setOrientation(component(src, count, i, 0, 4, soa),
+                                            component(src, count, i, 1, 4, soa),
+                                            component(src, count, i, 2, 4, soa),
+                                            component(src, count, i, 3, 4, soa));
+        }
+        return 0;
+    }
+
+    // setScales(buffer, [soa]) - 3 floats por nó
+    int batch_setScales(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 1) return 0;
+        NodeBatch *batch = static_cast<NodeBatch *>(data);
+        size_t count = batch->nodes.size();
+
+        const float *src = floatBuffer("setScales", args[0], count, 3);
+        if (!src) return 0;
+        bool soa = soaArg(argCount, args, 1);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            batch->nodes[i]->setScale(component(src, count, i, 0, 3, soa),
+                                      component(src, count, i, 1, 3, soa),
+                                      component(src, count, i, 2, 3, soa));
+        }
+        return 0;
+    }
+
+    // setTransforms(buffer, [soa]) - posição + quaternion (x y z w qx qy qz) por nó
+    int batch_setTransforms(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 1) return 0;
+        NodeBatch *batch = static_cast<NodeBatch *>(data);
+        size_t count = batch->nodes.size();
+
+        const float *src = floatBuffer("setTransforms", args[0], count, 7);
+        if (!src) return 0;
+        bool soa = soaArg(argCount, args, 1);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            Ogre::SceneNode *node = batch->nodes[i];
+            node->setPosition(component(src, count, i, 0, 7, soa),
+                              component(src, count, i, 1, 7, soa),
+                              component(src, count, i, 2, 7, soa));
+            node->setOrientation(component(src, count, i, 3, 7, soa),
+                                 component(src, count, i, 4, 7, soa),
+                                 component(src, count, i, 5, 7, soa),
+                                 component(src, count, i, 6, 7, soa));
+        }
+        return 0;
+    }
+
+    // getWorldPositions(buffer, [soa]) - escreve a posição global de cada nó
+    int batch_getWorldPositions(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 1) return 0;
+        NodeBatch *batch = static_cast<NodeBatch *>(data);
+        size_t count = batch->nodes.size();
+
+        float *dst = floatBuffer("getWorldPositions", args[0], count, 3);
+        if (!dst) return 0;
+        bool soa = soaArg(argCount, args, 1);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Ogre::Vector3 &p = batch->nodes[i]->_getDerivedPosition();
+            store(dst, count, i, 0, 3, soa, p.x);
+            store(dst, count, i, 1, 3, soa, p.y);
+            store(dst, count, i, 2, 3, soa, p.z);
+        }
+        return 0;
+    }
+
+    // getWorldOrientations(buffer, [soa]) - quaternion global w, x, y, z
+    int batch_getWorldOrientations(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 1) return 0;
+        NodeBatch *batch = static_cast<NodeBatch *>(data);
+        size_t count = batch->nodes.size();
+
+        float *dst = floatBuffer("getWorldOrientations", args[0], count, 4);
+        if (!dst) return 0;
+        bool soa = soaArg(argCount, args, 1);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Ogre::Quaternion &q = batch->nodes[i]->_getDerivedOrientation();
+            store(dst, count, i, 0, 4, soa, q.w);
+            store(dst, count, i, 1, 4, soa, q.x);
+            store(dst, count, i, 2, 4, soa, q.y);
+            store(dst, count, i, 3, 4, soa, q.z);
+        }
+        return 0;
+    }
+
+    // Property: count (read-only)
+    Value batch_getCount(Interpreter *vm, void *data)
+    {
+        return vm->makeInt((int)static_cast<NodeBatch *>(data)->nodes.size());
+    }
+
+    void registerAll(Interpreter &vm)
+    {
+        vm.tryGetNativeClassDef("SceneNode", &sceneNodeClass);
+
+        NativeClassDef *batch = vm.registerNativeClass(
+            "NodeBatch",
+            batch_ctor,
+            batch_dtor,
+            0,
+            false);
+
+        vm.addNativeProperty(batch, "count", batch_getCount);
+
+        vm.addNativeMethod(batch, "add", batch_add);
+        vm.addNativeMethod(batch, "remove", batch_remove);
+        vm.addNativeMethod(batch, "clear", batch_clear);
+
+        vm.addNativeMethod(batch, "setPositions", batch_setPositions);
+        vm.addNativeMethod(batch, "setOrientations", batch_setOrientations);
+        vm.addNativeMethod(batch, "setScales", batch_setScales);
+        vm.addNativeMethod(batch, "setTransforms", batch_setTransforms);
+
+        vm.addNativeMethod(batch, "getWorldPositions", batch_getWorldPositions);
+        vm.addNativeMethod(batch, "getWorldOrientations", batch_getWorldOrientations);
+    }
+
+} // namespace OgreNodeBatchBindings
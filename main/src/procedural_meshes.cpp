@@ -1,4 +1,5 @@
 #include "bindings.hpp"
+#include <unordered_map>
 
 
 // ============== PROCEDURAL MESH GENERATION ==============
@@ -633,4 +634,143 @@ namespace ProceduralMesh
         return 1;
     }
 
+    // ========== MESH CACHE ==========
+    // Cada combinação (forma, parâmetros, material, grupo) é gerada uma só vez
+    // para um Ogre::Mesh partilhado; as Entities seguintes só o referenciam.
+
+    static std::unordered_map<Ogre::String, Ogre::MeshPtr> meshCache;
+    static MeshCacheStats cacheStats = {0, 0, 0};
+
+    static Ogre::String cacheKey(const char *shape, const char *params, const char *material, const char *group)
+    {
+        Ogre::String key = shape;
+        key += '|';
+        key += params;
+        key += '|';
+        key += material;
+        key += '|';
+        key += group ? group : Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME.c_str();
+        return key;
+    }
+
+    // Procura no cache; se falhar, gera num ManualObject temporário e converte
+    template <typename Build>
+    static Ogre::MeshPtr bake(const Ogre::String &key, const char *group, Build build)
+    {
+        auto it = meshCache.find(key);
+        if (it != meshCache.end())
+        {
+            cacheStats.hits++;
+            return it->second;
+        }
+
+        Ogre::String groupName = Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME;
+        if (group != NULL)
+        {
+            groupName = group;
+        }
+
+        char meshName[48];
+        snprintf(meshName, sizeof(meshName), "__proc_mesh_%d", cacheStats.misses);
+
+        Ogre::ManualObject manual(meshName);
+        build(&manual);
+        Ogre::MeshPtr mesh = manual.convertToMesh(meshName, groupName);
+
+        cacheStats.misses++;
+        cacheStats.meshes++;
+        meshCache[key] = mesh;
+        return mesh;
+    }
+
+    Ogre::MeshPtr cubeMesh(const char *material, float size, const char *group)
+    {
+        char params[64];
+        snprintf(params, sizeof(params), "%g", size);
+        return bake(cacheKey("cube", params, material, group), group,
+                    [&](Ogre::ManualObject *m) { createCube(m, material, size, group); });
+    }
+
+    Ogre::MeshPtr sphereMesh(const char *material, float radius, int rings, int segments, const char *group)
+    {
+        char params[64];
+        snprintf(params, sizeof(params), "%g,%d,%d", radius, rings, segments);
+        return bake(cacheKey("sphere", params, material, group), group,
+                    [&](Ogre::ManualObject *m) { createSphere(m, material, radius, rings, segments, group); });
+    }
+
+    Ogre::MeshPtr cylinderMesh(const char *material, float radius, float height, int segments, const char *group)
+    {
+        char params[64];
+        snprintf(params, sizeof(params), "%g,%g,%d", radius, height, segments);
+        return bake(cacheKey("cylinder", params, material, group), group,
+                    [&](Ogre::ManualObject *m) { createCylinder(m, material, radius, height, segments, group); });
+    }
+
+    Ogre::MeshPtr coneMesh(const char *material, float radius, float height, int segments, const char *group)
+    {
+        char params[64];
+        snprintf(params, sizeof(params), "%g,%g,%d", radius, height, segments);
+        return bake(cacheKey("cone", params, material, group), group,
+                    [&](Ogre::ManualObject *m) { createCone(m, material, radius, height, segments, group); });
+    }
+
+    Ogre::MeshPtr torusMesh(const char *material, float majorRadius, float minorRadius, int majorSegments, int minorSegments, const char *group)
+    {
+        char params[96];
+        snprintf(params, sizeof(params), "%g,%g,%d,%d", majorRadius, minorRadius, majorSegments, minorSegments);
+        return bake(cacheKey("torus", params, material, group), group,
+                    [&](Ogre::ManualObject *m) { createTorus(m, material, majorRadius, minorRadius, majorSegments, minorSegments, group); });
+    }
+
+    Ogre::MeshPtr quadMesh(const char *material, float width, float height, const char *group)
+    {
+        char params[64];
+        snprintf(params, sizeof(params), "%g,%g", width, height);
+        return bake(cacheKey("quad", params, material, group), group,
+                    [&](Ogre::ManualObject *m) { createQuad(m, material, width, height, group); });
+    }
+
+    Ogre::MeshPtr planeMesh(const char *material, float width, float depth, int widthSegments, int depthSegments, const char *group)
+    {
+        char params[96];
+        snprintf(params, sizeof(params), "%g,%g,%d,%d", width, depth, widthSegments, depthSegments);
+        return bake(cacheKey("plane", params, material, group), group,
+                    [&](Ogre::ManualObject *m) { createPlane(m, material, width, depth, widthSegments, depthSegments, group); });
+    }
+
+    Ogre::MeshPtr capsuleMesh(const char *material, float radius, float height, int segments, int rings, const char *group)
+    {
+        char params[96];
+        snprintf(params, sizeof(params), "%g,%g,%d,%d", radius, height, segments, rings);
+        return bake(cacheKey("capsule", params, material, group), group,
+                    [&](Ogre::ManualObject *m) { createCapsule(m, material, radius, height, segments, rings, group); });
+    }
+
+    Ogre::MeshPtr findMesh(const char *shape, const char *params, const char *material, const char *group)
+    {
+        auto it = meshCache.find(cacheKey(shape, params, material, group));
+        if (it == meshCache.end())
+        {
+            return Ogre::MeshPtr();
+        }
+        return it->second;
+    }
+
+    MeshCacheStats getMeshCacheStats()
+    {
+        return cacheStats;
+    }
+
+    // Entities já criadas mantêm o seu MeshPtr; só deixa de haver partilha
+    void clearMeshCache()
+    {
+        for (auto &entry : meshCache)
+        {
+            Ogre::MeshManager::getSingleton().remove(entry.second);
+        }
+        meshCache.clear();
+        cacheStats.meshes = 0;
+    }
+
 } // namespace ProceduralMeshBindings
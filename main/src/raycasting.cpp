@@ -1,5 +1,13 @@
 #include "bindings.hpp"
+#include "mesh_bvh.hpp"
 #include <OgreRay.h>
+#include <algorithm>
+#include <cfloat>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 
 // ============== OGRE RAYCASTING BINDINGS ==============
@@ -252,6 +260,463 @@ namespace OgreRaycastBindings
         return 1;
     }
 
+    // ========== RAY QUERY (persistente, em lote) ==========
+    // RayQuery(scene): um RaySceneQuery reutilizado entre chamadas.
+    // cast(rays, hits, [maxDistance]) -> número de raios com hit
+    //   rays: buffer float, 6 por raio (origem xyz, direção xyz)
+    //   hits: buffer float, 4 por raio (distância ou -1, ponto xyz)
+    // Com exact = true, as Entities são testadas triângulo a triângulo numa BVH
+    // por mesh (pose de bind; sem animação por skeleton), em paralelo por raio.
+
+    // Threads do narrow phase, criadas no primeiro cast grande e reutilizadas
+    // entre frames (criar e juntar threads a cada cast custava mais do que o
+    // trabalho). Abaixo de kParallelMinRays corre tudo na thread que chama.
+    class RayWorkers
+    {
+    public:
+        static const size_t kParallelMinRays = 256;
+
+        ~RayWorkers()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (std::thread &t : threads)
+                t.join();
+        }
+
+        // fn(i) para i em [0, count); quem chama faz a primeira fatia
+        template <typename Fn>
+        void run(size_t count, Fn &fn)
+        {
+            if (count >= kParallelMinRays && threads.empty())
+                start();
+            if (count < kParallelMinRays || threads.empty())
+            {
+                for (size_t i = 0; i < count; ++i)
+                    fn(i);
+                return;
+            }
+
+            size_t slice = (count + threads.size()) / (threads.size() + 1);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                task = &invoke<Fn>;
+                context = &fn;
+                total = count;
+                chunk = slice;
+                pending = threads.size();
+                generation++;
+            }
+            wake.notify_all();
+
+            invoke<Fn>(&fn, 0, slice);
+
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this]()
+                      { return pending == 0; });
+        }
+
+    private:
+        template <typename Fn>
+        static void invoke(void *fn, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                (*static_cast<Fn *>(fn))(i);
+        }
+
+        void start()
+        {
+            unsigned cores = std::thread::hardware_concurrency();
+            for (unsigned w = 1; w < cores; ++w)
+                threads.emplace_back(&RayWorkers::loop, this, (size_t)w);
+        }
+
+        void loop(size_t index)
+        {
+            uint64_t seen = 0;
+            std::unique_lock<std::mutex> lock(mutex);
+            for (;;)
+            {
+                wake.wait(lock, [&]()
+                          { return stopping || generation != seen; });
+                if (stopping)
+                    return;
+                seen = generation;
+
+                size_t begin = std::min(total, index * chunk);
+                size_t end = std::min(total, begin + chunk);
+                void (*fn)(void *, size_t, size_t) = task;
+                void *ctx = context;
+
+                lock.unlock();
+                fn(ctx, begin, end);
+                lock.lock();
+
+                if (--pending == 0)
+                    done.notify_one();
+            }
+        }
+
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        void (*task)(void *, size_t, size_t) = nullptr;
+        void *context = nullptr;
+        size_t total = 0;
+        size_t chunk = 0;
+        size_t pending = 0;
+        uint64_t generation = 0;
+        bool stopping = false;
+    };
+
+    // O GC pode apanhar a RayQuery depois de o SceneManager morrer (ReleaseEngine
+    // apaga o Root): o listener larga a query quando a cena é destruída.
+    struct RayQuery : public Ogre::SceneManager::Listener
+    {
+        Ogre::SceneManager *scene;
+        Ogre::RaySceneQuery *query;
+        bool exact;
+        std::vector<Ogre::MovableObject *> hitObjects; // do último cast
+        RayWorkers workers;
+
+        void sceneManagerDestroyed(Ogre::SceneManager *source) override
+        {
+            source->destroyQuery(query);
+            query = nullptr;
+            scene = nullptr;
+            hitObjects.clear();
+        }
+    };
+
+    static bool sceneAlive(RayQuery *rq, const char *name)
+    {
+        if (rq->scene)
+            return true;
+        Error("%s: scene was destroyed", name);
+        return false;
+    }
+
+    struct RayCandidate
+    {
+        float boxDistance;
+        Ogre::MovableObject *object;
+        const MeshBVH *bvh; // nullptr = vale o hit da caixa
+        Ogre::Affine3 worldToLocal;
+    };
+
+    // Pelo handle do mesh: não é reutilizado como o ponteiro
+    static std::unordered_map<Ogre::ResourceHandle, std::unique_ptr<MeshBVH>> bvhCache;
+
+    static void appendPositions(const Ogre::VertexData *vertexData, std::vector<float> &positions)
+    {
+        const Ogre::VertexElement *elem = vertexData->vertexDeclaration->findElementBySemantic(Ogre::VES_POSITION);
+        if (!elem || elem->getType() != Ogre::VET_FLOAT3)
+            return;
+
+        Ogre::HardwareVertexBufferSharedPtr vbuf = vertexData->vertexBufferBinding->getBuffer(elem->getSource());
+        size_t vertexSize = vbuf->getVertexSize();
+
+        Ogre::HardwareBufferLockGuard lock(vbuf, Ogre::HardwareBuffer::HBL_READ_ONLY);
+        const uint8_t *vertex = static_cast<const uint8_t *>(lock.pData) + vertexData->vertexStart * vertexSize;
+
+        for (size_t i = 0; i < vertexData->vertexCount; ++i, vertex += vertexSize)
+        {
+            const float *p = reinterpret_cast<const float *>(vertex + elem->getOffset());
+            positions.insert(positions.end(), p, p + 3);
+        }
+    }
+
+    static const MeshBVH *getMeshBVH(const Ogre::MeshPtr &mesh)
+    {
+        auto it = bvhCache.find(mesh->getHandle());
+        if (it != bvhCache.end())
+            return it->second.get();
+
+        std::vector<float> positions;
+        std::vector<uint32_t> indices;
+
+        if (mesh->sharedVertexData)
+            appendPositions(mesh->sharedVertexData, positions);
+
+        for (unsigned short s = 0; s < mesh->getNumSubMeshes(); ++s)
+        {
+            Ogre::SubMesh *sub = mesh->getSubMesh(s);
+            if (sub->operationType != Ogre::RenderOperation::OT_TRIANGLE_LIST || !sub->indexData->indexCount)
+                continue;
+            if (sub->useSharedVertices && !mesh->sharedVertexData)
+                continue;
+
+            uint32_t base = 0;
+            if (!sub->useSharedVertices)
+            {
+                base = (uint32_t)(positions.size() / 3);
+                appendPositions(sub->vertexData, positions);
+            }
+
+            Ogre::IndexData *indexData = sub->indexData;
+            Ogre::HardwareIndexBufferSharedPtr ibuf = indexData->indexBuffer;
+            Ogre::HardwareBufferLockGuard lock(ibuf, Ogre::HardwareBuffer::HBL_READ_ONLY);
+
+            if (ibuf->getType() == Ogre::HardwareIndexBuffer::IT_32BIT)
+            {
+                const uint32_t *src = static_cast<const uint32_t *>(lock.pData) + indexData->indexStart;
+                for (size_t i = 0; i < indexData->indexCount; ++i)
+                    indices.push_back(base + src[i]);
+            }
+            else
+            {
+                const uint16_t *src = static_cast<const uint16_t *>(lock.pData) + indexData->indexStart;
+                for (size_t i = 0; i < indexData->indexCount; ++i)
+                    indices.push_back(base + src[i]);
+            }
+        }
+
+        // Índices fora das posições lidas (ex.: posição não float3) são ignorados pela BVH
+        std::unique_ptr<MeshBVH> bvh(new MeshBVH());
+        bvh->build(positions.data(), positions.size() / 3, indices.data(), indices.size());
+
+        const MeshBVH *result = bvh.get();
+        bvhCache[mesh->getHandle()] = std::move(bvh);
+        return result;
+    }
+
+    // Constructor: RayQuery(scene)
+    void *rayquery_ctor(Interpreter *vm, int argCount, Value *args)
+    {
+        if (argCount < 1 || !args[0].isNativeClassInstance())
+        {
+            Error("RayQuery: requires scene argument");
+            return nullptr;
+        }
+
+        Ogre::SceneManager *scene = static_cast<Ogre::SceneManager *>(args[0].asNativeClassInstance()->userData);
+        if (!scene)
+        {
+            Error("RayQuery: invalid scene");
+            return nullptr;
+        }
+
+        RayQuery *rq = new RayQuery();
+        rq->scene = scene;
+        rq->query = scene->createRayQuery(Ogre::Ray());
+        rq->query->setSortByDistance(true);
+        rq->exact = false;
+        scene->addListener(rq);
+        return rq;
+    }
+
+    void rayquery_dtor(Interpreter *vm, void *data)
+    {
+        RayQuery *rq = static_cast<RayQuery *>(data);
+        if (rq->scene)
+        {
+            rq->scene->removeListener(rq);
+            rq->scene->destroyQuery(rq->query);
+        }
+        delete rq;
+    }
+
+    // cast(rays, hits, [maxDistance]) -> número de hits
+    int rayquery_cast(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        RayQuery *rq = static_cast<RayQuery *>(data);
+
+        if (argCount < 2 || !args[0].isBuffer() || !args[1].isBuffer() ||
+            args[0].asBuffer()->type != BufferType::FLOAT || args[1].asBuffer()->type != BufferType::FLOAT)
+        {
+            Error("cast: requires rays and hits float buffers");
+            vm->pushInt(0);
+            return 1;
+        }
+        if (!sceneAlive(rq, "cast"))
+        {
+            vm->pushInt(0);
+            return 1;
+        }
+
+        BufferInstance *rayBuf = args[0].asBuffer();
+        BufferInstance *hitBuf = args[1].asBuffer();
+        size_t count = (size_t)rayBuf->count / 6;
+        if ((size_t)hitBuf->count < count * 4)
+        {
+            Error("cast: hits buffer needs %d floats (4 per ray)", (int)(count * 4));
+            vm->pushInt(0);
+            return 1;
+        }
+
+        float maxDistance = argCount >= 3 ? (float)args[2].asNumber() : FLT_MAX;
+        const float *rays = (const float *)rayBuf->data;
+        float *hits = (float *)hitBuf->data;
+
+        // 1. Broad phase no Ogre (caixas), sequencial: a query não é thread-safe
+        std::vector<RayCandidate> candidates;
+        std::vector<size_t> firstCandidate(count + 1);
+
+        for (size_t r = 0; r < count; ++r)
+        {
+            firstCandidate[r] = candidates.size();
+
+            const float *src = rays + r * 6;
+            Ogre::Vector3 direction(src[3], src[4], src[5]);
+            if (direction.normalise() == 0.0f)
+                continue;
+            rq->query->setRay(Ogre::Ray(Ogre::Vector3(src[0], src[1], src[2]), direction));
+
+            Ogre::RaySceneQueryResult &result = rq->query->execute();
+            for (const Ogre::RaySceneQueryResultEntry &entry : result)
+            {
+                if (!entry.movable || entry.distance > maxDistance)
+                    continue;
+
+                RayCandidate candidate;
+                candidate.boxDistance = entry.distance;
+                candidate.object = entry.movable;
+                candidate.bvh = nullptr;
+
+                if (rq->exact && entry.movable->getMovableType() == Ogre::EntityFactory::FACTORY_TYPE_NAME &&
+                    entry.movable->getParentNode())
+                {
+                    Ogre::Entity *entity = static_cast<Ogre::Entity *>(entry.movable);
+                    candidate.bvh = getMeshBVH(entity->getMesh());
+                    candidate.worldToLocal = entity->getParentNode()->_getFullTransform().inverse();
+                }
+
+                candidates.push_back(candidate);
+                if (!rq->exact)
+                    break; // ordenado: o primeiro basta
+            }
+        }
+        firstCandidate[count] = candidates.size();
+
+        // 2. Narrow phase por raio, em paralelo; só lê candidates e as BVHs
+        rq->hitObjects.assign(count, nullptr);
+
+        auto narrowPhase = [&](size_t r)
+        {
+            const float *src = rays + r * 6;
+            float *dst = hits + r * 4;
+
+            Ogre::Vector3 origin(src[0], src[1], src[2]);
+            Ogre::Vector3 direction(src[3], src[4], src[5]);
+            direction.normalise();
+
+            float best = maxDistance;
+            Ogre::MovableObject *hitObject = nullptr;
+
+            for (size_t c = firstCandidate[r]; c < firstCandidate[r + 1]; ++c)
+            {
+                const RayCandidate &candidate = candidates[c];
+                if (candidate.boxDistance >= best)
+                    break; // caixas ordenadas: nada mais perto
+
+                if (!candidate.bvh)
+                {
+                    best = candidate.boxDistance;
+                    hitObject = candidate.object;
+                    continue;
+                }
+
+                // Afim: o t no espaço local é o mesmo do raio no mundo
+                Ogre::Vector3 localOrigin = candidate.worldToLocal * origin;
+                Ogre::Vector3 localDir = candidate.worldToLocal.linear() * direction;
+                float o[3] = {localOrigin.x, localOrigin.y, localOrigin.z};
+                float d[3] = {localDir.x, localDir.y, localDir.z};
+
+                BVHHit hit;
+                if (candidate.bvh->intersect(o, d, best, &hit))
+                {
+                    best = hit.distance;
+                    hitObject = candidate.object;
+                }
+            }
+
+            rq->hitObjects[r] = hitObject;
+            if (hitObject)
+            {
+                Ogre::Vector3 point = origin + direction * best;
+                dst[0] = best;
+                dst[1] = point.x;
+                dst[2] = point.y;
+                dst[3] = point.z;
+            }
+            else
+            {
+                dst[0] = -1.0f;
+                dst[1] = dst[2] = dst[3] = 0.0f;
+            }
+        };
+        rq->workers.run(count, narrowPhase);
+
+        int hitCount = 0;
+        for (Ogre::MovableObject *obj : rq->hitObjects)
+        {
+            if (obj)
+                hitCount++;
+        }
+
+        vm->pushInt(hitCount);
+        return 1;
+    }
+
+    // getHitName(index) -> nome do objeto atingido pelo raio index no último cast, ou nil
+    int rayquery_getHitName(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        RayQuery *rq = static_cast<RayQuery *>(data);
+        if (argCount < 1)
+        {
+            vm->pushNil();
+            return 1;
+        }
+
+        int index = (int)args[0].asNumber();
+        if (index < 0 || index >= (int)rq->hitObjects.size() || !rq->hitObjects[index])
+        {
+            vm->pushNil();
+            return 1;
+        }
+
+        vm->pushString(rq->hitObjects[index]->getName().c_str());
+        return 1;
+    }
+
+    // Property: exact
+    Value rayquery_getExact(Interpreter *vm, void *data)
+    {
+        return vm->makeBool(static_cast<RayQuery *>(data)->exact);
+    }
+
+    void rayquery_setExact(Interpreter *vm, void *data, Value value)
+    {
+        static_cast<RayQuery *>(data)->exact = value.asBool();
+    }
+
+    // Property: queryMask
+    Value rayquery_getQueryMask(Interpreter *vm, void *data)
+    {
+        RayQuery *rq = static_cast<RayQuery *>(data);
+        if (!sceneAlive(rq, "queryMask"))
+            return vm->makeInt(0);
+        return vm->makeInt((int)rq->query->getQueryMask());
+    }
+
+    void rayquery_setQueryMask(Interpreter *vm, void *data, Value value)
+    {
+        RayQuery *rq = static_cast<RayQuery *>(data);
+        if (sceneAlive(rq, "queryMask"))
+            rq->query->setQueryMask((Ogre::uint32)value.asNumber());
+    }
+
+    // clearRayMeshCache() - BVHs são refeitas no próximo cast (ex.: mesh recarregado)
+    int native_clearRayMeshCache(Interpreter *vm, int argCount, Value *args)
+    {
+        bvhCache.clear();
+        return 0;
+    }
+
     void registerAll(Interpreter &vm)
     {
         // Global functions for raycasting
@@ -260,6 +725,21 @@ namespace OgreRaycastBindings
         // vm.registerNative("raycastFromMouse", raycastFromMouse, 6);
         // vm.registerNative("raycastAll", raycastAll, 8);
 
+        NativeClassDef *rq = vm.registerNativeClass(
+            "RayQuery",
+            rayquery_ctor,
+            rayquery_dtor,
+            1,
+            false);
+
+        vm.addNativeProperty(rq, "exact", rayquery_getExact, rayquery_setExact);
+        vm.addNativeProperty(rq, "queryMask", rayquery_getQueryMask, rayquery_setQueryMask);
+
+        vm.addNativeMethod(rq, "cast", rayquery_cast);
+        vm.addNativeMethod(rq, "getHitName", rayquery_getHitName);
+
+        vm.registerNative("clearRayMeshCache", native_clearRayMeshCache, 0);
+
         // Info("Raycasting bindings registered");
     }
 
@@ -1107,6 +1107,288 @@ namespace OgreSceneBindings
         return 1;
     }
 
+    // ========== PRIMITIVAS COM MESH PARTILHADO ==========
+    // createXEntity(name, ...mesmos args de createX) -> Entity
+    // A geometria vem do cache do ProceduralMesh; name = nil gera um nome.
+
+    static const char *optGroup(int argCount, Value *args, int index)
+    {
+        if (argCount > index && args[index].isString())
+        {
+            return args[index].asStringChars();
+        }
+        return NULL;
+    }
+
+    static int pushMeshEntity(Interpreter *vm, Ogre::SceneManager *scene, Value nameArg, const Ogre::MeshPtr &mesh)
+    {
+        Ogre::Entity *entity = nameArg.isString()
+                                   ? scene->createEntity(nameArg.asStringChars(), mesh)
+                                   : scene->createEntity(mesh);
+
+        NativeClassDef *entityClass = nullptr;
+        if (!vm->tryGetNativeClassDef("Entity", &entityClass))
+        {
+            Error("Entity class not found in VM");
+            vm->pushNil();
+            return 1;
+        }
+
+        Value entityValue = vm->makeNativeClassInstance(false);
+        NativeClassInstance *instance = entityValue.asNativeClassInstance();
+        instance->klass = entityClass;
+        instance->userData = (void *)entity;
+
+        vm->push(entityValue);
+        return 1;
+    }
+
+    int scene_createCubeEntity(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 3)
+        {
+            Error("createCubeEntity: requires name, size, material [group]");
+            vm->pushNil();
+            return 1;
+        }
+
+        try
+        {
+            Ogre::SceneManager *scene = static_cast<Ogre::SceneManager *>(data);
+            Ogre::MeshPtr mesh = ProceduralMesh::cubeMesh(args[2].asStringChars(),
+                                                          (float)args[1].asNumber(),
+                                                          optGroup(argCount, args, 3));
+            return pushMeshEntity(vm, scene, args[0], mesh);
+        }
+        catch (const std::exception &e)
+        {
+            Error("createCubeEntity exception: %s", e.what());
+            vm->pushNil();
+        }
+
+        return 1;
+    }
+
+    int scene_createSphereEntity(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 5)
+        {
+            Error("createSphereEntity: requires name, radius, rings, segments, material [group]");
+            vm->pushNil();
+            return 1;
+        }
+
+        try
+        {
+            Ogre::SceneManager *scene = static_cast<Ogre::SceneManager *>(data);
+            Ogre::MeshPtr mesh = ProceduralMesh::sphereMesh(args[4].asStringChars(),
+                                                            (float)args[1].asNumber(),
+                                                            (int)args[2].asNumber(),
+                                                            (int)args[3].asNumber(),
+                                                            optGroup(argCount, args, 5));
+            return pushMeshEntity(vm, scene, args[0], mesh);
+        }
+        catch (const std::exception &e)
+        {
+            Error("createSphereEntity exception: %s", e.what());
+            vm->pushNil();
+        }
+
+        return 1;
+    }
+
+    int scene_createCylinderEntity(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 5)
+        {
+            Error("createCylinderEntity: requires name, radius, height, segments, material [group]");
+            vm->pushNil();
+            return 1;
+        }
+
+        try
+        {
+            Ogre::SceneManager *scene = static_cast<Ogre::SceneManager *>(data);
+            Ogre::MeshPtr mesh = ProceduralMesh::cylinderMesh(args[4].asStringChars(),
+                                                              (float)args[1].asNumber(),
+                                                              (float)args[2].asNumber(),
+                                                              (int)args[3].asNumber(),
+                                                              optGroup(argCount, args, 5));
+            return pushMeshEntity(vm, scene, args[0], mesh);
+        }
+        catch (const std::exception &e)
+        {
+            Error("createCylinderEntity exception: %s", e.what());
+            vm->pushNil();
+        }
+
+        return 1;
+    }
+
+    int scene_createConeEntity(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 5)
+        {
+            Error("createConeEntity: requires name, radius, height, segments, material [group]");
+            vm->pushNil();
+            return 1;
+        }
+
+        try
+        {
+            Ogre::SceneManager *scene = static_cast<Ogre::SceneManager *>(data);
+            Ogre::MeshPtr mesh = ProceduralMesh::coneMesh(args[4].asStringChars(),
+                                                          (float)args[1].asNumber(),
+                                                          (float)args[2].asNumber(),
+                                                          (int)args[3].asNumber(),
+                                                          optGroup(argCount, args, 5));
+            return pushMeshEntity(vm, scene, args[0], mesh);
+        }
+        catch (const std::exception &e)
+        {
+            Error("createConeEntity exception: %s", e.what());
+            vm->pushNil();
+        }
+
+        return 1;
+    }
+
+    int scene_createTorusEntity(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 6)
+        {
+            Error("createTorusEntity: requires name, majorRadius, minorRadius, majorSegments, minorSegments, material [group]");
+            vm->pushNil();
+            return 1;
+        }
+
+        try
+        {
+            Ogre::SceneManager *scene = static_cast<Ogre::SceneManager *>(data);
+            Ogre::MeshPtr mesh = ProceduralMesh::torusMesh(args[5].asStringChars(),
+                                                           (float)args[1].asNumber(),
+                                                           (float)args[2].asNumber(),
+                                                           (int)args[3].asNumber(),
+                                                           (int)args[4].asNumber(),
+                                                           optGroup(argCount, args, 6));
+            return pushMeshEntity(vm, scene, args[0], mesh);
+        }
+        catch (const std::exception &e)
+        {
+            Error("createTorusEntity exception: %s", e.what());
+            vm->pushNil();
+        }
+
+        return 1;
+    }
+
+    int scene_createQuadEntity(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 4)
+        {
+            Error("createQuadEntity: requires name, width, height, material [group]");
+            vm->pushNil();
+            return 1;
+        }
+
+        try
+        {
+            Ogre::SceneManager *scene = static_cast<Ogre::SceneManager *>(data);
+            Ogre::MeshPtr mesh = ProceduralMesh::quadMesh(args[3].asStringChars(),
+                                                          (float)args[1].asNumber(),
+                                                          (float)args[2].asNumber(),
+                                                          optGroup(argCount, args, 4));
+            return pushMeshEntity(vm, scene, args[0], mesh);
+        }
+        catch (const std::exception &e)
+        {
+            Error("createQuadEntity exception: %s", e.what());
+            vm->pushNil();
+        }
+
+        return 1;
+    }
+
+    int scene_createPlaneEntity(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 6)
+        {
+            Error("createPlaneEntity: requires name, width, depth, widthSegments, depthSegments, material [group]");
+            vm->pushNil();
+            return 1;
+        }
+
+        try
+        {
+            Ogre::SceneManager *scene = static_cast<Ogre::SceneManager *>(data);
+            Ogre::MeshPtr mesh = ProceduralMesh::planeMesh(args[5].asStringChars(),
+                                                           (float)args[1].asNumber(),
+                                                           (float)args[2].asNumber(),
+                                                           (int)args[3].asNumber(),
+                                                           (int)args[4].asNumber(),
+                                                           optGroup(argCount, args, 6));
+            return pushMeshEntity(vm, scene, args[0], mesh);
+        }
+        catch (const std::exception &e)
+        {
+            Error("createPlaneEntity exception: %s", e.what());
+            vm->pushNil();
+        }
+
+        return 1;
+    }
+
+    int scene_createCapsuleEntity(Interpreter *vm, void *data, int argCount, Value *args)
+    {
+        if (argCount < 6)
+        {
+            Error("createCapsuleEntity: requires name, radius, height, segments, rings, material [group]");
+            vm->pushNil();
+            return 1;
+        }
+
+        try
+        {
+            Ogre::SceneManager *scene = static_cast<Ogre::SceneManager *>(data);
+            Ogre::MeshPtr mesh = ProceduralMesh::capsuleMesh(args[5].asStringChars(),
+                                                             (float)args[1].asNumber(),
+                                                             (float)args[2].asNumber(),
+                                                             (int)args[3].asNumber(),
+                                                             (int)args[4].asNumber(),
+                                                             optGroup(argCount, args, 6));
+            return pushMeshEntity(vm, scene, args[0], mesh);
+        }
+        catch (const std::exception &e)
+        {
+            Error("createCapsuleEntity exception: %s", e.what());
+            vm->pushNil();
+        }
+
+        return 1;
+    }
+
+    // meshCacheStats() -> {meshes, hits, misses}
+    int native_meshCacheStats(Interpreter *vm, int argCount, Value *args)
+    {
+        ProceduralMesh::MeshCacheStats stats = ProceduralMesh::getMeshCacheStats();
+
+        Value result = vm->makeMap();
+        MapInstance *map = result.asMap();
+        map->table.set(vm->makeString("meshes"), vm->makeInt(stats.meshes));
+        map->table.set(vm->makeString("hits"), vm->makeInt(stats.hits));
+        map->table.set(vm->makeString("misses"), vm->makeInt(stats.misses));
+
+        vm->push(result);
+        return 1;
+    }
+
+    // clearMeshCache() - só afeta primitivas criadas depois
+    int native_clearMeshCache(Interpreter *vm, int argCount, Value *args)
+    {
+        ProceduralMesh::clearMeshCache();
+        return 0;
+    }
+
     // createParticleSystem(scene, "name", "templateName") - função global
     int createParticleSystem(Interpreter *vm, void *data, int argCount, Value *args)
     {
@@ -1405,6 +1687,14 @@ namespace OgreSceneBindings
         vm.addNativeMethod(sc, "createQuad", scene_createQuad);
         vm.addNativeMethod(sc, "createPlane", scene_createPlane);
         vm.addNativeMethod(sc, "createCapsule", scene_createCapsule);
+        vm.addNativeMethod(sc, "createCubeEntity", scene_createCubeEntity);
+        vm.addNativeMethod(sc, "createSphereEntity", scene_createSphereEntity);
+        vm.addNativeMethod(sc, "createCylinderEntity", scene_createCylinderEntity);
+        vm.addNativeMethod(sc, "createConeEntity", scene_createConeEntity);
+        vm.addNativeMethod(sc, "createTorusEntity", scene_createTorusEntity);
+        vm.addNativeMethod(sc, "createQuadEntity", scene_createQuadEntity);
+        vm.addNativeMethod(sc, "createPlaneEntity", scene_createPlaneEntity);
+        vm.addNativeMethod(sc, "createCapsuleEntity", scene_createCapsuleEntity);
         vm.addNativeMethod(sc, "createRibbonTrail", createRibbonTrail);
         vm.addNativeMethod(sc, "createParticleSystem", createParticleSystem);
         vm.addNativeMethod(sc, "createBillboardSet", createBillboardSet);
@@ -1433,6 +1723,8 @@ namespace OgreSceneBindings
         vm.addNativeMethod(sc, "disableFog", scene_disableFog);
 
         vm.registerNative("CreateScene", native_create_scene, 0);
+        vm.registerNative("meshCacheStats", native_meshCacheStats, 0);
+        vm.registerNative("clearMeshCache", native_clearMeshCache, 0);
 
         //  Info("Scene bindings registered");
     }
@@ -11,17 +11,31 @@ namespace TimerBindings
     static int gFrameCount = 0;
     static double gFPS = 0.0;
     static double gFPSUpdateTime = 0.0;
+    static double gFixedDelta = 0.0; // > 0: passo fixo (headless), ignora o relógio
+
+    void setFixedDelta(double seconds)
+    {
+        gFixedDelta = seconds > 0.0 ? seconds : 0.0;
+    }
 
     // Call this once per frame (from main loop)
     void updateTimer()
     {
         auto currentTime = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> deltaSeconds = currentTime - gLastFrameTime;
-        gDeltaTime = deltaSeconds.count();
-        
-        std::chrono::duration<double> elapsedSeconds = currentTime - gStartTime;
-        gElapsedTime = elapsedSeconds.count();
-        
+        if (gFixedDelta > 0.0)
+        {
+            gDeltaTime = gFixedDelta;
+            gElapsedTime += gFixedDelta;
+        }
+        else
+        {
+            std::chrono::duration<double> deltaSeconds = currentTime - gLastFrameTime;
+            gDeltaTime = deltaSeconds.count();
+
+            std::chrono::duration<double> elapsedSeconds = currentTime - gStartTime;
+            gElapsedTime = elapsedSeconds.count();
+        }
+
         gLastFrameTime = currentTime;
         gFrameCount++;
         gFPSUpdateTime += gDeltaTime;